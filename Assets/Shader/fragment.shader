@@ -6,7 +6,9 @@
 #include "shaders.inc"
 
 // Declaring the uniforms
-uniform float3 g_RGB;
+BeginMaterialConstants
+	MaterialConstant float3 g_RGB;
+EndMaterialConstants
 uniform sampler2D g_sampler;
 
 #if defined( EAE6320_PLATFORM_D3D )
@@ -6,8 +6,10 @@
 #include "shaders.inc"
 
 // Declaring the uniforms
-uniform float3 g_RGB;
-uniform float g_Alpha;
+BeginMaterialConstants
+	MaterialConstant float3 g_RGB;
+	MaterialConstant float g_Alpha;
+EndMaterialConstants
 uniform sampler2D g_sampler;
 
 #if defined( EAE6320_PLATFORM_D3D )
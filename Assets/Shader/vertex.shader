@@ -3,11 +3,11 @@
 */
 #include "shaders.inc"
 
-uniform float4x4 g_transform_localToWorld;
-uniform float4x4 g_transform_worldToView;
-uniform float4x4 g_transform_viewToScreen;
+// localToWorld, worldToView and viewToScreen are concatenated once per object on the CPU
+// (a shader can instead declare g_transform_localToWorld and use it with the per-frame transforms from shaders.inc)
 
 #if defined( EAE6320_PLATFORM_D3D )
+uniform float4x4 g_transform_localToProjected;
 #define O_POSITION_SCREEN o_position
 // Entry Point
 //============
@@ -21,6 +21,8 @@ void main(
 	// but must match the C call to CreateVertexDeclaration()
 
 	// These values come from one of the sVertex that we filled the vertex buffer with in C code
+	// (or an sVertex_quantized, whose normalized integers arrive here as [0,1] floats;
+	// g_transform_localToProjected then expands the position back into local space)
 	in const float3 i_position_local : POSITION,
 	in const float2 i_texcoords : TEXCOORD0,
 	in const float4 i_color : COLOR,
@@ -54,9 +56,17 @@ void main(
 // but must match the C calls to glVertexAttribPointer()
 
 // These values come from one of the sVertex that we filled the vertex buffer with in C code
+// (or an sVertex_quantized, whose normalized integers arrive here as [0,1] floats;
+// g_transform_localToProjected then expands the position back into local space.
+// A mesh without colors leaves i_color disabled and it reads as opaque white)
 layout( location = 0 ) in vec3 i_position_local;
 layout( location = 1 ) in vec4 i_color;
 layout( location = 2 ) in vec2 i_texcoords;
+// This is the instanced variant:
+// the transform is a per-instance attribute instead of a uniform,
+// so every object that shares this mesh and material can be drawn with one draw call
+layout( location = 3 ) in mat4 i_transform_localToProjected;
+#define g_transform_localToProjected i_transform_localToProjected
 
 // Output
 //=======
@@ -99,9 +109,7 @@ void main()
 	    // Any matrix transformations that include translation
 	    // will operate on a float4 position,
 	    // which _must_ have 1 for the w value
-	    float4 position_world = Transform( float4( i_position_local, 1.0 ), g_transform_localToWorld );
-	    float4 position_view = Transform( position_world, g_transform_worldToView );
-	    O_POSITION_SCREEN = Transform( position_view, g_transform_viewToScreen );
+	    O_POSITION_SCREEN = Transform( float4( i_position_local, 1.0 ), g_transform_localToProjected );
 	}
 	// Pass the input color to the fragment shader unchanged:
 	{
@@ -3,15 +3,167 @@
 
 #include "Functions.h"
 
+#include <cmath>
+#include "Simd.h"
+
 // Static Data Initialization
 //===========================
 
-const float eae6320::Math::Pi = 3.141592654f;
+namespace
+{
+	// Pi/4 is split into three parts so that j * Pi/4 can be subtracted from an angle without losing precision
+	// (the first two parts have few enough significant bits that multiplying them by j is exact)
+	const float s_piOverFour_part1 = 0.78515625f;
+	const float s_piOverFour_part2 = 2.4187564849853515625e-4f;
+	const float s_piOverFour_part3 = 3.77489497744594108e-8f;
+	const float s_fourOverPi = 1.27323954473516f;
+
+	// Minimax polynomial coefficients for [-Pi/4, Pi/4]
+	const float s_sin_c1 = -1.6666654611e-1f;
+	const float s_sin_c2 = 8.3321608736e-3f;
+	const float s_sin_c3 = -1.9515295891e-4f;
+	const float s_cos_c1 = 4.166664568298827e-2f;
+	const float s_cos_c2 = -1.388731625493765e-3f;
+	const float s_cos_c3 = 2.443315711809948e-5f;
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	void SinCos_single( const float i_angleInRadians, float& o_sine, float& o_cosine );
+}
 
 // Interface
 //==========
 
-float eae6320::Math::ConvertDegreesToRadians( const float i_degrees )
+// Batch Operations
+//-----------------
+
+void eae6320::Math::SinCos( const float* const i_anglesInRadians, const size_t i_count, float* const o_sines, float* const o_cosines )
+{
+	size_t i = 0;
+#if defined( EAE6320_MATH_SIMD_SSE )
+	{
+		const __m128 signMask = _mm_castsi128_ps( _mm_set1_epi32( 0x80000000 ) );
+		const __m128 fourOverPi = _mm_set1_ps( s_fourOverPi );
+		const __m128 piOverFour_part1 = _mm_set1_ps( s_piOverFour_part1 );
+		const __m128 piOverFour_part2 = _mm_set1_ps( s_piOverFour_part2 );
+		const __m128 piOverFour_part3 = _mm_set1_ps( s_piOverFour_part3 );
+		const __m128 sin_c1 = _mm_set1_ps( s_sin_c1 );
+		const __m128 sin_c2 = _mm_set1_ps( s_sin_c2 );
+		const __m128 sin_c3 = _mm_set1_ps( s_sin_c3 );
+		const __m128 cos_c1 = _mm_set1_ps( s_cos_c1 );
+		const __m128 cos_c2 = _mm_set1_ps( s_cos_c2 );
+		const __m128 cos_c3 = _mm_set1_ps( s_cos_c3 );
+		const __m128 half = _mm_set1_ps( 0.5f );
+		const __m128 one = _mm_set1_ps( 1.0f );
+		const __m128i one_i = _mm_set1_epi32( 1 );
+		const __m128i two_i = _mm_set1_epi32( 2 );
+		const __m128i four_i = _mm_set1_epi32( 4 );
+		for ( ; ( i + 4 ) <= i_count; i += 4 )
+		{
+			const __m128 angle = _mm_loadu_ps( i_anglesInRadians + i );
+			const __m128 angleSign = _mm_and_ps( angle, signMask );
+			__m128 x = _mm_andnot_ps( signMask, angle );
+
+			// Find the octant, rounding up to an even number so that the remainder is centered on zero
+			__m128i octant = _mm_cvttps_epi32( _mm_mul_ps( x, fourOverPi ) );
+			octant = _mm_add_epi32( octant, one_i );
+			octant = _mm_andnot_si128( one_i, octant );
+			const __m128 octant_f = _mm_cvtepi32_ps( octant );
+			x = _mm_sub_ps( x, _mm_mul_ps( octant_f, piOverFour_part1 ) );
+			x = _mm_sub_ps( x, _mm_mul_ps( octant_f, piOverFour_part2 ) );
+			x = _mm_sub_ps( x, _mm_mul_ps( octant_f, piOverFour_part3 ) );
+
+			// Octants 2, 3, 6, and 7 swap the polynomials,
+			// sine is negated in octants 4-7 (and by the sign of the original angle),
+			// and cosine is negated in octants 2-5
+			const __m128 swapMask = _mm_castsi128_ps( _mm_cmpeq_epi32( _mm_and_si128( octant, two_i ), two_i ) );
+			const __m128 sineSign = _mm_xor_ps( angleSign, _mm_castsi128_ps( _mm_slli_epi32( _mm_and_si128( octant, four_i ), 29 ) ) );
+			const __m128 cosineSign = _mm_castsi128_ps( _mm_slli_epi32( _mm_andnot_si128( _mm_sub_epi32( octant, two_i ), four_i ), 29 ) );
+
+			const __m128 z = _mm_mul_ps( x, x );
+			__m128 polynomial_cos = _mm_add_ps( _mm_mul_ps( cos_c3, z ), cos_c2 );
+			polynomial_cos = _mm_add_ps( _mm_mul_ps( polynomial_cos, z ), cos_c1 );
+			polynomial_cos = _mm_mul_ps( _mm_mul_ps( polynomial_cos, z ), z );
+			polynomial_cos = _mm_add_ps( _mm_sub_ps( polynomial_cos, _mm_mul_ps( z, half ) ), one );
+			__m128 polynomial_sin = _mm_add_ps( _mm_mul_ps( sin_c3, z ), sin_c2 );
+			polynomial_sin = _mm_add_ps( _mm_mul_ps( polynomial_sin, z ), sin_c1 );
+			polynomial_sin = _mm_add_ps( _mm_mul_ps( _mm_mul_ps( polynomial_sin, z ), x ), x );
+
+			const __m128 sine = _mm_or_ps( _mm_and_ps( swapMask, polynomial_cos ), _mm_andnot_ps( swapMask, polynomial_sin ) );
+			const __m128 cosine = _mm_or_ps( _mm_and_ps( swapMask, polynomial_sin ), _mm_andnot_ps( swapMask, polynomial_cos ) );
+			_mm_storeu_ps( o_sines + i, _mm_xor_ps( sine, sineSign ) );
+			_mm_storeu_ps( o_cosines + i, _mm_xor_ps( cosine, cosineSign ) );
+		}
+	}
+#endif
+	for ( ; i < i_count; ++i )
+	{
+		SinCos_single( i_anglesInRadians[i], o_sines[i], o_cosines[i] );
+	}
+}
+
+void eae6320::Math::ReciprocalSquareRoot( const float* const i_values, const size_t i_count, float* const o_results )
 {
-	return i_degrees * Pi / 180.0f;
+	size_t i = 0;
+#if defined( EAE6320_MATH_SIMD_SSE )
+	{
+		const __m128 half = _mm_set1_ps( 0.5f );
+		const __m128 threeHalves = _mm_set1_ps( 1.5f );
+		for ( ; ( i + 4 ) <= i_count; i += 4 )
+		{
+			const __m128 value = _mm_loadu_ps( i_values + i );
+			// The hardware estimate only has 12 bits of precision,
+			// and a single Newton-Raphson step brings that up to nearly full float precision
+			const __m128 estimate = _mm_rsqrt_ps( value );
+			const __m128 estimate_squared = _mm_mul_ps( estimate, estimate );
+			_mm_storeu_ps( o_results + i,
+				_mm_mul_ps( estimate, _mm_sub_ps( threeHalves, _mm_mul_ps( _mm_mul_ps( half, value ), estimate_squared ) ) ) );
+		}
+		// The remaining values use the same estimate and refinement one at a time
+		for ( ; i < i_count; ++i )
+		{
+			const __m128 value = _mm_set_ss( i_values[i] );
+			const __m128 estimate = _mm_rsqrt_ss( value );
+			const __m128 estimate_squared = _mm_mul_ss( estimate, estimate );
+			o_results[i] = _mm_cvtss_f32(
+				_mm_mul_ss( estimate, _mm_sub_ss( threeHalves, _mm_mul_ss( _mm_mul_ss( half, value ), estimate_squared ) ) ) );
+		}
+	}
+#endif
+	for ( ; i < i_count; ++i )
+	{
+		o_results[i] = 1.0f / std::sqrt( i_values[i] );
+	}
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	void SinCos_single( const float i_angleInRadians, float& o_sine, float& o_cosine )
+	{
+		// This is the same calculation as the SSE version in eae6320::Math::SinCos()
+		float x = std::abs( i_angleInRadians );
+		int octant = static_cast<int>( x * s_fourOverPi );
+		octant = ( octant + 1 ) & ~1;
+		const float octant_f = static_cast<float>( octant );
+		x = ( ( x - ( octant_f * s_piOverFour_part1 ) ) - ( octant_f * s_piOverFour_part2 ) ) - ( octant_f * s_piOverFour_part3 );
+
+		const float z = x * x;
+		const float polynomial_cos = ( ( ( ( ( ( s_cos_c3 * z ) + s_cos_c2 ) * z ) + s_cos_c1 ) * z ) * z ) - ( z * 0.5f ) + 1.0f;
+		const float polynomial_sin = ( ( ( ( ( ( s_sin_c3 * z ) + s_sin_c2 ) * z ) + s_sin_c1 ) * z ) * x ) + x;
+
+		const bool shouldPolynomialsBeSwapped = ( octant & 2 ) != 0;
+		const bool shouldSineBeNegated = ( ( octant & 4 ) != 0 ) != std::signbit( i_angleInRadians );
+		const bool shouldCosineBeNegated = ( ( octant - 2 ) & 4 ) == 0;
+		const float sine = shouldPolynomialsBeSwapped ? polynomial_cos : polynomial_sin;
+		const float cosine = shouldPolynomialsBeSwapped ? polynomial_sin : polynomial_cos;
+		o_sine = shouldSineBeNegated ? -sine : sine;
+		o_cosine = shouldCosineBeNegated ? -cosine : cosine;
+	}
 }
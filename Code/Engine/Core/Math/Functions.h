@@ -5,6 +5,11 @@
 #ifndef EAE6320_MATH_FUNCTIONS_H
 #define EAE6320_MATH_FUNCTIONS_H
 
+// Header Files
+//=============
+
+#include <cstddef>
+
 namespace eae6320
 {
 	namespace Math
@@ -12,10 +17,32 @@ namespace eae6320
 		// Interface
 		//==========
 
-		extern const float Pi;
+		constexpr float Pi = 3.141592654f;
+
+		constexpr float ConvertDegreesToRadians( const float i_degrees );
 
-		float ConvertDegreesToRadians( const float i_degrees );
+		// Batch Operations
+		//-----------------
+
+		// These work on contiguous arrays, four elements at a time with SSE when it is available.
+		// The scalar fallback (used without SSE and for the last few elements of an array)
+		// evaluates the same approximations, so every element gets the same result regardless of its position.
+		// The outputs may alias the inputs.
+
+		// Calculates the sine and cosine of every angle
+		// (the angle is reduced to [-Pi/4, Pi/4] and then minimax polynomials are evaluated).
+		// Accuracy:
+		//	* For |angle| <= 8192 the absolute error is <= 1.0e-7
+		//	* Larger angles lose precision in the range reduction and shouldn't be passed in
+		void SinCos( const float* const i_anglesInRadians, const size_t i_count, float* const o_sines, float* const o_cosines );
+		// Calculates 1 / sqrt( value ) for every value, which must be positive and normalized (i.e. not denormal)
+		// Accuracy:
+		//	* With SSE the hardware estimate is refined by a Newton-Raphson step, and the relative error is <= 3.0e-7
+		//	* Without SSE the result is correctly rounded
+		void ReciprocalSquareRoot( const float* const i_values, const size_t i_count, float* const o_results );
 	}
 }
 
+#include "Functions.inl"
+
 #endif	// EAE6320_MATH_FUNCTIONS_H
@@ -0,0 +1,7 @@
+// Interface
+//==========
+
+constexpr float eae6320::Math::ConvertDegreesToRadians( const float i_degrees )
+{
+	return i_degrees * Pi / 180.0f;
+}
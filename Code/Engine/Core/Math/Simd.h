@@ -0,0 +1,30 @@
+/*
+	This file decides which SIMD instruction set the math library will use
+	and #includes the matching intrinsic headers
+
+	Every vectorized function has a scalar fallback;
+	defining EAE6320_MATH_SIMD_DISABLED (e.g. in the project's preprocessor definitions)
+	forces the scalar code everywhere, which can be useful when debugging or comparing results
+*/
+
+#ifndef EAE6320_MATH_SIMD_H
+#define EAE6320_MATH_SIMD_H
+
+#if !defined( EAE6320_MATH_SIMD_DISABLED )
+	// AVX is only used if the compiler has been told to generate it (/arch:AVX or -mavx)
+	#if defined( __AVX__ )
+		#define EAE6320_MATH_SIMD_AVX
+	#endif
+	// Every x64 CPU has SSE2, and Visual Studio targets it by default for Win32 as well
+	#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+		#define EAE6320_MATH_SIMD_SSE
+	#endif
+#endif
+
+#if defined( EAE6320_MATH_SIMD_AVX )
+	#include <immintrin.h>
+#elif defined( EAE6320_MATH_SIMD_SSE )
+	#include <emmintrin.h>
+#endif
+
+#endif	// EAE6320_MATH_SIMD_H
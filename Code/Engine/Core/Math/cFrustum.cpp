@@ -0,0 +1,120 @@
+// Header Files
+//=============
+
+#include "cFrustum.h"
+
+#include <cmath>
+#include "cMatrix_transformation.h"
+#include "cVector.h"
+#include "Simd.h"
+
+// Interface
+//==========
+
+// Visibility
+//-----------
+
+bool eae6320::Math::cFrustum::IsSphereVisible( const cVector& i_center, const float i_radius ) const
+{
+	for ( int i = 0; i < PlaneCount; ++i )
+	{
+		const float* const plane = m_planes[i];
+		const float signedDistance = ( plane[0] * i_center.x ) + ( plane[1] * i_center.y ) + ( plane[2] * i_center.z ) + plane[3];
+		if ( signedDistance < -i_radius )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void eae6320::Math::cFrustum::AreSpheresVisible( const float* const i_centers_x, const float* const i_centers_y, const float* const i_centers_z,
+	const float* const i_radii, const size_t i_count, uint8_t* const o_areVisible ) const
+{
+	size_t i = 0;
+#if defined( EAE6320_MATH_SIMD_SSE )
+	{
+		// Every plane is the same for every sphere,
+		// and so the plane coefficients are splatted once up front
+		__m128 planes[PlaneCount][4];
+		for ( int p = 0; p < PlaneCount; ++p )
+		{
+			for ( int k = 0; k < 4; ++k )
+			{
+				planes[p][k] = _mm_set1_ps( m_planes[p][k] );
+			}
+		}
+		const __m128 signMask = _mm_set1_ps( -0.0f );
+		for ( ; ( i + 4 ) <= i_count; i += 4 )
+		{
+			const __m128 x = _mm_loadu_ps( i_centers_x + i );
+			const __m128 y = _mm_loadu_ps( i_centers_y + i );
+			const __m128 z = _mm_loadu_ps( i_centers_z + i );
+			const __m128 radius_negated = _mm_xor_ps( _mm_loadu_ps( i_radii + i ), signMask );
+			// All six planes are always tested;
+			// branching out early would cost more than it saves for only four spheres
+			__m128 areVisible = _mm_cmpge_ps(
+				_mm_add_ps( _mm_add_ps( _mm_mul_ps( planes[0][0], x ), _mm_mul_ps( planes[0][1], y ) ),
+					_mm_add_ps( _mm_mul_ps( planes[0][2], z ), planes[0][3] ) ),
+				radius_negated );
+			for ( int p = 1; p < PlaneCount; ++p )
+			{
+				const __m128 signedDistance = _mm_add_ps( _mm_add_ps( _mm_mul_ps( planes[p][0], x ), _mm_mul_ps( planes[p][1], y ) ),
+					_mm_add_ps( _mm_mul_ps( planes[p][2], z ), planes[p][3] ) );
+				areVisible = _mm_and_ps( areVisible, _mm_cmpge_ps( signedDistance, radius_negated ) );
+			}
+			const int visibilityBits = _mm_movemask_ps( areVisible );
+			o_areVisible[i + 0] = static_cast<uint8_t>( visibilityBits & 1 );
+			o_areVisible[i + 1] = static_cast<uint8_t>( ( visibilityBits >> 1 ) & 1 );
+			o_areVisible[i + 2] = static_cast<uint8_t>( ( visibilityBits >> 2 ) & 1 );
+			o_areVisible[i + 3] = static_cast<uint8_t>( ( visibilityBits >> 3 ) & 1 );
+		}
+	}
+#endif
+	for ( ; i < i_count; ++i )
+	{
+		o_areVisible[i] = IsSphereVisible( cVector( i_centers_x[i], i_centers_y[i], i_centers_z[i] ), i_radii[i] ) ? 1 : 0;
+	}
+}
+
+// Initialization / Shut Down
+//---------------------------
+
+eae6320::Math::cFrustum::cFrustum( const cMatrix_transformation& i_transform_toProjected )
+{
+	// A point is transformed as a row vector,
+	// and so each projected component is the dot product of the point with one of the matrix's columns.
+	// A point is inside the frustum when -w <= x <= w, -w <= y <= w, and near <= z <= w,
+	// which means that each plane is a sum or difference of the w column and one of the others.
+	// The storage is column-major, so each column is 4 contiguous floats
+	const float* const column_x = &i_transform_toProjected.m_00;
+	const float* const column_y = &i_transform_toProjected.m_01;
+	const float* const column_z = &i_transform_toProjected.m_02;
+	const float* const column_w = &i_transform_toProjected.m_03;
+	for ( int k = 0; k < 4; ++k )
+	{
+		m_planes[Left][k] = column_w[k] + column_x[k];
+		m_planes[Right][k] = column_w[k] - column_x[k];
+		m_planes[Bottom][k] = column_w[k] + column_y[k];
+		m_planes[Top][k] = column_w[k] - column_y[k];
+#if defined( EAE6320_PLATFORM_D3D )
+		// Direct3D's projected z goes from 0 to w
+		m_planes[Near][k] = column_z[k];
+#elif defined( EAE6320_PLATFORM_GL ) || defined( EAE6320_PLATFORM_NULL )
+		// OpenGL's projected z goes from -w to w
+		m_planes[Near][k] = column_w[k] + column_z[k];
+#endif
+		m_planes[Far][k] = column_w[k] - column_z[k];
+	}
+	// The planes are normalized so that the distances can be compared with radii
+	for ( int i = 0; i < PlaneCount; ++i )
+	{
+		float* const plane = m_planes[i];
+		const float length = std::sqrt( ( plane[0] * plane[0] ) + ( plane[1] * plane[1] ) + ( plane[2] * plane[2] ) );
+		const float length_reciprocal = 1.0f / length;
+		for ( int k = 0; k < 4; ++k )
+		{
+			plane[k] *= length_reciprocal;
+		}
+	}
+}
@@ -0,0 +1,77 @@
+/*
+	This class represents the six planes of a view frustum
+
+	The planes are extracted directly from a transform that goes all the way to projected space
+	(e.g. worldToView * viewToScreen),
+	and so anything that is tested against them must be in that transform's source space
+	(e.g. world space)
+*/
+
+#ifndef EAE6320_MATH_CFRUSTUM_H
+#define EAE6320_MATH_CFRUSTUM_H
+
+// Header Files
+//=============
+
+#include <cstddef>
+#include <cstdint>
+
+// Forward Declarations
+//=====================
+
+namespace eae6320
+{
+	namespace Math
+	{
+		class cMatrix_transformation;
+		class cVector;
+	}
+}
+
+// Class Declaration
+//==================
+
+namespace eae6320
+{
+	namespace Math
+	{
+		class cFrustum
+		{
+			// Interface
+			//==========
+
+		public:
+
+			// Visibility
+			//-----------
+
+			// A sphere is visible if any part of it is on the inside of every plane
+			// (this is conservative: a large sphere near a corner of the frustum can be reported as visible when it isn't)
+			bool IsSphereVisible( const cVector& i_center, const float i_radius ) const;
+			// Equivalent to o_areVisible[i] = IsSphereVisible( cVector( i_centers_x[i], i_centers_y[i], i_centers_z[i] ), i_radii[i] ) ? 1 : 0
+			// (the spheres are passed as separate arrays so that four of them can be tested at once with SSE)
+			void AreSpheresVisible( const float* const i_centers_x, const float* const i_centers_y, const float* const i_centers_z,
+				const float* const i_radii, const size_t i_count, uint8_t* const o_areVisible ) const;
+
+			// Initialization / Shut Down
+			//---------------------------
+
+			explicit cFrustum( const cMatrix_transformation& i_transform_toProjected );
+
+			// Data
+			//=====
+
+		private:
+
+			enum ePlane
+			{
+				Left, Right, Bottom, Top, Near, Far,
+				PlaneCount
+			};
+			// Each plane is stored as a normalized (a, b, c, d) where the inside satisfies ax + by + cz + d >= 0
+			float m_planes[PlaneCount][4];
+		};
+	}
+}
+
+#endif	// EAE6320_MATH_CFRUSTUM_H
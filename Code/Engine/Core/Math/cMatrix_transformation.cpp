@@ -3,112 +3,164 @@
 
 #include "cMatrix_transformation.h"
 
-#include <cmath>
 #include "cQuaternion.h"
 #include "cVector.h"
+#include "Simd.h"
 
 // Interface
 //==========
 
-eae6320::Math::cMatrix_transformation eae6320::Math::cMatrix_transformation::CreateWorldToViewTransform(
-	const cQuaternion& i_cameraOrientation, const cVector& i_cameraPosition )
-{
-	cMatrix_transformation transform_viewToWorld( i_cameraOrientation, i_cameraPosition );
-	// A camera can only ever have rotation and translation
-	// and so a lot of simplifying assumptions can be made in order to create the inverse
-	return cMatrix_transformation(
-		transform_viewToWorld.m_00, transform_viewToWorld.m_01, transform_viewToWorld.m_02,
-			-( transform_viewToWorld.m_30 * transform_viewToWorld.m_00 ) - ( transform_viewToWorld.m_31 * transform_viewToWorld.m_01 ) - ( transform_viewToWorld.m_32 * transform_viewToWorld.m_02 ),
-		transform_viewToWorld.m_10, transform_viewToWorld.m_11, transform_viewToWorld.m_12,
-			-( transform_viewToWorld.m_30 * transform_viewToWorld.m_10 ) - ( transform_viewToWorld.m_31 * transform_viewToWorld.m_11 ) - ( transform_viewToWorld.m_32 * transform_viewToWorld.m_12 ),
-		transform_viewToWorld.m_20, transform_viewToWorld.m_21, transform_viewToWorld.m_22,
-			-( transform_viewToWorld.m_30 * transform_viewToWorld.m_20 ) - ( transform_viewToWorld.m_31 * transform_viewToWorld.m_21 ) - ( transform_viewToWorld.m_32 * transform_viewToWorld.m_22 ),
-		0.0f, 0.0f, 0.0f, 1.0f );
-}
+// Batch Operations
+//-----------------
 
-eae6320::Math::cMatrix_transformation eae6320::Math::cMatrix_transformation::CreateViewToScreenTransform(
-	const float i_fieldOfView_y, const float i_aspectRatio,
-	const float i_z_nearPlane, const float i_z_farPlane )
+void eae6320::Math::cMatrix_transformation::CreateFromRotationsAndTranslations( const cQuaternion* const i_rotations, const cVector* const i_translations,
+	const size_t i_count, cMatrix_transformation* const o_transforms )
 {
-	const float yScale = 1.0f / std::tan( i_fieldOfView_y * 0.5f );
-	const float xScale = yScale / i_aspectRatio;
-#if defined( EAE6320_PLATFORM_D3D )
-	const float zDistanceScale = i_z_farPlane / ( i_z_nearPlane - i_z_farPlane );
-	return cMatrix_transformation(
-		xScale, 0.0f, 0.0f, 0.0f,
-		0.0f, yScale, 0.0f, 0.0f,
-		0.0f, 0.0f, zDistanceScale, i_z_nearPlane * zDistanceScale,
-		0.0f, 0.0f, -1.0f, 0.0f );
-#elif defined( EAE6320_PLATFORM_GL )
-	const float zDistanceScale = 1.0f / ( i_z_nearPlane - i_z_farPlane );
-	return cMatrix_transformation(
-		xScale, 0.0f, 0.0f, 0.0f,
-		0.0f, yScale, 0.0f, 0.0f,
-		0.0f, 0.0f, ( i_z_nearPlane + i_z_farPlane ) * zDistanceScale, ( 2.0f * i_z_nearPlane * i_z_farPlane ) * zDistanceScale,
-		0.0f, 0.0f, -1.0f, 0.0f );
+	size_t i = 0;
+#if defined( EAE6320_MATH_SIMD_SSE )
+	// Four quaternions are converted at a time:
+	// Each quaternion is loaded as a row and then the 4x4 block is transposed
+	// so that each register holds the same component of four different quaternions
+	// (the math is then identical to the scalar constructor, just four wide),
+	// and the results are transposed back into columns before being stored
+	{
+		const __m128 one = _mm_set1_ps( 1.0f );
+		const __m128 lastColumn = _mm_set_ps( 1.0f, 0.0f, 0.0f, 0.0f );
+		for ( ; ( i + 4 ) <= i_count; i += 4 )
+		{
+			const cQuaternion* const rotations = i_rotations + i;
+			const cVector* const translations = i_translations + i;
+			// The quaternion is stored as w, x, y, z
+			__m128 w = _mm_loadu_ps( &rotations[0].m_w );
+			__m128 x = _mm_loadu_ps( &rotations[1].m_w );
+			__m128 y = _mm_loadu_ps( &rotations[2].m_w );
+			__m128 z = _mm_loadu_ps( &rotations[3].m_w );
+			_MM_TRANSPOSE4_PS( w, x, y, z );
+
+			const __m128 _2x = _mm_add_ps( x, x );
+			const __m128 _2y = _mm_add_ps( y, y );
+			const __m128 _2z = _mm_add_ps( z, z );
+			const __m128 _2xx = _mm_mul_ps( x, _2x );
+			const __m128 _2xy = _mm_mul_ps( _2x, y );
+			const __m128 _2xz = _mm_mul_ps( _2x, z );
+			const __m128 _2xw = _mm_mul_ps( _2x, w );
+			const __m128 _2yy = _mm_mul_ps( _2y, y );
+			const __m128 _2yz = _mm_mul_ps( _2y, z );
+			const __m128 _2yw = _mm_mul_ps( _2y, w );
+			const __m128 _2zz = _mm_mul_ps( _2z, z );
+			const __m128 _2zw = _mm_mul_ps( _2z, w );
+
+			__m128 m_00 = _mm_sub_ps( _mm_sub_ps( one, _2yy ), _2zz );
+			__m128 m_10 = _mm_add_ps( _2xy, _2zw );
+			__m128 m_20 = _mm_sub_ps( _2xz, _2yw );
+			__m128 m_30 = _mm_set_ps( translations[3].x, translations[2].x, translations[1].x, translations[0].x );
+
+			__m128 m_01 = _mm_sub_ps( _2xy, _2zw );
+			__m128 m_11 = _mm_sub_ps( _mm_sub_ps( one, _2xx ), _2zz );
+			__m128 m_21 = _mm_add_ps( _2yz, _2xw );
+			__m128 m_31 = _mm_set_ps( translations[3].y, translations[2].y, translations[1].y, translations[0].y );
+
+			__m128 m_02 = _mm_add_ps( _2xz, _2yw );
+			__m128 m_12 = _mm_sub_ps( _2yz, _2xw );
+			__m128 m_22 = _mm_sub_ps( _mm_sub_ps( one, _2xx ), _2yy );
+			__m128 m_32 = _mm_set_ps( translations[3].z, translations[2].z, translations[1].z, translations[0].z );
+
+			_MM_TRANSPOSE4_PS( m_00, m_10, m_20, m_30 );
+			_MM_TRANSPOSE4_PS( m_01, m_11, m_21, m_31 );
+			_MM_TRANSPOSE4_PS( m_02, m_12, m_22, m_32 );
+
+			cMatrix_transformation* const transforms = o_transforms + i;
+			_mm_storeu_ps( &transforms[0].m_00, m_00 );
+			_mm_storeu_ps( &transforms[0].m_01, m_01 );
+			_mm_storeu_ps( &transforms[0].m_02, m_02 );
+			_mm_storeu_ps( &transforms[0].m_03, lastColumn );
+			_mm_storeu_ps( &transforms[1].m_00, m_10 );
+			_mm_storeu_ps( &transforms[1].m_01, m_11 );
+			_mm_storeu_ps( &transforms[1].m_02, m_12 );
+			_mm_storeu_ps( &transforms[1].m_03, lastColumn );
+			_mm_storeu_ps( &transforms[2].m_00, m_20 );
+			_mm_storeu_ps( &transforms[2].m_01, m_21 );
+			_mm_storeu_ps( &transforms[2].m_02, m_22 );
+			_mm_storeu_ps( &transforms[2].m_03, lastColumn );
+			_mm_storeu_ps( &transforms[3].m_00, m_30 );
+			_mm_storeu_ps( &transforms[3].m_01, m_31 );
+			_mm_storeu_ps( &transforms[3].m_02, m_32 );
+			_mm_storeu_ps( &transforms[3].m_03, lastColumn );
+		}
+	}
 #endif
+	// Any remaining transforms (or all of them without SIMD) are converted one at a time
+	for ( ; i < i_count; ++i )
+	{
+		o_transforms[i] = cMatrix_transformation( i_rotations[i], i_translations[i] );
+	}
 }
 
-// Initialization / Shut Down
-//---------------------------
-
-eae6320::Math::cMatrix_transformation::cMatrix_transformation()
-	:
-	m_00( 1.0f ), m_10( 0.0f ), m_20( 0.0f ), m_30( 0.0f ),
-	m_01( 0.0f ), m_11( 1.0f ), m_21( 0.0f ), m_31( 0.0f ),
-	m_02( 0.0f ), m_12( 0.0f ), m_22( 1.0f ), m_32( 0.0f ),
-	m_03( 0.0f ), m_13( 0.0f ), m_23( 0.0f ), m_33( 1.0f )
+void eae6320::Math::cMatrix_transformation::Concatenate( const cMatrix_transformation* const i_lhs, const cMatrix_transformation& i_rhs,
+	const size_t i_count, cMatrix_transformation* const o_transforms )
 {
-
-}
-
-eae6320::Math::cMatrix_transformation::cMatrix_transformation( const cQuaternion& i_rotation, const cVector& i_translation )
-	:
-	m_30( i_translation.x ), m_31( i_translation.y ), m_32( i_translation.z ),
-	m_03( 0.0f ), m_13( 0.0f ), m_23( 0.0f ), m_33( 1.0f )
-{
-	const float _2x = i_rotation.m_x + i_rotation.m_x;
-	const float _2y = i_rotation.m_y + i_rotation.m_y;
-	const float _2z = i_rotation.m_z + i_rotation.m_z;
-	const float _2xx = i_rotation.m_x * _2x;
-	const float _2xy = _2x * i_rotation.m_y;
-	const float _2xz = _2x * i_rotation.m_z;
-	const float _2xw = _2x * i_rotation.m_w;
-	const float _2yy = _2y * i_rotation.m_y;
-	const float _2yz = _2y * i_rotation.m_z;
-	const float _2yw = _2y * i_rotation.m_w;
-	const float _2zz = _2z * i_rotation.m_z;
-	const float _2zw = _2z * i_rotation.m_w;
-
-	m_00 = 1.0f - _2yy - _2zz;
-	m_10 = _2xy + _2zw;
-	m_20 = _2xz - _2yw;
-
-	m_01 = _2xy - _2zw;
-	m_11 = 1.0f - _2xx - _2zz;
-	m_21 = _2yz + _2xw;
-
-	m_02 = _2xz + _2yw;
-	m_12 = _2yz - _2xw;
-	m_22 = 1.0f - _2xx - _2yy;
-}
-
-// Implementation
-//===============
-
-// Initialization / Shut Down
-//---------------------------
-
-eae6320::Math::cMatrix_transformation::cMatrix_transformation(
-	const float i_00, const float i_10, const float i_20, const float i_30,
-	const float i_01, const float i_11, const float i_21, const float i_31,
-	const float i_02, const float i_12, const float i_22, const float i_32,
-	const float i_03, const float i_13, const float i_23, const float i_33 )
-	:
-	m_00( i_00 ), m_10( i_10 ), m_20( i_20 ), m_30( i_30 ),
-	m_01( i_01 ), m_11( i_11 ), m_21( i_21 ), m_31( i_31 ),
-	m_02( i_02 ), m_12( i_12 ), m_22( i_22 ), m_32( i_32 ),
-	m_03( i_03 ), m_13( i_13 ), m_23( i_23 ), m_33( i_33 )
-{
-
+	size_t i = 0;
+#if defined( EAE6320_MATH_SIMD_AVX )
+	// Every output column is a weighted sum of the left-hand side's columns,
+	// where the weights come from the corresponding right-hand side column.
+	// With AVX two output columns are calculated at once,
+	// and so the weights are pre-splatted into the matching halves of each register
+	{
+		const float* const rhs = &i_rhs.m_00;
+		__m256 weights_01[4], weights_23[4];
+		for ( int k = 0; k < 4; ++k )
+		{
+			weights_01[k] = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_set1_ps( rhs[0 + k] ) ), _mm_set1_ps( rhs[4 + k] ), 1 );
+			weights_23[k] = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_set1_ps( rhs[8 + k] ) ), _mm_set1_ps( rhs[12 + k] ), 1 );
+		}
+		for ( ; i < i_count; ++i )
+		{
+			const float* const lhs = &i_lhs[i].m_00;
+			const __m256 lhs_0 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( lhs + 0 ) );
+			const __m256 lhs_1 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( lhs + 4 ) );
+			const __m256 lhs_2 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( lhs + 8 ) );
+			const __m256 lhs_3 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( lhs + 12 ) );
+			const __m256 result_01 = _mm256_add_ps(
+				_mm256_add_ps( _mm256_mul_ps( lhs_0, weights_01[0] ), _mm256_mul_ps( lhs_1, weights_01[1] ) ),
+				_mm256_add_ps( _mm256_mul_ps( lhs_2, weights_01[2] ), _mm256_mul_ps( lhs_3, weights_01[3] ) ) );
+			const __m256 result_23 = _mm256_add_ps(
+				_mm256_add_ps( _mm256_mul_ps( lhs_0, weights_23[0] ), _mm256_mul_ps( lhs_1, weights_23[1] ) ),
+				_mm256_add_ps( _mm256_mul_ps( lhs_2, weights_23[2] ), _mm256_mul_ps( lhs_3, weights_23[3] ) ) );
+			float* const result = &o_transforms[i].m_00;
+			_mm256_storeu_ps( result + 0, result_01 );
+			_mm256_storeu_ps( result + 8, result_23 );
+		}
+	}
+#elif defined( EAE6320_MATH_SIMD_SSE )
+	// The right-hand side is the same for every transform,
+	// and so its elements are splatted once up front
+	{
+		const float* const rhs = &i_rhs.m_00;
+		__m128 weights[16];
+		for ( int k = 0; k < 16; ++k )
+		{
+			weights[k] = _mm_set1_ps( rhs[k] );
+		}
+		for ( ; i < i_count; ++i )
+		{
+			const float* const lhs = &i_lhs[i].m_00;
+			const __m128 lhs_0 = _mm_loadu_ps( lhs + 0 );
+			const __m128 lhs_1 = _mm_loadu_ps( lhs + 4 );
+			const __m128 lhs_2 = _mm_loadu_ps( lhs + 8 );
+			const __m128 lhs_3 = _mm_loadu_ps( lhs + 12 );
+			float* const result = &o_transforms[i].m_00;
+			for ( int j = 0; j < 4; ++j )
+			{
+				const __m128* const columnWeights = weights + ( j * 4 );
+				_mm_storeu_ps( result + ( j * 4 ), _mm_add_ps(
+					_mm_add_ps( _mm_mul_ps( lhs_0, columnWeights[0] ), _mm_mul_ps( lhs_1, columnWeights[1] ) ),
+					_mm_add_ps( _mm_mul_ps( lhs_2, columnWeights[2] ), _mm_mul_ps( lhs_3, columnWeights[3] ) ) ) );
+			}
+		}
+	}
+#endif
+	for ( ; i < i_count; ++i )
+	{
+		o_transforms[i] = i_lhs[i] * i_rhs;
+	}
 }
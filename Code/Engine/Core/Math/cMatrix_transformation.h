@@ -20,6 +20,11 @@
 #ifndef EAE6320_MATH_CMATRIX_TRANSFORMATION_H
 #define EAE6320_MATH_CMATRIX_TRANSFORMATION_H
 
+// Header Files
+//=============
+
+#include <cstddef>
+
 // Forward Declarations
 //=====================
 
@@ -51,11 +56,37 @@ namespace eae6320
 			static cMatrix_transformation CreateViewToScreenTransform(
 				const float i_fieldOfView_y, const float i_aspectRatio,
 				const float i_z_nearPlane, const float i_z_farPlane );
+			// Scales each axis and then translates
+			// (e.g. to expand positions that were stored relative to a bounding box)
+			static cMatrix_transformation CreateScaleAndTranslation( const cVector& i_scale, const cVector& i_translation );
+
+			// Concatenation
+			// (the result is equivalent to transforming by this matrix first and then by the right-hand side,
+			// which is the same order that the shaders apply the transforms in)
+			cMatrix_transformation operator *( const cMatrix_transformation& i_rhs ) const;
+
+			// Transformation
+			// (the point is treated as having a w of 1, and so it is affected by the translation)
+			cVector TransformPoint( const cVector& i_point ) const;
+
+			// Batch Operations
+			//-----------------
+
+			// These work on contiguous arrays so that the per-frame transform work can be vectorized
+			// (they use SSE/AVX when available and fall back to scalar code otherwise).
+			// The output array must not overlap any of the input arrays.
+
+			// Equivalent to o_transforms[i] = cMatrix_transformation( i_rotations[i], i_translations[i] )
+			static void CreateFromRotationsAndTranslations( const cQuaternion* const i_rotations, const cVector* const i_translations,
+				const size_t i_count, cMatrix_transformation* const o_transforms );
+			// Equivalent to o_transforms[i] = i_lhs[i] * i_rhs
+			static void Concatenate( const cMatrix_transformation* const i_lhs, const cMatrix_transformation& i_rhs,
+				const size_t i_count, cMatrix_transformation* const o_transforms );
 
 			// Initialization / Shut Down
 			//---------------------------
 
-			cMatrix_transformation();	// Identity
+			constexpr cMatrix_transformation();	// Identity
 			cMatrix_transformation( const cQuaternion& i_rotation, const cVector& i_translation );
 
 			// Data
@@ -77,13 +108,20 @@ namespace eae6320
 			// Initialization / Shut Down
 			//---------------------------
 
-			cMatrix_transformation(
+			constexpr cMatrix_transformation(
 				const float i_00, const float i_10, const float i_20, const float i_30,
 				const float i_01, const float i_11, const float i_21, const float i_31,
 				const float i_02, const float i_12, const float i_22, const float i_32,
 				const float i_03, const float i_13, const float i_23, const float i_33 );
+
+			// Friend Classes
+			//===============
+
+			friend class cFrustum;
 		};
 	}
 }
 
+#include "cMatrix_transformation.inl"
+
 #endif	// EAE6320_MATH_CMATRIX_TRANSFORMATION_H
@@ -3,97 +3,85 @@
 
 #include "cQuaternion.h"
 
-#include <cassert>
-#include <cmath>
-#include "cVector.h"
+#include "Functions.h"
 
 // Static Data Initialization
 //===========================
 
 namespace
 {
-	const float s_epsilon = 1.0e-9f;
+	// The sines and cosines are calculated in chunks that fit on the stack
+	const size_t s_chunkSize = 64;
 }
 
 // Interface
 //==========
 
-// Concatenation
-eae6320::Math::cQuaternion eae6320::Math::cQuaternion::operator *( const cQuaternion& i_rhs ) const
-{
-	return cQuaternion(
-		( m_w * i_rhs.m_w ) - ( ( m_x * i_rhs.m_x ) + ( m_y * i_rhs.m_y ) + ( m_z * i_rhs.m_z ) ),
-		( m_w * i_rhs.m_x ) + ( m_x * i_rhs.m_w ) + ( ( m_y * i_rhs.m_z ) - ( m_z * i_rhs.m_y ) ),
-		( m_w * i_rhs.m_y ) + ( m_y * i_rhs.m_w ) + ( ( m_z * i_rhs.m_x ) - ( m_x * i_rhs.m_z ) ),
-		( m_w * i_rhs.m_z ) + ( m_z * i_rhs.m_w ) + ( ( m_x * i_rhs.m_y ) - ( m_y * i_rhs.m_x ) ) );
-}
-
-// Inversion
-void eae6320::Math::cQuaternion::Invert()
-{
-	m_x = -m_x;
-	m_y = -m_y;
-	m_z = -m_z;
-}
-eae6320::Math::cQuaternion eae6320::Math::cQuaternion::CreateInverse() const
-{
-	return cQuaternion( m_w, -m_x, -m_y, -m_z );
-}
-
-// Normalization
-void eae6320::Math::cQuaternion::Normalize()
-{
-	const float length = std::sqrt( ( m_w * m_w ) + ( m_x * m_x ) + ( m_y * m_y ) + ( m_z * m_z ) );
-	assert( length > s_epsilon );
-	const float length_reciprocal = 1.0f / length;
-	m_w *= length_reciprocal;
-	m_x *= length_reciprocal;
-	m_y *= length_reciprocal;
-	m_z *= length_reciprocal;
-}
-eae6320::Math::cQuaternion eae6320::Math::cQuaternion::CreateNormalized() const
-{
-	const float length = std::sqrt( ( m_w * m_w ) + ( m_x * m_x ) + ( m_y * m_y ) + ( m_z * m_z ) );
-	assert( length > s_epsilon );
-	const float length_reciprocal = 1.0f / length;
-	return cQuaternion( m_w * length_reciprocal, m_x * length_reciprocal, m_y * length_reciprocal, m_z * length_reciprocal );
-}
-
-// Products
-float eae6320::Math::Dot( const cQuaternion& i_lhs, const cQuaternion& i_rhs )
-{
-	return ( i_lhs.m_w * i_rhs.m_w ) + ( i_lhs.m_x * i_rhs.m_x ) + ( i_lhs.m_y * i_rhs.m_y ) + ( i_lhs.m_z * i_rhs.m_z );
-}
+// Batch Operations
+//-----------------
 
-// Initialization / Shut Down
-//---------------------------
-
-eae6320::Math::cQuaternion::cQuaternion()
-	:
-	m_w( 1.0f ), m_x( 0.0f ), m_y( 0.0f ), m_z( 0.0f )
+void eae6320::Math::cQuaternion::CreateFromAnglesAndAxis( const float* const i_anglesInRadians, const cVector& i_axisOfRotation_normalized,
+	const size_t i_count, cQuaternion* const o_quaternions )
 {
-
+	float sines[s_chunkSize], cosines[s_chunkSize];
+	for ( size_t chunkStart = 0; chunkStart < i_count; chunkStart += s_chunkSize )
+	{
+		const size_t count = ( ( i_count - chunkStart ) < s_chunkSize ) ? ( i_count - chunkStart ) : s_chunkSize;
+		for ( size_t i = 0; i < count; ++i )
+		{
+			sines[i] = i_anglesInRadians[chunkStart + i] * 0.5f;
+		}
+		SinCos( sines, count, sines, cosines );
+		cQuaternion* const quaternions = o_quaternions + chunkStart;
+		for ( size_t i = 0; i < count; ++i )
+		{
+			quaternions[i] = cQuaternion( cosines[i],
+				i_axisOfRotation_normalized.x * sines[i], i_axisOfRotation_normalized.y * sines[i], i_axisOfRotation_normalized.z * sines[i] );
+		}
+	}
 }
 
-eae6320::Math::cQuaternion::cQuaternion( const float i_angleInRadians, const cVector& i_axisOfRotation_normalized )
+void eae6320::Math::cQuaternion::CreateFromAnglesAndAxes( const float* const i_anglesInRadians, const cVector* const i_axesOfRotation_normalized,
+	const size_t i_count, cQuaternion* const o_quaternions )
 {
-	const float theta_half = i_angleInRadians * 0.5f;
-	m_w = std::cos( theta_half );
-	const float sin_theta_half = std::sin( theta_half );
-	m_x = i_axisOfRotation_normalized.x * sin_theta_half;
-	m_y = i_axisOfRotation_normalized.y * sin_theta_half;
-	m_z = i_axisOfRotation_normalized.z * sin_theta_half;
+	float sines[s_chunkSize], cosines[s_chunkSize];
+	for ( size_t chunkStart = 0; chunkStart < i_count; chunkStart += s_chunkSize )
+	{
+		const size_t count = ( ( i_count - chunkStart ) < s_chunkSize ) ? ( i_count - chunkStart ) : s_chunkSize;
+		for ( size_t i = 0; i < count; ++i )
+		{
+			sines[i] = i_anglesInRadians[chunkStart + i] * 0.5f;
+		}
+		SinCos( sines, count, sines, cosines );
+		const cVector* const axes = i_axesOfRotation_normalized + chunkStart;
+		cQuaternion* const quaternions = o_quaternions + chunkStart;
+		for ( size_t i = 0; i < count; ++i )
+		{
+			quaternions[i] = cQuaternion( cosines[i], axes[i].x * sines[i], axes[i].y * sines[i], axes[i].z * sines[i] );
+		}
+	}
 }
 
-// Implementation
-//===============
-
-// Initialization / Shut Down
-//---------------------------
-
-eae6320::Math::cQuaternion::cQuaternion( const float i_w, const float i_x, const float i_y, const float i_z )
-	:
-	m_w( i_w ), m_x( i_x ), m_y( i_y ), m_z( i_z )
+void eae6320::Math::cQuaternion::Normalize( cQuaternion* const io_quaternions, const size_t i_count )
 {
-
+	float lengths_reciprocal[s_chunkSize];
+	for ( size_t chunkStart = 0; chunkStart < i_count; chunkStart += s_chunkSize )
+	{
+		cQuaternion* const quaternions = io_quaternions + chunkStart;
+		const size_t count = ( ( i_count - chunkStart ) < s_chunkSize ) ? ( i_count - chunkStart ) : s_chunkSize;
+		for ( size_t i = 0; i < count; ++i )
+		{
+			lengths_reciprocal[i] = Dot( quaternions[i], quaternions[i] );
+			assert( lengths_reciprocal[i] > ( s_epsilon * s_epsilon ) );
+		}
+		ReciprocalSquareRoot( lengths_reciprocal, count, lengths_reciprocal );
+		for ( size_t i = 0; i < count; ++i )
+		{
+			cQuaternion& quaternion = quaternions[i];
+			quaternion.m_w *= lengths_reciprocal[i];
+			quaternion.m_x *= lengths_reciprocal[i];
+			quaternion.m_y *= lengths_reciprocal[i];
+			quaternion.m_z *= lengths_reciprocal[i];
+		}
+	}
 }
@@ -5,6 +5,11 @@
 #ifndef EAE6320_MATH_CQUATERNION_H
 #define EAE6320_MATH_CQUATERNION_H
 
+// Header Files
+//=============
+
+#include <cstddef>
+
 // Forward Declarations
 //=====================
 
@@ -31,23 +36,38 @@ namespace eae6320
 		public:
 
 			// Concatenation
-			cQuaternion operator *( const cQuaternion& i_rhs ) const;
+			constexpr cQuaternion operator *( const cQuaternion& i_rhs ) const;
 
 			// Inversion
 			void Invert();
-			cQuaternion CreateInverse() const;
+			constexpr cQuaternion CreateInverse() const;
 
 			// Normalization
 			void Normalize();
 			cQuaternion CreateNormalized() const;
 
 			// Products
-			friend float Dot( const cQuaternion& i_lhs, const cQuaternion& i_rhs );
+			friend constexpr float Dot( const cQuaternion& i_lhs, const cQuaternion& i_rhs );
+
+			// Batch Operations
+			//-----------------
+
+			// These evaluate every sine and cosine with Math::SinCos() (see Functions.h for the accuracy)
+			// instead of calling std::sin() and std::cos() once per quaternion
+
+			// Equivalent to o_quaternions[i] = cQuaternion( i_anglesInRadians[i], i_axisOfRotation_normalized )
+			static void CreateFromAnglesAndAxis( const float* const i_anglesInRadians, const cVector& i_axisOfRotation_normalized,
+				const size_t i_count, cQuaternion* const o_quaternions );
+			// Equivalent to o_quaternions[i] = cQuaternion( i_anglesInRadians[i], i_axesOfRotation_normalized[i] )
+			static void CreateFromAnglesAndAxes( const float* const i_anglesInRadians, const cVector* const i_axesOfRotation_normalized,
+				const size_t i_count, cQuaternion* const o_quaternions );
+			// Equivalent to calling Normalize() on every quaternion in the array
+			static void Normalize( cQuaternion* const io_quaternions, const size_t i_count );
 
 			// Initialization / Shut Down
 			//---------------------------
 
-			cQuaternion();	// Identity
+			constexpr cQuaternion();	// Identity
 			cQuaternion( const float i_angleInRadians, const cVector& i_axisOfRotation_normalized );
 
 			// Data
@@ -62,17 +82,26 @@ namespace eae6320
 
 		private:
 
+			static constexpr float s_epsilon = 1.0e-9f;
+
 			// Initialization / Shut Down
 			//---------------------------
 
-			cQuaternion( const float i_w, const float i_x, const float i_y, const float i_z );
+			constexpr cQuaternion( const float i_w, const float i_x, const float i_y, const float i_z );
 
 			// Friend Classes
 			//===============
 
 			friend class cMatrix_transformation;
 		};
+
+		// Friend Function Declarations
+		//=============================
+
+		constexpr float Dot( const cQuaternion& i_lhs, const cQuaternion& i_rhs );
 	}
 }
 
+#include "cQuaternion.inl"
+
 #endif	// EAE6320_MATH_CQUATERNION_H
@@ -5,6 +5,11 @@
 #ifndef EAE6320_MATH_CVECTOR_H
 #define EAE6320_MATH_CVECTOR_H
 
+// Header Files
+//=============
+
+#include <cstddef>
+
 // Class Declaration
 //==================
 
@@ -20,18 +25,18 @@ namespace eae6320
 		public:
 
 			// Addition
-			cVector operator +( const cVector& i_rhs ) const;
+			constexpr cVector operator +( const cVector& i_rhs ) const;
 			cVector& operator +=( const cVector& i_rhs );
 
 			// Subtraction / Negation
-			cVector operator -( const cVector& i_rhs ) const;
+			constexpr cVector operator -( const cVector& i_rhs ) const;
 			cVector& operator -=( const cVector& i_rhs );
-			cVector operator -() const;
+			constexpr cVector operator -() const;
 
 			// Multiplication
-			cVector operator *( const float i_rhs ) const;
+			constexpr cVector operator *( const float i_rhs ) const;
 			cVector& operator *=( const float i_rhs );
-			friend cVector operator *( const float i_lhs, const cVector& i_rhs );
+			friend constexpr cVector operator *( const float i_lhs, const cVector& i_rhs );
 
 			// Division
 			cVector operator /( const float i_rhs ) const;
@@ -42,18 +47,26 @@ namespace eae6320
 			float Normalize();
 			cVector CreateNormalized() const;
 
+			// Batch Operations
+			//-----------------
+
+			// Equivalent to calling Normalize() on every vector in the array
+			// (the lengths use Math::ReciprocalSquareRoot(); see Functions.h for the accuracy).
+			// Like Normalize() every vector must have a non-zero length
+			static void Normalize( cVector* const io_vectors, const size_t i_count );
+
 			// Products
-			friend float Dot( const cVector& i_lhs, const cVector& i_rhs );
-			friend cVector Cross( const cVector& i_lhs, const cVector& i_rhs );
+			friend constexpr float Dot( const cVector& i_lhs, const cVector& i_rhs );
+			friend constexpr cVector Cross( const cVector& i_lhs, const cVector& i_rhs );
 
 			// Comparison
-			bool operator ==( const cVector& i_rhs ) const;
-			bool operator !=( const cVector& i_rhs ) const;
+			constexpr bool operator ==( const cVector& i_rhs ) const;
+			constexpr bool operator !=( const cVector& i_rhs ) const;
 
 			// Initialization / Shut Down
 			//---------------------------
 
-			cVector( const float i_x = 0.0f, const float i_y = 0.0f, const float i_z = 0.0f );
+			constexpr cVector( const float i_x = 0.0f, const float i_y = 0.0f, const float i_z = 0.0f );
 
 			// Data
 			//=====
@@ -63,6 +76,13 @@ namespace eae6320
 
 			float x, y, z;
 
+			// Implementation
+			//===============
+
+		private:
+
+			static constexpr float s_epsilon = 1.0e-9f;
+
 			// Friend Classes
 			//===============
 
@@ -73,10 +93,12 @@ namespace eae6320
 		// Friend Function Declarations
 		//=============================
 
-		cVector operator *( const float i_lhs, const cVector& i_rhs );
-		float Dot( const cVector& i_lhs, const cVector& i_rhs );
-		cVector Cross( const cVector& i_lhs, const cVector& i_rhs );
+		constexpr cVector operator *( const float i_lhs, const cVector& i_rhs );
+		constexpr float Dot( const cVector& i_lhs, const cVector& i_rhs );
+		constexpr cVector Cross( const cVector& i_lhs, const cVector& i_rhs );
 	}
 }
 
+#include "cVector.inl"
+
 #endif	// EAE6320_MATH_CVECTOR_H
@@ -0,0 +1,392 @@
+// Header Files
+//=============
+
+#include "AssetCompression.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	// Every sequence looks like this:
+	//	[token][more literal count][literals][match offset][more match length]
+	// The token has the literal count in its high four bits and the match length (minus s_minMatchLength) in its low four bits,
+	// and when either of them is 15 more bytes follow that are added to it until one of them isn't 255.
+	// The offset is how far back the match starts, in two little-endian bytes.
+	// The last sequence of a chunk only has literals (and ends exactly where the chunk does)
+	const size_t s_minMatchLength = 4;
+	const size_t s_maxOffset = 0xffff;
+	const uint8_t s_maxTokenLength = 15;
+	// The compressor finds matches by remembering where it last saw four bytes with each of these hashes
+	const unsigned int s_hashBitCount = 14;
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	size_t GetCompressedChunkSizeBound( const size_t i_size );
+	// Returns the compressed size (o_output must have room for GetCompressedChunkSizeBound() bytes)
+	size_t CompressChunk( const uint8_t* const i_input, const size_t i_size, uint8_t* const o_output, std::vector<uint32_t>& io_hashTable );
+	// A match length of zero writes the last sequence
+	uint8_t* WriteSequence( const uint8_t* const i_literals, const size_t i_literalCount, const size_t i_offset, const size_t i_matchLength,
+		uint8_t* o_output );
+	uint8_t* WriteMoreLength( size_t i_length, uint8_t* o_output );
+	bool ReadMoreLength( const uint8_t*& io_input, const uint8_t* const i_inputEnd, size_t& io_length );
+	uint32_t Read32( const uint8_t* const i_bytes );
+	uint32_t Hash( const uint32_t i_bytes );
+	void SetErrorMessage( const char* const i_reason, std::string* o_errorMessage );
+}
+
+// Interface
+//==========
+
+// Compression
+//------------
+
+void eae6320::Graphics::AssetCompression::Compress( const uint8_t* const i_contents, const size_t i_size, std::vector<uint8_t>& o_compressed,
+	const uint32_t i_chunkSize )
+{
+	const uint32_t chunkSize = std::min( std::max( i_chunkSize, 1u ), s_maxChunkSize );
+	sHeader header;
+	header.magic = s_magic;
+	header.version = s_version;
+	header.uncompressedSize = i_size;
+	header.chunkSize = chunkSize;
+	header.chunkCount = static_cast<uint32_t>( ( i_size + chunkSize - 1 ) / chunkSize );
+
+	const size_t chunkTableSize = header.chunkCount * sizeof( uint32_t );
+	o_compressed.resize( sizeof( header ) + chunkTableSize );
+	std::memcpy( &o_compressed[0], &header, sizeof( header ) );
+	std::vector<uint32_t> hashTable( size_t( 1 ) << s_hashBitCount );
+	for ( uint32_t i = 0; i < header.chunkCount; ++i )
+	{
+		const size_t chunkStart = static_cast<size_t>( i ) * chunkSize;
+		const size_t uncompressedChunkSize = std::min<size_t>( chunkSize, i_size - chunkStart );
+		const size_t chunkOffset = o_compressed.size();
+		o_compressed.resize( chunkOffset + GetCompressedChunkSizeBound( uncompressedChunkSize ) );
+		size_t compressedChunkSize = CompressChunk( i_contents + chunkStart, uncompressedChunkSize, &o_compressed[chunkOffset], hashTable );
+		if ( compressedChunkSize >= uncompressedChunkSize )
+		{
+			std::memcpy( &o_compressed[chunkOffset], i_contents + chunkStart, uncompressedChunkSize );
+			compressedChunkSize = uncompressedChunkSize;
+		}
+		o_compressed.resize( chunkOffset + compressedChunkSize );
+		const uint32_t compressedChunkSize_table = static_cast<uint32_t>( compressedChunkSize );
+		std::memcpy( &o_compressed[sizeof( header ) + ( i * sizeof( uint32_t ) )], &compressedChunkSize_table, sizeof( uint32_t ) );
+	}
+}
+
+// Decompression
+//--------------
+
+bool eae6320::Graphics::AssetCompression::IsCompressed( const uint8_t* const i_contents, const size_t i_size )
+{
+	uint32_t magic;
+	if ( ( i_contents == NULL ) || ( i_size < sizeof( sHeader ) ) )
+	{
+		return false;
+	}
+	std::memcpy( &magic, i_contents, sizeof( magic ) );
+	return magic == s_magic;
+}
+
+bool eae6320::Graphics::AssetCompression::ReadChunkTable( const uint8_t* const i_compressed, const size_t i_size,
+	sHeader& o_header, std::vector<size_t>& o_chunkOffsets, std::string* o_errorMessage )
+{
+	o_chunkOffsets.clear();
+	if ( !IsCompressed( i_compressed, i_size ) )
+	{
+		SetErrorMessage( "It isn't compressed", o_errorMessage );
+		return false;
+	}
+	// The header is copied because a file's contents don't have to be aligned for it
+	std::memcpy( &o_header, i_compressed, sizeof( o_header ) );
+	if ( o_header.version != s_version )
+	{
+		SetErrorMessage( "It was compressed by a different version of the builders", o_errorMessage );
+		return false;
+	}
+	if ( ( o_header.chunkSize == 0 ) || ( o_header.chunkSize > s_maxChunkSize ) )
+	{
+		SetErrorMessage( "Its chunk size isn't valid", o_errorMessage );
+		return false;
+	}
+	if ( ( o_header.uncompressedSize == 0 ) || ( o_header.uncompressedSize > std::numeric_limits<size_t>::max() ) )
+	{
+		SetErrorMessage( "Its uncompressed size isn't valid", o_errorMessage );
+		return false;
+	}
+	if ( o_header.chunkCount != ( ( o_header.uncompressedSize + o_header.chunkSize - 1 ) / o_header.chunkSize ) )
+	{
+		SetErrorMessage( "It doesn't have the right number of chunks for its size", o_errorMessage );
+		return false;
+	}
+	if ( ( static_cast<uint64_t>( o_header.chunkCount ) * sizeof( uint32_t ) ) > ( i_size - sizeof( sHeader ) ) )
+	{
+		SetErrorMessage( "Its chunk table is cut short", o_errorMessage );
+		return false;
+	}
+
+	o_chunkOffsets.resize( static_cast<size_t>( o_header.chunkCount ) + 1 );
+	size_t chunkOffset = sizeof( sHeader ) + ( o_header.chunkCount * sizeof( uint32_t ) );
+	for ( uint32_t i = 0; i < o_header.chunkCount; ++i )
+	{
+		uint32_t compressedChunkSize;
+		std::memcpy( &compressedChunkSize, i_compressed + sizeof( sHeader ) + ( i * sizeof( uint32_t ) ), sizeof( uint32_t ) );
+		const uint64_t chunkStart = static_cast<uint64_t>( i ) * o_header.chunkSize;
+		const uint64_t uncompressedChunkSize = std::min<uint64_t>( o_header.chunkSize, o_header.uncompressedSize - chunkStart );
+		// A chunk that doesn't get smaller is stored as it is instead
+		if ( ( compressedChunkSize == 0 ) || ( compressedChunkSize > uncompressedChunkSize ) )
+		{
+			SetErrorMessage( "One of its chunks isn't a valid size", o_errorMessage );
+			return false;
+		}
+		if ( compressedChunkSize > ( i_size - chunkOffset ) )
+		{
+			SetErrorMessage( "One of its chunks is past the end of the file", o_errorMessage );
+			return false;
+		}
+		o_chunkOffsets[i] = chunkOffset;
+		chunkOffset += compressedChunkSize;
+	}
+	if ( chunkOffset != i_size )
+	{
+		SetErrorMessage( "There is more after its last chunk", o_errorMessage );
+		return false;
+	}
+	o_chunkOffsets.back() = chunkOffset;
+	return true;
+}
+
+bool eae6320::Graphics::AssetCompression::DecompressChunk( const uint8_t* const i_compressed, const sHeader& i_header,
+	const std::vector<size_t>& i_chunkOffsets, const uint32_t i_chunkIndex, uint8_t* const o_contents )
+{
+	const size_t chunkStart = static_cast<size_t>( i_chunkIndex ) * i_header.chunkSize;
+	const size_t uncompressedChunkSize = std::min<size_t>( i_header.chunkSize, static_cast<size_t>( i_header.uncompressedSize ) - chunkStart );
+	const uint8_t* input = i_compressed + i_chunkOffsets[i_chunkIndex];
+	const uint8_t* const inputEnd = i_compressed + i_chunkOffsets[i_chunkIndex + 1];
+	uint8_t* const outputStart = o_contents + chunkStart;
+	uint8_t* output = outputStart;
+	uint8_t* const outputEnd = outputStart + uncompressedChunkSize;
+	if ( static_cast<size_t>( inputEnd - input ) == uncompressedChunkSize )
+	{
+		std::memcpy( output, input, uncompressedChunkSize );
+		return true;
+	}
+
+	while ( input < inputEnd )
+	{
+		const uint8_t token = *input++;
+
+		// Literals
+		{
+			size_t literalCount = token >> 4;
+			if ( ( literalCount == s_maxTokenLength ) && !ReadMoreLength( input, inputEnd, literalCount ) )
+			{
+				return false;
+			}
+			if ( ( literalCount > static_cast<size_t>( inputEnd - input ) ) || ( literalCount > static_cast<size_t>( outputEnd - output ) ) )
+			{
+				return false;
+			}
+			// Most runs of literals are short, and when there's room they are copied 16 bytes at a time
+			// (the extra bytes are overwritten by whatever comes next)
+			if ( ( literalCount <= 16 ) && ( ( inputEnd - input ) >= 16 ) && ( ( outputEnd - output ) >= 16 ) )
+			{
+				std::memcpy( output, input, 16 );
+			}
+			else
+			{
+				std::memcpy( output, input, literalCount );
+			}
+			output += literalCount;
+			input += literalCount;
+		}
+		if ( input == inputEnd )
+		{
+			break;
+		}
+
+		// Match
+		{
+			if ( ( inputEnd - input ) < 2 )
+			{
+				return false;
+			}
+			const size_t offset = static_cast<size_t>( input[0] ) | ( static_cast<size_t>( input[1] ) << 8 );
+			input += 2;
+			size_t matchLength = token & 0xf;
+			if ( ( matchLength == s_maxTokenLength ) && !ReadMoreLength( input, inputEnd, matchLength ) )
+			{
+				return false;
+			}
+			matchLength += s_minMatchLength;
+			if ( ( offset == 0 ) || ( offset > static_cast<size_t>( output - outputStart ) )
+				|| ( matchLength > static_cast<size_t>( outputEnd - output ) ) )
+			{
+				return false;
+			}
+			const uint8_t* match = output - offset;
+			uint8_t* const matchEnd = output + matchLength;
+			if ( ( offset >= 16 ) && ( static_cast<size_t>( outputEnd - output ) >= ( matchLength + 15 ) ) )
+			{
+				// Every 16 bytes that are copied come from before where they are copied to,
+				// and so this works even when the match overlaps itself
+				do
+				{
+					std::memcpy( output, match, 16 );
+					output += 16;
+					match += 16;
+				} while ( output < matchEnd );
+			}
+			else if ( offset >= matchLength )
+			{
+				std::memcpy( output, match, matchLength );
+			}
+			else
+			{
+				// A match that is closer than its length repeats the bytes that it has just copied
+				for ( size_t i = 0; i < matchLength; ++i )
+				{
+					output[i] = match[i];
+				}
+			}
+			output = matchEnd;
+		}
+	}
+
+	return output == outputEnd;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	size_t GetCompressedChunkSizeBound( const size_t i_size )
+	{
+		// The worst case is a single run of literals
+		return i_size + ( i_size / 255 ) + 16;
+	}
+
+	size_t CompressChunk( const uint8_t* const i_input, const size_t i_size, uint8_t* const o_output, std::vector<uint32_t>& io_hashTable )
+	{
+		// The table has one more than the position of the four bytes that were last seen with each hash
+		// (so that zero means that there weren't any)
+		std::fill( io_hashTable.begin(), io_hashTable.end(), 0 );
+		uint8_t* output = o_output;
+		size_t literalStart = 0;
+		size_t position = 0;
+		// The search skips ahead faster the longer it goes without finding a match,
+		// so that data that doesn't compress doesn't take long to find out about
+		size_t missCount = 0;
+		while ( ( position + s_minMatchLength ) <= i_size )
+		{
+			const uint32_t bytes = Read32( i_input + position );
+			uint32_t& hashEntry = io_hashTable[Hash( bytes )];
+			const size_t candidate = hashEntry;
+			hashEntry = static_cast<uint32_t>( position + 1 );
+			if ( ( candidate == 0 ) || ( ( position - ( candidate - 1 ) ) > s_maxOffset ) || ( Read32( i_input + ( candidate - 1 ) ) != bytes ) )
+			{
+				position += 1 + ( missCount++ >> 6 );
+				continue;
+			}
+			missCount = 0;
+
+			const size_t matchStart = candidate - 1;
+			size_t matchLength = s_minMatchLength;
+			while ( ( ( position + matchLength ) < i_size ) && ( i_input[matchStart + matchLength] == i_input[position + matchLength] ) )
+			{
+				++matchLength;
+			}
+			output = WriteSequence( i_input + literalStart, position - literalStart, position - matchStart, matchLength, output );
+			position += matchLength;
+			literalStart = position;
+			// Remembering a position from inside the match helps to find the next one
+			if ( ( position + 2 ) <= i_size )
+			{
+				io_hashTable[Hash( Read32( i_input + ( position - 2 ) ) )] = static_cast<uint32_t>( position - 1 );
+			}
+		}
+		output = WriteSequence( i_input + literalStart, i_size - literalStart, 0, 0, output );
+		return static_cast<size_t>( output - o_output );
+	}
+
+	uint8_t* WriteSequence( const uint8_t* const i_literals, const size_t i_literalCount, const size_t i_offset, const size_t i_matchLength,
+		uint8_t* o_output )
+	{
+		const bool hasMatch = i_matchLength != 0;
+		const size_t matchLength_token = hasMatch ? ( i_matchLength - s_minMatchLength ) : 0;
+		uint8_t* const token = o_output++;
+		*token = static_cast<uint8_t>( ( std::min<size_t>( i_literalCount, s_maxTokenLength ) << 4 )
+			| std::min<size_t>( matchLength_token, s_maxTokenLength ) );
+		if ( i_literalCount >= s_maxTokenLength )
+		{
+			o_output = WriteMoreLength( i_literalCount - s_maxTokenLength, o_output );
+		}
+		std::memcpy( o_output, i_literals, i_literalCount );
+		o_output += i_literalCount;
+		if ( hasMatch )
+		{
+			*o_output++ = static_cast<uint8_t>( i_offset & 0xff );
+			*o_output++ = static_cast<uint8_t>( i_offset >> 8 );
+			if ( matchLength_token >= s_maxTokenLength )
+			{
+				o_output = WriteMoreLength( matchLength_token - s_maxTokenLength, o_output );
+			}
+		}
+		return o_output;
+	}
+
+	uint8_t* WriteMoreLength( size_t i_length, uint8_t* o_output )
+	{
+		while ( i_length >= 255 )
+		{
+			*o_output++ = 255;
+			i_length -= 255;
+		}
+		*o_output++ = static_cast<uint8_t>( i_length );
+		return o_output;
+	}
+
+	bool ReadMoreLength( const uint8_t*& io_input, const uint8_t* const i_inputEnd, size_t& io_length )
+	{
+		uint8_t byte;
+		do
+		{
+			if ( io_input == i_inputEnd )
+			{
+				return false;
+			}
+			byte = *io_input++;
+			io_length += byte;
+		} while ( byte == 255 );
+		return true;
+	}
+
+	uint32_t Read32( const uint8_t* const i_bytes )
+	{
+		uint32_t bytes;
+		std::memcpy( &bytes, i_bytes, sizeof( bytes ) );
+		return bytes;
+	}
+
+	uint32_t Hash( const uint32_t i_bytes )
+	{
+		return ( i_bytes * 2654435761u ) >> ( 32 - s_hashBitCount );
+	}
+
+	void SetErrorMessage( const char* const i_reason, std::string* o_errorMessage )
+	{
+		if ( o_errorMessage )
+		{
+			*o_errorMessage = i_reason;
+		}
+	}
+}
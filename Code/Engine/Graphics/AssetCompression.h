@@ -0,0 +1,83 @@
+/*
+	These functions compress built assets into chunks and decompress them again
+
+	The codec is a byte-oriented LZ77 in the style of LZ4:
+	a chunk is a list of sequences, each of which is some literal bytes that are copied as they are
+	followed by a match that copies bytes from earlier in the same chunk.
+	There is no entropy coding and so it doesn't compress as well as zlib does, but it decompresses many times faster.
+	A compressed asset looks like this:
+		[sHeader][uint32_t compressed chunk size * chunkCount][chunks]
+	Every chunk but the last decompresses to exactly chunkSize bytes, and no chunk refers to another one,
+	and so the chunks of a large asset can all be decompressed at the same time, each straight into its own part of the output.
+	A chunk that wouldn't get any smaller is stored as it is
+	(and its compressed size is then the same as its decompressed size).
+
+	The loaders don't need to know about any of this,
+	because cMappedFile::Decompress() replaces a compressed file's contents with the decompressed ones
+*/
+
+#ifndef EAE6320_GRAPHICS_ASSETCOMPRESSION_H
+#define EAE6320_GRAPHICS_ASSETCOMPRESSION_H
+
+// Header Files
+//=============
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		namespace AssetCompression
+		{
+			// File Format
+			//------------
+
+			struct sHeader
+			{
+				uint32_t magic;
+				uint32_t version;
+				uint64_t uncompressedSize;
+				uint32_t chunkSize;
+				uint32_t chunkCount;
+			};
+			// "EACZ"
+			const uint32_t s_magic = 0x5a434145;
+			const uint32_t s_version = 1;
+			// Matches can only reach 64 KB back, and so a chunk can't be any bigger than this
+			const uint32_t s_maxChunkSize = 64 * 1024;
+
+			// Compression
+			//------------
+
+			// The compressed asset can be bigger than the uncompressed one if it doesn't compress well
+			// (the builders then keep the uncompressed one)
+			void Compress( const uint8_t* const i_contents, const size_t i_size, std::vector<uint8_t>& o_compressed,
+				const uint32_t i_chunkSize = s_maxChunkSize );
+
+			// Decompression
+			//--------------
+
+			// This only looks at the magic number
+			bool IsCompressed( const uint8_t* const i_contents, const size_t i_size );
+			// Checks that the header and the chunk table agree with each other and with the size of the compressed asset
+			// and finds where every chunk starts (o_chunkOffsets has one more entry than there are chunks, which is where the last one ends).
+			// If this returns false then o_errorMessage says why
+			bool ReadChunkTable( const uint8_t* const i_compressed, const size_t i_size,
+				sHeader& o_header, std::vector<size_t>& o_chunkOffsets, std::string* o_errorMessage = NULL );
+			// Decompresses one chunk into its part of o_contents (which must have room for the whole uncompressed asset).
+			// Different chunks can be decompressed on different threads at the same time.
+			// This returns false if the chunk is corrupt, and it never reads or writes outside of the chunk
+			bool DecompressChunk( const uint8_t* const i_compressed, const sHeader& i_header, const std::vector<size_t>& i_chunkOffsets,
+				const uint32_t i_chunkIndex, uint8_t* const o_contents );
+		}
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_ASSETCOMPRESSION_H
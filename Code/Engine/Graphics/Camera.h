@@ -26,6 +26,8 @@ namespace eae6320
 			eae6320::Math::cQuaternion m_orientation;
 			eae6320::Math::cVector m_offset = eae6320::Math::cVector(0.0f, 0.0f, 10.0f);
 			float FOV = eae6320::Math::ConvertDegreesToRadians(60.0f);
+			float m_nearPlane = 0.1f;
+			float m_farPlane = 100.0f;
 
 		private:
 			// C++ 11
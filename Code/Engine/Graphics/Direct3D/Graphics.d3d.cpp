@@ -3,6 +3,7 @@
 
 #include "../Graphics.h"
 #include "../Renderable.h"
+#include "../cMappedFile.h"
 
 #include <cassert>
 #include <cstdint>
@@ -28,6 +29,25 @@ namespace
 	
 	eae6320::Graphics::Effect *s_effect;
 
+	// Direct3D 9 already filters redundant render state changes itself (unless the device is pure),
+	// so only draw calls, texture binds and material constants are counted here
+	eae6320::Graphics::sFrameStatistics s_frameStatistics;
+
+	// Direct3D 9 has no constant buffers, so the per-frame transforms are set
+	// whenever a different vertex shader is bound
+	// (the constant registers are shared by every shader, so they can't be trusted after a switch)
+	eae6320::Graphics::sViewConstants s_viewConstants;
+	IDirect3DVertexShader9* s_boundVertexShader = NULL;
+	// The material constants are ordinary uniforms for the same reason,
+	// so they are set whenever a different material is bound
+	// (this is forgotten every frame so that a new material can never be mistaken for a freed one)
+	const eae6320::Graphics::Material* s_boundMaterial = NULL;
+
+	// The texture bound to each of the pixel shader's samplers
+	// (Direct3D 9 has 16 of them, and a material's unit is its sampler's register)
+	const DWORD s_samplerCount = 16;
+	IDirect3DBaseTexture9* s_boundTextures[s_samplerCount] = { NULL };
+
 	// This struct determines the layout of the data that the CPU will send to the GPU
 	//IDirect3DVertexDeclaration9* s_vertexDeclaration = NULL;
 
@@ -103,38 +123,7 @@ OnError:
 	return false;
 }
 
-void eae6320::Graphics::AddRenderable(const char* const i_pathMesh, const char* const i_pathMaterial, eae6320::Graphics::Renderable *i_renderable)
-{
-	
-	LoadMesh(i_pathMesh, i_renderable->m_mesh);
-	LoadMaterial(i_pathMaterial, i_renderable->m_material);
-	//LoadEffect(i_pathEffect, i_renderable->m_effect);
-	std::vector<eae6320::Graphics::Renderable*>* m_renderableList;
-	if(i_renderable->m_material.m_effect.m_renderStates & alpha)
-		m_renderableList = GetTransparentRenderableList();
-	else
-		m_renderableList = GetOpaqueRenderableList();
-	m_renderableList->push_back(i_renderable);
-}
-
-void eae6320::Graphics::RemoveRenderable(eae6320::Graphics::Renderable *i_renderable)
-{
-	std::vector<eae6320::Graphics::Renderable*>* m_renderableList;
-	if (i_renderable->m_material.m_effect.m_renderStates & alpha)
-		m_renderableList = GetTransparentRenderableList();
-	else
-		m_renderableList = GetOpaqueRenderableList();
-	for (std::vector<eae6320::Graphics::Renderable*>::iterator i = m_renderableList->begin(); i < m_renderableList->end(); ++i)
-	{
-		if (*(i) == i_renderable)
-		{
-			m_renderableList->erase(i);
-			break;
-		}
-	}
-}
-
-bool eae6320::Graphics::CreateBuffers(sVertex*& i_vertexData, int i_numOfVertices, uint32_t*& i_indexData, int i_numOfIndices, Mesh& i_mesh)
+bool eae6320::Graphics::CreateBuffers(const uint8_t* const i_vertexData, int i_numOfVertices, const uint32_t* const i_indexData, int i_numOfIndices, Mesh& i_mesh)
 {
 	{//Creating Index Buffer
 	// The usage tells Direct3D how this vertex buffer will be used
@@ -228,7 +217,7 @@ bool eae6320::Graphics::CreateBuffers(sVertex*& i_vertexData, int i_numOfVertice
 
 		// Initialize the vertex format
 		{
-			// These elements must match the VertexFormat::sVertex layout struct exactly.
+			// These elements must match the sVertex (or sVertex_quantized) layout struct exactly.
 			// They instruct Direct3D how to match the binary data in the vertex buffer
 			// to the input elements in a vertex shader
 			// (by using D3DDECLUSAGE enums here and semantics in the shader,
@@ -256,7 +245,40 @@ bool eae6320::Graphics::CreateBuffers(sVertex*& i_vertexData, int i_numOfVertice
 				// The following marker signals the end of the vertex declaration
 				D3DDECL_END()
 			};
-			HRESULT result = s_direct3dDevice->CreateVertexDeclaration(vertexElements, &(i_mesh.m_vertexDeclaration));
+			// The quantized layout must match sVertex_quantized instead
+			// (the shader still sees floats; the normalized types are expanded to [0,1] by the hardware
+			// and the draw call's transform moves the positions back into local space)
+			D3DVERTEXELEMENT9 vertexElements_quantized[] =
+			{
+				// Stream 0
+
+				// POSITION
+				// 4 uint16_ts == 8 bytes
+				// Offset = 0
+				{ 0, 0, D3DDECLTYPE_USHORT4N, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_POSITION, 0 },
+
+				// TEXTURE COORDINATES
+				// 2 uint16_ts == 4 bytes
+				// Offset = 8
+				{ 0, 8, D3DDECLTYPE_USHORT2N, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_TEXCOORD, 0 },
+
+				// COLOR0
+				// D3DCOLOR == 4 bytes
+				// Offset = 12
+				{ 0, 12, D3DDECLTYPE_D3DCOLOR, D3DDECLMETHOD_DEFAULT, D3DDECLUSAGE_COLOR, 0 },
+
+				// The following marker signals the end of the vertex declaration
+				D3DDECL_END()
+			};
+			// Direct3D 9 has no default value for an input that the declaration leaves out,
+			// so the MeshBuilder always keeps the color for this platform
+			if (i_mesh.m_vertexFormat == quantizedVerticesNoColor)
+			{
+				eae6320::UserOutput::Print("Direct3D meshes must have a color in every vertex");
+				return false;
+			}
+			HRESULT result = s_direct3dDevice->CreateVertexDeclaration(
+				(i_mesh.m_vertexFormat == floatVertices) ? vertexElements : vertexElements_quantized, &(i_mesh.m_vertexDeclaration));
 			if (SUCCEEDED(result))
 			{
 				result = s_direct3dDevice->SetVertexDeclaration(i_mesh.m_vertexDeclaration);
@@ -277,7 +299,7 @@ bool eae6320::Graphics::CreateBuffers(sVertex*& i_vertexData, int i_numOfVertice
 		{
 			// We are drawing one square
 			//const unsigned int vertexCount = i_numOfVertices;	// What is the minimum number of vertices a square needs (so that no data is duplicated)?
-			const unsigned int bufferSize = i_mesh.m_noOfIndices * sizeof(sVertex);
+			const unsigned int bufferSize = static_cast<unsigned int>(i_mesh.m_noOfVertices * GetVertexStride(i_mesh.m_vertexFormat));
 			// We will define our own vertex format
 			const DWORD useSeparateVertexDeclaration = 0;
 			// Place the vertex buffer into memory that Direct3D thinks is the most appropriate
@@ -294,7 +316,7 @@ bool eae6320::Graphics::CreateBuffers(sVertex*& i_vertexData, int i_numOfVertice
 		// Fill the vertex buffer with the triangle's vertices
 		{
 			// Before the vertex buffer can be changed it must be "locked"
-			sVertex* vertexData;
+			uint8_t* vertexData;
 			{
 				const unsigned int lockEntireBuffer = 0;
 				const DWORD useDefaultLockingBehavior = 0;
@@ -324,7 +346,7 @@ bool eae6320::Graphics::CreateBuffers(sVertex*& i_vertexData, int i_numOfVertice
 				// To make pure red you would use the max for R and nothing for G and B, so (1, 0, 0).
 				// Experiment with other values to see what happens!
 
-				std::memcpy(vertexData, i_vertexData, (i_mesh.m_noOfVertices * sizeof(sVertex)));
+				std::memcpy(vertexData, i_vertexData, (i_mesh.m_noOfVertices * GetVertexStride(i_mesh.m_vertexFormat)));
 			}
 			// The buffer must be "unlocked" before it can be used
 			{
@@ -341,6 +363,25 @@ bool eae6320::Graphics::CreateBuffers(sVertex*& i_vertexData, int i_numOfVertice
 	return true;
 }
 
+void eae6320::Graphics::DestroyBuffers(Mesh& io_mesh)
+{
+	if (io_mesh.m_indexBuffer)
+	{
+		io_mesh.m_indexBuffer->Release();
+		io_mesh.m_indexBuffer = NULL;
+	}
+	if (io_mesh.m_vertexBuffer)
+	{
+		io_mesh.m_vertexBuffer->Release();
+		io_mesh.m_vertexBuffer = NULL;
+	}
+	if (io_mesh.m_vertexDeclaration)
+	{
+		io_mesh.m_vertexDeclaration->Release();
+		io_mesh.m_vertexDeclaration = NULL;
+	}
+}
+
 bool eae6320::Graphics::LoadEffect(const char* const i_effectPath, Effect& i_effect)
 {
 	bool wereThereErrors = false;
@@ -486,10 +527,15 @@ bool eae6320::Graphics::LoadEffect(const char* const i_effectPath, Effect& i_eff
 	//Getting Handle from ConstantTable
 	{
 		//i_effect.vhandle = i_effect.vertexShaderConstantTable->GetConstantByName(NULL, "g_position_offset");
+		i_effect.localToProjected = i_effect.vertexShaderConstantTable->GetConstantByName(NULL, "g_transform_localToProjected");
 		i_effect.localToWorld = i_effect.vertexShaderConstantTable->GetConstantByName(NULL, "g_transform_localToWorld");
 		i_effect.worldToView = i_effect.vertexShaderConstantTable->GetConstantByName(NULL, "g_transform_worldToView");
 		i_effect.viewToScreen = i_effect.vertexShaderConstantTable->GetConstantByName(NULL, "g_transform_viewToScreen");
-		if (i_effect.localToWorld == NULL || i_effect.worldToView == NULL || i_effect.viewToScreen== NULL)
+		i_effect.worldToProjected = i_effect.vertexShaderConstantTable->GetConstantByName(NULL, "g_transform_worldToProjected");
+		//A shader must either use the single precomputed transform or localToWorld and the per-frame ones.
+		const bool usesSeparateTransforms = i_effect.localToWorld != NULL &&
+			(i_effect.worldToProjected != NULL || (i_effect.worldToView != NULL && i_effect.viewToScreen != NULL));
+		if (i_effect.localToProjected == NULL && !usesSeparateTransforms)
 		{
 			eae6320::UserOutput::Print("Direct3D failed to get handle from constant table");
 			wereThereErrors = true;
@@ -517,8 +563,44 @@ OnExit:
 	return !wereThereErrors;
 }
 
+void eae6320::Graphics::DestroyEffect(Effect& io_effect)
+{
+	//A different shader could be created at the same address
+	if (s_boundVertexShader == io_effect.m_vertexShader)
+	{
+		s_boundVertexShader = NULL;
+	}
+	if (io_effect.m_vertexShader)
+	{
+		io_effect.m_vertexShader->Release();
+		io_effect.m_vertexShader = NULL;
+	}
+	if (io_effect.m_pixelShader)
+	{
+		io_effect.m_pixelShader->Release();
+		io_effect.m_pixelShader = NULL;
+	}
+	if (io_effect.vertexShaderConstantTable)
+	{
+		io_effect.vertexShaderConstantTable->Release();
+		io_effect.vertexShaderConstantTable = NULL;
+	}
+	if (io_effect.fragmentShaderConstantTable)
+	{
+		io_effect.fragmentShaderConstantTable->Release();
+		io_effect.fragmentShaderConstantTable = NULL;
+	}
+}
+
 bool eae6320::Graphics::LoadTexture(const char* const i_path, Material& i_material)
 {
+	//D3DX reads the texture straight out of the mapped file
+	cMappedFile file;
+	if (!OpenAssetFile(i_path, file))
+	{
+		i_material.m_3dTexture = NULL;
+		return false;
+	}
 	const unsigned int useDimensionsFromFile = D3DX_DEFAULT_NONPOW2;
 	const unsigned int useMipMapsFromFile = D3DX_FROM_FILE;
 	const DWORD staticTexture = 0;
@@ -528,13 +610,38 @@ bool eae6320::Graphics::LoadTexture(const char* const i_path, Material& i_materi
 	const D3DCOLOR noColorKey = 0;
 	D3DXIMAGE_INFO* noSourceInfo = NULL;
 	PALETTEENTRY* noColorPalette = NULL;
-	const HRESULT result = D3DXCreateTextureFromFileEx(s_direct3dDevice, i_path, useDimensionsFromFile, useDimensionsFromFile, useMipMapsFromFile,
+	const HRESULT result = D3DXCreateTextureFromFileInMemoryEx(s_direct3dDevice, file.GetContents(), static_cast<UINT>(file.GetSize()),
+		useDimensionsFromFile, useDimensionsFromFile, useMipMapsFromFile,
 		staticTexture, useFormatFromFile, letD3dManageMemory, useDefaultFiltering, useDefaultFiltering, noColorKey, noSourceInfo, noColorPalette,
 		&(i_material.m_3dTexture));
+	if (FAILED(result))
+	{
+		std::stringstream errorMessage;
+		errorMessage << "Direct3D failed to create the texture " << i_path;
+		eae6320::UserOutput::Print(errorMessage.str());
+		i_material.m_3dTexture = NULL;
+		return false;
+	}
 
 	return true;
 }
 
+void eae6320::Graphics::DestroyTexture(Material& io_material)
+{
+	if (io_material.m_3dTexture)
+	{
+		for (DWORD i = 0; i < s_samplerCount; ++i)
+		{
+			if (s_boundTextures[i] == io_material.m_3dTexture)
+			{
+				s_boundTextures[i] = NULL;
+			}
+		}
+		io_material.m_3dTexture->Release();
+		io_material.m_3dTexture = NULL;
+	}
+}
+
 eae6320::Graphics::tUniformHandle eae6320::Graphics::GetUniform(Effect& i_effect, const char* const i_uniformName, eShaderType i_shaderType)
 {
 	if (i_shaderType == eShaderType::fragment)
@@ -560,8 +667,15 @@ void eae6320::Graphics::Clear()
 	assert(SUCCEEDED(result));
 }
 
+const eae6320::Graphics::sFrameStatistics& eae6320::Graphics::GetFrameStatistics()
+{
+	return s_frameStatistics;
+}
+
 void eae6320::Graphics::BeginScene()
 {
+	s_frameStatistics = sFrameStatistics();
+	s_boundMaterial = NULL;
 	HRESULT result = s_direct3dDevice->BeginScene();
 	assert(SUCCEEDED(result));
 }
@@ -582,17 +696,61 @@ void eae6320::Graphics::SwapBuffers()
 	assert(SUCCEEDED(result));
 }
 
+bool eae6320::Graphics::MakeContextCurrent()
+{
+	//A Direct3D 9 device isn't tied to a thread;
+	//without D3DCREATE_MULTITHREADED it only mustn't be used by two threads at once, which the render thread guarantees
+	return true;
+}
+
+void eae6320::Graphics::ReleaseContext()
+{
+
+}
+
+bool eae6320::Graphics::ApplyErrorCheckMode(const eErrorCheckMode i_mode)
+{
+	//Every Direct3D call returns its own HRESULT, which is already asserted,
+	//and so there is nothing else to look for
+	return i_mode == errorChecksOff;
+}
+
+eae6320::Graphics::eErrorCheckMode eae6320::Graphics::GetErrorCheckMode()
+{
+	return errorChecksOff;
+}
+
 bool eae6320::Graphics::LoadSamplerID(const char* const i_uniformName, Material& i_material)
 {
 	D3DXHANDLE m_handle = i_material.m_effect.fragmentShaderConstantTable->GetConstantByName(NULL, i_uniformName);
 	i_material.m_texHandle = static_cast<DWORD>(i_material.m_effect.fragmentShaderConstantTable->GetSamplerIndex(m_handle));
 
+	//The shader compiler has already decided which register each sampler uses.
+	if (i_material.m_texHandle >= s_samplerCount)
+	{
+		std::stringstream errorMessage;
+		errorMessage << "The sampler " << i_uniformName << " doesn't use one of the " << s_samplerCount << " Direct3D samplers";
+		eae6320::UserOutput::Print(errorMessage.str());
+		return false;
+	}
+	i_material.m_textureUnit = static_cast<uint8_t>(i_material.m_texHandle);
+
 	return true;
 }
 
-bool eae6320::Graphics::SetTexture(Material& i_material, int i_offset)
+bool eae6320::Graphics::SetTexture(Material& i_material)
 {
-	s_direct3dDevice->SetTexture(i_material.m_texHandle, i_material.m_3dTexture);
+	if (s_boundTextures[i_material.m_textureUnit] == i_material.m_3dTexture)
+	{
+		++s_frameStatistics.redundantStateChanges;
+		++s_frameStatistics.redundantTextureBinds;
+		return true;
+	}
+	HRESULT result = s_direct3dDevice->SetTexture(i_material.m_textureUnit, i_material.m_3dTexture);
+	assert(SUCCEEDED(result));
+	s_boundTextures[i_material.m_textureUnit] = i_material.m_3dTexture;
+	++s_frameStatistics.stateChanges;
+	++s_frameStatistics.textureBinds;
 
 	return true;
 }
@@ -606,7 +764,7 @@ void eae6320::Graphics::DrawMesh(const eae6320::Graphics::Mesh& i_Mesh)
 		// It's possible to start streaming data in the middle of a vertex buffer
 		const unsigned int bufferOffset = 0;
 		// The "stride" defines how large a single vertex is in the stream of data
-		const unsigned int bufferStride = sizeof(sVertex);
+		const unsigned int bufferStride = static_cast<unsigned int>(GetVertexStride(i_Mesh.m_vertexFormat));
 		HRESULT result = s_direct3dDevice->SetStreamSource(streamIndex, i_Mesh.m_vertexBuffer, bufferOffset, bufferStride);
 		assert(SUCCEEDED(result));
 
@@ -632,22 +790,47 @@ void eae6320::Graphics::DrawMesh(const eae6320::Graphics::Mesh& i_Mesh)
 			indexOfFirstVertexToRender, indexOfFirstVertexToRender, vertexCountToRender,
 			indexOfFirstIndexToUse, primitiveCountToRender);
 		assert(SUCCEEDED(result));
+		++s_frameStatistics.drawCalls;
 	}
 }
 
+void eae6320::Graphics::DrawMeshInstanced(const Mesh&, const size_t, const size_t)
+{
+	//Effect::m_isInstanced is never set on this platform (see SetInstanceTransforms())
+	assert(false);
+}
+
+void eae6320::Graphics::SetViewConstants(const sViewConstants& i_viewConstants)
+{
+	s_viewConstants = i_viewConstants;
+	//Every shader has to get the new values the next time it is bound
+	s_boundVertexShader = NULL;
+}
+
+void eae6320::Graphics::SetInstanceTransforms(const eae6320::Math::cMatrix_transformation* const, const size_t)
+{
+	//Direct3D 9 instancing needs shader model 3 and a second vertex stream,
+	//so no Direct3D effect is ever instanced and there is nothing to store.
+}
+
 bool eae6320::Graphics::SetDrawCallUniforms(Effect& i_effect, eae6320::Math::cMatrix_transformation& i_offsetMatrix)
 {
 	HRESULT result;
-	result = i_effect.vertexShaderConstantTable->SetMatrixTranspose(s_direct3dDevice, i_effect.localToWorld, reinterpret_cast<const D3DXMATRIX*>(&i_offsetMatrix));
-	assert(SUCCEEDED(result));
-
-	eae6320::Math::cMatrix_transformation worldToView = eae6320::Math::cMatrix_transformation::CreateWorldToViewTransform(Camera::getInstance().m_orientation, Camera::getInstance().m_offset);
-	result = i_effect.vertexShaderConstantTable->SetMatrixTranspose(s_direct3dDevice, i_effect.worldToView, reinterpret_cast<const D3DXMATRIX*>(&worldToView));
-	assert(SUCCEEDED(result));
 
-	eae6320::Math::cMatrix_transformation viewToScreen = eae6320::Math::cMatrix_transformation::CreateViewToScreenTransform(Camera::getInstance().FOV, getAspectRatio(), 0.1f, 100.0f);
-	result = i_effect.vertexShaderConstantTable->SetMatrixTranspose(s_direct3dDevice, i_effect.viewToScreen, reinterpret_cast<const D3DXMATRIX*>(&viewToScreen));
-	assert(SUCCEEDED(result));
+	if (i_effect.localToProjected != NULL)
+	{
+		//Concatenating once here saves two matrix multiplies per vertex and two uploads per draw,
+		//and worldToProjected was already concatenated for the whole frame.
+		eae6320::Math::cMatrix_transformation localToProjected = i_offsetMatrix * s_viewConstants.worldToProjected;
+		result = i_effect.vertexShaderConstantTable->SetMatrixTranspose(s_direct3dDevice, i_effect.localToProjected, reinterpret_cast<const D3DXMATRIX*>(&localToProjected));
+		assert(SUCCEEDED(result));
+	}
+	else
+	{
+		//The rest of the transforms were set by BindEffect().
+		result = i_effect.vertexShaderConstantTable->SetMatrixTranspose(s_direct3dDevice, i_effect.localToWorld, reinterpret_cast<const D3DXMATRIX*>(&i_offsetMatrix));
+		assert(SUCCEEDED(result));
+	}
 
 	return true;
 }
@@ -658,6 +841,41 @@ void eae6320::Graphics::SetMaterialUniform(const Effect& i_effect, float i_value
 		i_effect.fragmentShaderConstantTable->SetFloatArray(s_direct3dDevice, i_uniformHandle, i_values, i_valueCountToSet);
 	else
 		i_effect.vertexShaderConstantTable->SetFloatArray(s_direct3dDevice, i_uniformHandle, i_values, i_valueCountToSet);
+	++s_frameStatistics.stateChanges;
+}
+
+bool eae6320::Graphics::CreateMaterialConstants(Material& io_material, const char* const* const i_uniformNames)
+{
+	//Direct3D 9 has no constant buffers, so the baked block is only used to keep the values
+	//and each uniform is still set through its shader's constant table.
+	for (uint8_t i = 0; i < io_material.m_noOfUniforms; i++)
+	{
+		io_material.m_uniforms[i].uniformHandle = GetUniform(io_material.m_effect, i_uniformNames[i], io_material.m_uniforms[i].shaderType);
+	}
+	*io_material.m_areConstantsDirty = false;
+	return true;
+}
+
+void eae6320::Graphics::DestroyMaterialConstants(Material&)
+{
+	//The uniforms are set through the effect's constant tables, and so there is nothing to destroy
+	//(s_boundMaterial is forgotten every frame, and so it can't refer to a material that no longer exists)
+}
+
+void eae6320::Graphics::BindMaterialConstants(Material& io_material)
+{
+	if ((&io_material == s_boundMaterial) && !*io_material.m_areConstantsDirty)
+	{
+		++s_frameStatistics.redundantStateChanges;
+		return;
+	}
+	for (uint8_t i = 0; i < io_material.m_noOfUniforms; i++)
+	{
+		sUniformHelper& uniform = io_material.m_uniforms[i];
+		SetMaterialUniform(io_material.m_effect, uniform.values, uniform.valueCountToSet, uniform.uniformHandle, uniform.shaderType);
+	}
+	s_boundMaterial = &io_material;
+	*io_material.m_areConstantsDirty = false;
 }
 
 bool eae6320::Graphics::BindEffect(Effect& i_effect)
@@ -668,6 +886,28 @@ bool eae6320::Graphics::BindEffect(Effect& i_effect)
 	result = s_direct3dDevice->SetPixelShader(i_effect.m_pixelShader);
 	assert(SUCCEEDED(result));
 
+	//Set the per-frame transforms (once per shader switch rather than once per draw).
+	if (i_effect.m_vertexShader != s_boundVertexShader)
+	{
+		ID3DXConstantTable* const constantTable = i_effect.vertexShaderConstantTable;
+		if (i_effect.worldToView != NULL)
+		{
+			result = constantTable->SetMatrixTranspose(s_direct3dDevice, i_effect.worldToView, reinterpret_cast<const D3DXMATRIX*>(&s_viewConstants.worldToView));
+			assert(SUCCEEDED(result));
+		}
+		if (i_effect.viewToScreen != NULL)
+		{
+			result = constantTable->SetMatrixTranspose(s_direct3dDevice, i_effect.viewToScreen, reinterpret_cast<const D3DXMATRIX*>(&s_viewConstants.viewToScreen));
+			assert(SUCCEEDED(result));
+		}
+		if (i_effect.worldToProjected != NULL)
+		{
+			result = constantTable->SetMatrixTranspose(s_direct3dDevice, i_effect.worldToProjected, reinterpret_cast<const D3DXMATRIX*>(&s_viewConstants.worldToProjected));
+			assert(SUCCEEDED(result));
+		}
+		s_boundVertexShader = i_effect.m_vertexShader;
+	}
+
 	//Set Alpha rendering state.
 	if (i_effect.m_renderStates & alpha)
 	{
@@ -728,36 +968,21 @@ bool eae6320::Graphics::BindEffect(Effect& i_effect)
 bool eae6320::Graphics::ShutDown()
 {
 	bool wereThereErrors = false;
+	StopWorkerThreads();
 	if ( s_direct3dInterface )
 	{
 		if ( s_direct3dDevice )
 		{
-			std::vector<eae6320::Graphics::Renderable*>* m_renderableList = GetOpaqueRenderableList();
-			size_t size = m_renderableList->size();
-			for (unsigned int i = 0; i < size; i++)
-			{
-				(*m_renderableList)[i]->m_mesh.m_indexBuffer->Release();
-				(*m_renderableList)[i]->m_mesh.m_vertexBuffer->Release();
-				(*m_renderableList)[i]->m_mesh.m_vertexDeclaration->Release();
-
-				(*m_renderableList)[i]->m_material.m_effect.m_vertexShader->Release();
-				(*m_renderableList)[i]->m_material.m_effect.m_pixelShader->Release();
-			}
-			m_renderableList = GetTransparentRenderableList();
-			size = m_renderableList->size();
-			for (unsigned int i = 0; i < size; i++)
-			{
-				(*m_renderableList)[i]->m_mesh.m_indexBuffer->Release();
-				(*m_renderableList)[i]->m_mesh.m_vertexBuffer->Release();
-				(*m_renderableList)[i]->m_mesh.m_vertexDeclaration->Release();
-
-				(*m_renderableList)[i]->m_material.m_effect.m_vertexShader->Release();
-				(*m_renderableList)[i]->m_material.m_effect.m_pixelShader->Release();
-			}
+			//Assets can be shared by several renderables, and so they are destroyed through the cache that shares them
+			UnloadAllAssets();
 
 			s_direct3dDevice->SetVertexDeclaration(NULL);
 			s_direct3dDevice->Release();
 			s_direct3dDevice = NULL;
+			for (DWORD i = 0; i < s_samplerCount; ++i)
+			{
+				s_boundTextures[i] = NULL;
+			}
 		}
 
 		s_direct3dInterface->Release();
@@ -4,116 +4,438 @@
 #include "Graphics.h"
 #include "../../External/Lua/Includes.h"
 #include "../UserOutput/UserOutput.h"
+#include "AssetCompression.h"
 #include "Renderable.h"
+#include "cAssetPack.h"
+#include "cAssetStreamer.h"
+#include "cCommandBuffer.h"
+#include "cMappedFile.h"
+#include "cRenderQueue.h"
+#include "cWorkerPool.h"
+#include "../Core/Math/cFrustum.h"
 #include "../Core/Math/cMatrix_transformation.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <cassert>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <sstream>
+#include <string>
 #include <sys/stat.h>
+#include <thread>
+#include <utility>
 #include <vector>
 
 //Static Data Initialization
 //==========================
 namespace
 {
-	std::vector<eae6320::Graphics::Renderable*> s_opaqueRenderableList;
-	std::vector<eae6320::Graphics::Renderable*> s_transparentRenderableList;
+	// The render thread appends streamed renderables to this between frames,
+	// and so the game thread only reads it with s_uploadMutex locked (see UploadQueuedLoads())
+	std::vector<eae6320::Graphics::Renderable*> s_renderableList;
+
+	// Everything that the per-frame passes (culling, sorting and building draw runs) need to know about a renderable
+	// is copied into a small packet when it is added,
+	// so that those passes can walk one dense array instead of following a pointer to every Renderable.
+	// s_drawPackets[i] always describes s_renderableList[i];
+	// the Renderable itself is only read for its transform and when it is actually drawn
+	struct sDrawPacket
+	{
+		// The mesh's bounding sphere in local space
+		float sphereCenter[3];
+		float sphereRadius;
+		uint16_t effectSortId;
+		uint16_t materialSortId;
+		uint16_t meshSortId;
+		uint8_t flags;
+	};
+	enum eDrawPacketFlags : uint8_t
+	{
+		isTransparent = 1,
+		isInstanced = 1 << 1,
+		isQuantized = 1 << 2,
+	};
+	std::vector<sDrawPacket> s_drawPackets;
+	eae6320::Graphics::cRenderQueue s_renderQueue;
+
+	// Each asset path gets a small ID the first time it is loaded
+	// so that the render queue can group draws that share it
+	std::map<std::string, uint16_t> s_effectSortIds;
+	std::map<std::string, uint16_t> s_materialSortIds;
+	std::map<std::string, uint16_t> s_meshSortIds;
+
+	// Every asset is only loaded once and is then shared by everything that loads it again.
+	// Meshes, effects and materials are found by their sort IDs (which are given out per path) and textures by their paths,
+	// and a cached asset is copied into whatever loads it (the copies all refer to the same graphics objects).
+	// An asset is only destroyed once its last reference is released
+	template<typename tAsset>
+	struct sCachedAsset
+	{
+		tAsset asset;
+		uint32_t referenceCount;
+		uint64_t byteCount;
+	};
+	struct sCachedMaterial : sCachedAsset<eae6320::Graphics::Material>
+	{
+		// The material holds a reference to its effect and texture if they loaded
+		bool hasEffect;
+		std::string texturePath;
+	};
+	typedef decltype( eae6320::Graphics::Material::m_3dTexture ) tTexture;
+	std::map<uint16_t, sCachedAsset<eae6320::Graphics::Mesh>> s_cachedMeshes;
+	std::map<uint16_t, sCachedAsset<eae6320::Graphics::Effect>> s_cachedEffects;
+	std::map<uint16_t, sCachedMaterial> s_cachedMaterials;
+	std::map<std::string, sCachedAsset<tTexture>> s_cachedTextures;
+	eae6320::Graphics::sAssetCacheStatistics s_assetCacheStatistics[eae6320::Graphics::assetTypeCount];
+
+	eae6320::Graphics::sLoadStatistics s_loadStatistics;
+	// The size of every file's contents once they were opened (and decompressed),
+	// which is how much memory the effect and texture files are counted as using
+	uint64_t s_openedContentBytes = 0;
+	bool s_shouldReadAssetFilesIntoMemory = false;
+	// This is declared before the streamer so that it is closed after the streaming thread has stopped
+	eae6320::Graphics::cAssetPack s_assetPack;
+
+	// Asynchronous loading (see AddRenderableAsync())
+	//-----------------------------------------------
+
+	eae6320::Graphics::cAssetStreamer s_assetStreamer;
+	// A load's state is kept until its handle is released (see ReleaseLoadHandle())
+	std::map<eae6320::Graphics::tLoadHandle, eae6320::Graphics::eLoadState> s_loadStates;
+	size_t s_maxStreamingUploadsPerFrame = 1;
+	eae6320::Graphics::sStreamingStatistics s_streamingStatistics;
+	// Loads whose files have been read wait here for the render thread to create their graphics objects,
+	// and the render thread hands back what happened to each of them so that the game thread can change its state
+	struct sUploadedLoad
+	{
+		eae6320::Graphics::tLoadHandle handle;
+		eae6320::Graphics::eLoadState state;
+	};
+	std::mutex s_uploadMutex;
+	std::vector<eae6320::Graphics::cAssetStreamer::sLoad*> s_loadsToUpload;
+	std::vector<sUploadedLoad> s_uploadedLoads;
+	// This is only changed with s_uploadMutex locked, but the render thread checks it without the lock
+	std::atomic<bool> s_areLoadsWaitingForUpload( false );
+	// While a streamed renderable's graphics objects are created OpenAssetFile() takes its files from here
+	std::vector<eae6320::Graphics::cAssetStreamer::sPreloadedFile>* s_preloadedFiles = NULL;
+
+	// Everything that a frame needs from the game is copied when Render() is called,
+	// so that the game can go on changing it while the frame is being rendered.
+	// The transforms are gathered into contiguous arrays (in the same order as s_renderableList)
+	// so that every matrix can be built with a single batch call
+	struct sFrameSnapshot
+	{
+		std::vector<eae6320::Math::cQuaternion> orientations;
+		std::vector<eae6320::Math::cVector> offsets;
+		eae6320::Math::cQuaternion cameraOrientation;
+		eae6320::Math::cVector cameraOffset;
+		float fieldOfView;
+		float nearPlane;
+		float farPlane;
+		std::chrono::steady_clock::time_point creationTime;
+	};
+	// While the render thread renders one of these the game thread fills the other
+	// (without the render thread only the first one is used)
+	sFrameSnapshot s_frameSnapshots[2];
+
+	// Scratch arrays that are reused every frame
+	std::vector<eae6320::Math::cMatrix_transformation> s_localToWorldTransforms;
+	// Only the visible instanced renderables' transforms are set
+	std::vector<eae6320::Math::cMatrix_transformation> s_localToProjectedTransforms;
+
+	// The world-space bounding spheres are stored as separate arrays
+	// so that the frustum can test several of them at once
+	std::vector<float> s_sphereCenters_x;
+	std::vector<float> s_sphereCenters_y;
+	std::vector<float> s_sphereCenters_z;
+	std::vector<float> s_sphereRadii;
+	std::vector<uint8_t> s_areVisible;
+
+	// The renderables are transformed, culled and keyed in chunks on the worker threads,
+	// and every chunk keys its visible draws into a list of its own.
+	// The lists are then queued in chunk order,
+	// and because the chunks don't depend on the thread count neither does the draw list.
+	// The size is a multiple of four so that the SIMD culling tests the same groups of spheres in every chunk
+	const size_t s_drawListChunkSize = 1024;
+	struct sDrawListChunk
+	{
+		std::vector<uint64_t> keys;
+		std::vector<uint32_t> drawIndices;
+	};
+	std::vector<sDrawListChunk> s_drawListChunks;
+	eae6320::Graphics::cWorkerPool s_workerPool;
+	// The pool is also used to decompress assets (see GetWorkerPool())
+	bool s_isWorkerPoolInitialized = false;
+
+	// A run is a span of the sorted render queue that is drawn with a single draw call
+	// (it is only ever longer than one draw for instanced effects)
+	struct sDrawRun
+	{
+		uint32_t firstDraw;
+		uint32_t drawCount;
+		// Where the run's transforms start in s_instanceTransforms
+		uint32_t firstInstance;
+	};
+	std::vector<sDrawRun> s_drawRuns;
+	std::vector<eae6320::Math::cMatrix_transformation> s_instanceTransforms;
+
+	// The frame is recorded into this and then executed
+	// (it is kept until the next frame so that what was submitted can be inspected)
+	eae6320::Graphics::cCommandBuffer s_commandBuffer;
+
+	// The render thread (see StartRenderThread())
+	//-------------------------------------------
+
+	std::thread s_renderThread;
+	// Snapshot #i is in s_frameSnapshots[i % 2].
+	// Only the game thread increments the published count and only the render thread increments the rendered count,
+	// and so handing a snapshot over doesn't need a lock
+	std::atomic<uint32_t> s_publishedSnapshotCount( 0 );
+	std::atomic<uint32_t> s_renderedSnapshotCount( 0 );
+	// Something that the game thread is waiting for the render thread to run between frames
+	std::atomic<const std::function<void()>*> s_renderThreadTask( NULL );
+	std::atomic<bool> s_shouldRenderThreadExit( false );
+	enum eRenderThreadState : uint8_t
+	{
+		starting,
+		running,
+		failedToStart,
+	};
+	std::atomic<uint8_t> s_renderThreadState( starting );
+	std::atomic<float> s_frameLatency( 0.0f );
+	// A thread that is waiting for the other one checks the atomics above a few times first,
+	// and then sleeps until the other thread changes one of them
+	// (so that neither thread uses a whole core while the game is paused or the other one is waiting for vsync)
+	const unsigned int s_spinCount = 64;
+	std::mutex s_renderThreadMutex;
+	// The render thread waits for a snapshot, a task, or to be told to exit
+	std::condition_variable s_renderThreadWorkAdded;
+	// The game thread waits for the render thread to start, to finish a snapshot, or to finish a task
+	std::condition_variable s_renderThreadWorkFinished;
 }
 
 // Helper Function Declarations
 //=============================
 
+namespace
+{
+	sDrawPacket CreateDrawPacket( const eae6320::Graphics::Renderable& i_renderable );
+	// The renderables and the camera are only read here, once per frame (and on the game thread)
+	void TakeSnapshot( const std::vector<eae6320::Graphics::Renderable*>& i_renderableList, sFrameSnapshot& o_snapshot );
+	// This does everything that Render() used to do, on whichever thread the context is current on
+	void RenderSnapshot( const sFrameSnapshot& i_snapshot );
+	eae6320::Graphics::sViewConstants CreateViewConstants( const sFrameSnapshot& i_snapshot );
+	// Transforms, culls and keys every renderable (on the worker threads) and fills the render queue
+	void FillRenderQueue( const std::vector<sDrawPacket>& i_drawPackets, const std::vector<eae6320::Graphics::Renderable*>& i_renderableList,
+		const sFrameSnapshot& i_snapshot, const eae6320::Graphics::sViewConstants& i_viewConstants, const eae6320::Math::cFrustum& i_frustum );
+	// These are the steps that FillRenderQueue() takes for each chunk of renderables [i_begin, i_end)
+	void CreateLocalToWorldTransforms( const sFrameSnapshot& i_snapshot, const size_t i_begin, const size_t i_end );
+	// This must be called after CreateLocalToWorldTransforms() for the same renderables
+	void CullRenderables( const std::vector<sDrawPacket>& i_drawPackets, const eae6320::Math::cFrustum& i_frustum,
+		const size_t i_begin, const size_t i_end );
+	// This must be called after CullRenderables() for the same renderables.
+	// It also creates the localToProjected transforms of the visible instanced renderables
+	void CreateSortKeys( const std::vector<sDrawPacket>& i_drawPackets, const std::vector<eae6320::Graphics::Renderable*>& i_renderableList,
+		const sFrameSnapshot& i_snapshot, const eae6320::Graphics::sViewConstants& i_viewConstants, const size_t i_begin, const size_t i_end,
+		sDrawListChunk& o_chunk );
+	// This must be called after the render queue has been sorted
+	void CreateDrawRuns( const std::vector<sDrawPacket>& i_drawPackets );
+	// This must be called after CreateDrawRuns()
+	void RecordDrawRuns( const std::vector<eae6320::Graphics::Renderable*>& i_renderableList, eae6320::Graphics::cCommandBuffer& o_commandBuffer );
+	uint16_t GetSortId( const char* const i_path, std::map<std::string, uint16_t>& io_sortIds );
+	// Returns false if the asset isn't loaded yet, and otherwise adds a reference to it and copies it to o_asset
+	template<typename tKey, typename tEntry, typename tAsset>
+	bool ShareCachedAsset( std::map<tKey, tEntry>& io_cache, const tKey& i_key, const eae6320::Graphics::eAssetType i_type, tAsset& o_asset );
+	// The new entry has one reference
+	template<typename tKey, typename tEntry, typename tAsset>
+	tEntry& CacheAsset( std::map<tKey, tEntry>& io_cache, const tKey& i_key, const eae6320::Graphics::eAssetType i_type,
+		const tAsset& i_asset, const uint64_t i_byteCount );
+	// Returns true if that was the last reference,
+	// in which case the entry has been removed from the cache and moved to o_entry so that its asset can be destroyed
+	template<typename tKey, typename tEntry>
+	bool ReleaseCachedAsset( std::map<tKey, tEntry>& io_cache, const tKey& i_key, const eae6320::Graphics::eAssetType i_type, tEntry& o_entry );
+	void ReleaseEffect( const uint16_t i_sortId );
+	void ReleaseTexture( const std::string& i_path );
+	// Destroys the material's constants (its effect and texture are released separately)
+	void DestroyMaterial( eae6320::Graphics::Material& io_material );
+	void ReleaseMaterialAssets( const bool i_hasEffect, const uint16_t i_effectSortId, const std::string& i_texturePath );
+	// Loads both of the renderable's assets or neither of them
+	bool LoadRenderable( const char* const i_meshPath, const char* const i_materialPath, eae6320::Graphics::Renderable& io_renderable );
+	// Queues the streamed renderables whose files have been read (no more than s_maxStreamingUploadsPerFrame of them)
+	// so that the render thread creates their graphics objects between frames,
+	// and changes the states of the loads that it has finished
+	void UploadStreamedRenderables();
+	// Creates the queued renderables' graphics objects and starts drawing them
+	// (on the render thread if it is running, and on the game thread if it isn't)
+	void UploadQueuedLoads();
+	// Changes the states of the loads that UploadQueuedLoads() has finished and returns how many there were
+	size_t PublishUploadedLoads();
+	// This must be called where the graphics objects are created so that no upload can be in progress
+	bool AreRenderablesBeingStreamed();
+	// A load whose handle has already been released is ignored
+	void SetLoadState( const eae6320::Graphics::tLoadHandle i_handle, const eae6320::Graphics::eLoadState i_state );
+
+	void RenderThreadMain();
+	// Runs the task on the render thread if it is running (and on the calling thread if it isn't)
+	// and waits for it to finish
+	void RunOnRenderThread( const std::function<void()>& i_task );
+	// The pool starts a thread per core the first time that it is used unless SetDrawListThreadCount() was called first
+	// (it belongs to whichever thread renders)
+	eae6320::Graphics::cWorkerPool& GetWorkerPool();
+	// Waits until the render thread has finished this many snapshots
+	void WaitForRenderedSnapshots( const uint32_t i_snapshotCount );
+	// Returns once i_isDone() is true (it is checked with s_renderThreadMutex locked once the thread starts to sleep)
+	template<typename tPredicate>
+	void WaitForRenderThreadCondition( std::condition_variable& io_condition, const tPredicate& i_isDone );
+	// This must be called after whatever the waiting thread checks has been changed
+	void WakeRenderThreadWaiter( std::condition_variable& io_condition );
+}
+
 void eae6320::Graphics::Render()
 {
-	// Every frame an entirely new image will be created.
-	// Before drawing anything, then, the previous image will be erased
-	// by "clearing" the image buffer (filling it with a solid color)
-	Clear();
+	UploadStreamedRenderables();
 
-	size_t opaqueSize = s_opaqueRenderableList.size();
-	size_t transparentSize = s_transparentRenderableList.size();
+	const uint32_t snapshotIndex = s_publishedSnapshotCount.load(std::memory_order_relaxed);
+	const bool isRenderThreadRunning = IsRenderThreadRunning();
+	if (isRenderThreadRunning)
+	{
+		//The snapshot that is about to be overwritten is the one from two frames ago
+		WaitForRenderedSnapshots(snapshotIndex - 1);
+	}
+	sFrameSnapshot& snapshot = s_frameSnapshots[snapshotIndex % 2];
+	{
+		std::lock_guard<std::mutex> lock(s_uploadMutex);
+		TakeSnapshot(s_renderableList, snapshot);
+	}
+	if (isRenderThreadRunning)
+	{
+		//This also wakes the render thread for any loads that were just queued
+		s_publishedSnapshotCount.store(snapshotIndex + 1, std::memory_order_release);
+		WakeRenderThreadWaiter(s_renderThreadWorkAdded);
+	}
+	else
+	{
+		RenderSnapshot(snapshot);
+	}
+}
 
+bool eae6320::Graphics::StartRenderThread()
+{
+	if (IsRenderThreadRunning())
 	{
-		BeginScene();
-		{
-			//Drawing Opaque objects.
-			for (unsigned int i = 0; i < opaqueSize; i++)
-			{
-				Renderable toRender = *s_opaqueRenderableList[i];
-				// Set the shaders
-				{
-					BindEffect(toRender.m_material.m_effect);
-				}
+		return true;
+	}
+	//The context can only be current on one thread at a time
+	ReleaseContext();
+	s_shouldRenderThreadExit.store(false);
+	s_renderThreadState.store(starting);
+	s_renderThread = std::thread(RenderThreadMain);
+	WaitForRenderThreadCondition(s_renderThreadWorkFinished, []() { return s_renderThreadState.load() != starting; });
+	if (s_renderThreadState.load() == failedToStart)
+	{
+		s_renderThread.join();
+		MakeContextCurrent();
+		return false;
+	}
+	return true;
+}
 
-				//Setting the Material uniforms
-				{
-					for (int i = 0; i < toRender.m_material.m_noOfUniforms; i++)
-					{
-						SetMaterialUniform(toRender.m_material.m_effect, toRender.m_material.m_uniforms[i].values, toRender.m_material.m_uniforms[i].valueCountToSet, toRender.m_material.m_uniforms[i].uniformHandle, toRender.m_material.m_uniforms[i].shaderType);
-					}
-				}
+void eae6320::Graphics::StopRenderThread()
+{
+	if (!IsRenderThreadRunning())
+	{
+		return;
+	}
+	s_shouldRenderThreadExit.store(true);
+	WakeRenderThreadWaiter(s_renderThreadWorkAdded);
+	s_renderThread.join();
+	MakeContextCurrent();
+}
 
-				//Setting the Textures
-				{
-					eae6320::Graphics::SetTexture(toRender.m_material, i);
-				}
+bool eae6320::Graphics::SetDrawListThreadCount(const size_t i_threadCount)
+{
+	//The pool belongs to whichever thread renders
+	bool wasSuccessful = false;
+	RunOnRenderThread([&]()
+	{
+		wasSuccessful = s_workerPool.Initialize(i_threadCount);
+		s_isWorkerPoolInitialized = true;
+	});
+	return wasSuccessful;
+}
 
-				//Setting uniform offset
-				{
-					float floatArray[2] = { toRender.m_offset.x, toRender.m_offset.y };
-					//Generating localToWorld Matrix.
-					eae6320::Math::cMatrix_transformation localToWorld(toRender.m_orientation, toRender.m_offset);
-					SetDrawCallUniforms(toRender.m_material.m_effect, localToWorld);
-				}
-				// Drawing the Mesh
-				{
-					eae6320::Graphics::DrawMesh(toRender.m_mesh);
-				}
-			}
+size_t eae6320::Graphics::GetDrawListThreadCount()
+{
+	return s_isWorkerPoolInitialized ? s_workerPool.GetThreadCount() : 0;
+}
 
-			//Drawing Transparent objects.
-			for (unsigned int i = 0; i < transparentSize; i++)
-			{
-				Renderable toRender = *s_transparentRenderableList[i];
-				// Set the shaders
-				{
-					BindEffect(toRender.m_material.m_effect);
-				}
+bool eae6320::Graphics::SetErrorCheckMode(const eErrorCheckMode i_mode)
+{
+	//Debug output is part of the context's state
+	bool wasSuccessful = false;
+	RunOnRenderThread([&]()
+	{
+		wasSuccessful = ApplyErrorCheckMode(i_mode);
+	});
+	return wasSuccessful;
+}
 
-				//Setting the Material uniforms
-				{
-					for (int i = 0; i < toRender.m_material.m_noOfUniforms; i++)
-					{
-						SetMaterialUniform(toRender.m_material.m_effect, toRender.m_material.m_uniforms[i].values, toRender.m_material.m_uniforms[i].valueCountToSet, toRender.m_material.m_uniforms[i].uniformHandle, toRender.m_material.m_uniforms[i].shaderType);
-					}
-				}
+bool eae6320::Graphics::IsRenderThreadRunning()
+{
+	return s_renderThread.joinable();
+}
 
-				//Setting the Textures
-				{
-					eae6320::Graphics::SetTexture(toRender.m_material, i + opaqueSize);
-				}
+float eae6320::Graphics::GetFrameLatency()
+{
+	return s_frameLatency.load(std::memory_order_relaxed);
+}
 
-				//Setting uniform offset
-				{
-					float floatArray[2] = { toRender.m_offset.x, toRender.m_offset.y };
-					//Generating localToWorld Matrix.
-					eae6320::Math::cMatrix_transformation localToWorld(toRender.m_orientation, toRender.m_offset);
-					SetDrawCallUniforms(toRender.m_material.m_effect, localToWorld);
-				}
-				// Drawing the Mesh
-				{
-					eae6320::Graphics::DrawMesh(toRender.m_mesh);
-				}
+void eae6320::Graphics::ExecuteCommandBuffer(const cCommandBuffer& i_commandBuffer)
+{
+	const size_t commandCount = i_commandBuffer.GetCommandCount();
+	for (size_t i = 0; i < commandCount; ++i)
+	{
+		const cCommandBuffer::sCommand& command = i_commandBuffer.GetCommand(i);
+		switch (command.type)
+		{
+		case cCommandBuffer::setViewConstants:
+			SetViewConstants(i_commandBuffer.GetViewConstants(command.first));
+			break;
+		case cCommandBuffer::setInstanceTransforms:
+			SetInstanceTransforms((command.count > 0) ? &i_commandBuffer.GetTransform(command.first) : NULL, command.count);
+			break;
+		case cCommandBuffer::bindEffect:
+			BindEffect(*command.effect);
+			break;
+		case cCommandBuffer::bindMaterialConstants:
+			BindMaterialConstants(*command.material);
+			break;
+		case cCommandBuffer::setTexture:
+			SetTexture(*command.material);
+			break;
+		case cCommandBuffer::setDrawCallTransform:
+			{
+				eae6320::Math::cMatrix_transformation localToWorld = i_commandBuffer.GetTransform(command.first);
+				SetDrawCallUniforms(*command.effect, localToWorld);
 			}
+			break;
+		case cCommandBuffer::drawMesh:
+			DrawMesh(*command.mesh);
+			break;
+		case cCommandBuffer::drawMeshInstanced:
+			DrawMeshInstanced(*command.mesh, command.first, command.count);
+			break;
+		default:
+			assert(false);
 		}
-		EndScene();
 	}
-	// Everything has been drawn to the "back buffer", which is just an image in memory.
-	// In order to display it, the contents of the back buffer must be "presented"
-	// (to the front buffer)
-	SwapBuffers();
 }
 
 bool eae6320::Graphics::LoadMesh(const char* const i_path, Mesh& i_mesh)
@@ -122,203 +444,1173 @@ bool eae6320::Graphics::LoadMesh(const char* const i_path, Mesh& i_mesh)
 
 	//Variable declerations.
 
-	uint8_t *temporaryBuffer = NULL; //Declaring the temporary buffer to copy file contents into.
-
-	//File operations.
-	FILE *i_file;
-	errno_t err;
+	//The vertices and indices are uploaded straight out of the mapped file.
+	cMappedFile file;
+	const uint8_t *fileContents = NULL;
+	const uint8_t *o_vertexData = NULL;
+	const uint32_t *o_indexData = NULL;
+	uint32_t o_noOfIndices, o_noOfVertices;
+	size_t headerSize;
 
-	err = fopen_s(&i_file, i_path, "rb");
-	if (err != 0)
+	//A mesh that is already loaded is shared
+	const uint16_t sortId = GetSortId(i_path, s_meshSortIds);
+	if (ShareCachedAsset(s_cachedMeshes, sortId, meshAsset, i_mesh))
 	{
-			wereThereErrors = true;
-			std::stringstream errorMessage;
-			errorMessage << "Failed to load/open one or more mesh File\n";
-			eae6320::UserOutput::Print(errorMessage.str());
-
-			goto OnExit;
+		return true;
 	}
 
+	//File operations.
+	if (!OpenAssetFile(i_path, file))
+	{
+		wereThereErrors = true;
+		goto OnExit;
+	}
+	fileContents = file.GetContents();
 
-	//Getting File size to initialize Buffer.
-	fseek(i_file, 0, SEEK_END);
-	long fSize = ftell(i_file);
-	rewind(i_file);
-
-	//Initializing the Buffer
-	temporaryBuffer = reinterpret_cast<uint8_t*>(malloc(sizeof(uint8_t) * fSize));
-
-	if (temporaryBuffer == NULL)
+	//[vertex count][index count][vertex format][bounds][vertices][indices]
+	headerSize = 12 + sizeof(sMeshBounds);
+	if (file.GetSize() < headerSize)
 	{
 		wereThereErrors = true;
 		std::stringstream errorMessage;
-		errorMessage << "Failed to allocate memory for buffer.\n";
+		errorMessage << "The mesh \"" << i_path << "\" is too small to be a mesh\n";
 		eae6320::UserOutput::Print(errorMessage.str());
 
 		goto OnExit;
 	}
-	
-	eae6320::Graphics::sVertex *o_vertexData = NULL;
-	uint32_t *o_indexData = NULL;
-	uint32_t o_noOfIndices, o_noOfVertices;
-
-	//Making the read call.
-	fread(temporaryBuffer, sizeof(uint8_t), fSize, i_file);
-
-	o_noOfVertices = *reinterpret_cast<uint32_t*>(temporaryBuffer);
-	o_noOfIndices = *reinterpret_cast<uint32_t*>(temporaryBuffer + 4);
-	o_vertexData = reinterpret_cast<sVertex*>(temporaryBuffer + 8);
-	o_indexData = reinterpret_cast<uint32_t*>(temporaryBuffer + (8 + o_noOfVertices*(sizeof(sVertex))));
+	o_noOfVertices = *reinterpret_cast<const uint32_t*>(fileContents);
+	o_noOfIndices = *reinterpret_cast<const uint32_t*>(fileContents + 4);
+	i_mesh.m_vertexFormat = static_cast<eVertexFormat>(*reinterpret_cast<const uint32_t*>(fileContents + 8));
+	o_vertexData = fileContents + headerSize;
+	o_indexData = reinterpret_cast<const uint32_t*>(fileContents + (headerSize + o_noOfVertices * GetVertexStride(i_mesh.m_vertexFormat)));
 
 	i_mesh.m_noOfVertices = o_noOfVertices;
 	i_mesh.m_noOfIndices = o_noOfIndices;
+	i_mesh.m_sortId = sortId;
+	std::memcpy(&i_mesh.m_bounds, fileContents + 12, sizeof(sMeshBounds));
+	if (i_mesh.m_vertexFormat != floatVertices)
+	{
+		const sMeshBounds& bounds = i_mesh.m_bounds;
+		i_mesh.m_dequantizeTransform = eae6320::Math::cMatrix_transformation::CreateScaleAndTranslation(
+			eae6320::Math::cVector(bounds.aabbMax[0] - bounds.aabbMin[0], bounds.aabbMax[1] - bounds.aabbMin[1], bounds.aabbMax[2] - bounds.aabbMin[2]),
+			eae6320::Math::cVector(bounds.aabbMin[0], bounds.aabbMin[1], bounds.aabbMin[2]));
+	}
 
-	if (o_indexData == NULL || o_vertexData == NULL)
+	if (i_mesh.m_vertexFormat > quantizedVerticesNoColor)
 	{
 		wereThereErrors = true;
 		std::stringstream errorMessage;
-		errorMessage << "Failed to correctly create arrays.\n";
+		errorMessage << "The mesh \"" << i_path << "\" has an unknown vertex format (" << i_mesh.m_vertexFormat << ")\n";
 		eae6320::UserOutput::Print(errorMessage.str());
 
 		goto OnExit;
 	}
 
-	if(!wereThereErrors)
-		eae6320::Graphics::CreateBuffers(o_vertexData, o_noOfVertices, o_indexData, o_noOfIndices, i_mesh);
+	if ((reinterpret_cast<const uint8_t*>(o_indexData + o_noOfIndices)) > (fileContents + file.GetSize()))
+	{
+		wereThereErrors = true;
+		std::stringstream errorMessage;
+		errorMessage << "The mesh \"" << i_path << "\" is smaller than its vertex and index counts say\n";
+		eae6320::UserOutput::Print(errorMessage.str());
 
-	goto OnExit;
+		goto OnExit;
+	}
+
+	if (!eae6320::Graphics::CreateBuffers(o_vertexData, o_noOfVertices, o_indexData, o_noOfIndices, i_mesh))
+	{
+		wereThereErrors = true;
+		goto OnExit;
+	}
 
 OnExit:
 
-	free(temporaryBuffer);
+	//The graphics API has its own copy of the data by now, so the file can be unmapped
+	file.Close();
 
-	if (!wereThereErrors) 
+	if (!wereThereErrors)
 	{
-		o_vertexData = NULL;
-		o_indexData = NULL;
+		CacheAsset(s_cachedMeshes, sortId, meshAsset, i_mesh,
+			(static_cast<uint64_t>(o_noOfVertices) * GetVertexStride(i_mesh.m_vertexFormat)) + (static_cast<uint64_t>(o_noOfIndices) * sizeof(uint32_t)));
 	}
 
 	return !wereThereErrors;
 }
 
-bool eae6320::Graphics::LoadMaterial(const char* const i_path, Material& i_material)
+void eae6320::Graphics::UnloadMesh(const Mesh& i_mesh)
 {
-	bool wereThereErrors = false;
-
-	//Variable declerations.
-
-	uint8_t *temporaryBuffer = NULL; //Declaring the temporary buffer to copy file contents into.
-
-									 //File operations.
-	FILE *i_file;
-	errno_t err;
+	sCachedAsset<Mesh> mesh;
+	if (ReleaseCachedAsset(s_cachedMeshes, i_mesh.m_sortId, meshAsset, mesh))
+	{
+		DestroyBuffers(mesh.asset);
+	}
+}
 
-	err = fopen_s(&i_file, i_path, "rb");
-	if (err != 0)
+size_t eae6320::Graphics::GetVertexStride(const eVertexFormat i_vertexFormat)
+{
+	switch (i_vertexFormat)
 	{
-		wereThereErrors = true;
-		std::stringstream errorMessage;
-		errorMessage << "Failed to load/open one or more mesh File\n";
-		eae6320::UserOutput::Print(errorMessage.str());
+	case quantizedVertices:
+		return sizeof(sVertex_quantized);
+	case quantizedVerticesNoColor:
+		//Everything but the color, which is the last member
+		return sizeof(sVertex_quantized) - (4 * sizeof(uint8_t));
+	default:
+		return sizeof(sVertex);
+	}
+}
 
-		goto OnExit;
+bool eae6320::Graphics::LoadMaterial(const char* const i_path, Material& i_material)
+{
+	//A material that is already loaded is shared, along with its effect, texture and constants
+	const uint16_t sortId = GetSortId(i_path, s_materialSortIds);
+	if (ShareCachedAsset(s_cachedMaterials, sortId, materialAsset, i_material))
+	{
+		return true;
 	}
 
+	bool wereThereErrors = false;
 
-	//Getting File size to initialize Buffer.
-	fseek(i_file, 0, SEEK_END);
-	long fSize = ftell(i_file);
-	rewind(i_file);
+	//Variable declerations.
 
-	//Initializing the Buffer
-	temporaryBuffer = reinterpret_cast<uint8_t*>(malloc(sizeof(uint8_t) * fSize));
+	//The paths and names are read straight out of the mapped file;
+	//only the uniforms and constants are copied because the material keeps them.
+	cMappedFile file;
+	const uint8_t *fileContents = NULL;
+	const char *i_effectPath, *i_textureHandle, *i_texturePath;
+	const sUniformHelper *uniformsArray = NULL;
+	const char** uniformNamesArray = NULL;
+	size_t offset;
+	uint16_t effectSortId = 0;
+	//What the material holds a reference to
+	bool hasEffect = false;
+	std::string texturePath;
 
-	if (temporaryBuffer == NULL)
+	//File operations.
+	if (!OpenAssetFile(i_path, file))
 	{
 		wereThereErrors = true;
-		std::stringstream errorMessage;
-		errorMessage << "Failed to allocate memory for buffer.\n";
-		eae6320::UserOutput::Print(errorMessage.str());
-
 		goto OnExit;
 	}
-
-	//Making the read call.
-	fread(temporaryBuffer, sizeof(uint8_t), fSize, i_file);
+	fileContents = file.GetContents();
 	
-	//Read effect path and load it
-	const char *i_effectPath = reinterpret_cast<char*>(temporaryBuffer);
-	eae6320::Graphics::LoadEffect(i_effectPath, i_material.m_effect);
+	//Read effect path and load it (unless another material already has)
+	i_effectPath = reinterpret_cast<const char*>(fileContents);
+	effectSortId = GetSortId(i_effectPath, s_effectSortIds);
+	hasEffect = ShareCachedAsset(s_cachedEffects, effectSortId, effectAsset, i_material.m_effect);
+	if (!hasEffect)
+	{
+		const uint64_t contentBytes = s_openedContentBytes;
+		if (!eae6320::Graphics::LoadEffect(i_effectPath, i_material.m_effect))
+		{
+			wereThereErrors = true;
+			goto OnExit;
+		}
+		i_material.m_effect.m_sortId = effectSortId;
+		CacheAsset(s_cachedEffects, effectSortId, effectAsset, i_material.m_effect, s_openedContentBytes - contentBytes);
+		hasEffect = true;
+	}
+	i_material.m_effect.m_sortId = effectSortId;
+	i_material.m_sortId = sortId;
 
 	//Updating offset
-	size_t offset = strlen(i_effectPath) + 1;
+	offset = strlen(i_effectPath) + 1;
 
 	//Read texture handle
-	const char *i_textureHandle = reinterpret_cast<char*>(temporaryBuffer + offset);
+	i_textureHandle = reinterpret_cast<const char*>(fileContents + offset);
 
 	//Updating offset
 	offset += strlen(i_textureHandle) + 1;
 
 	//Read texture path
-	const char *i_texturePath = reinterpret_cast<char*>(temporaryBuffer + offset);
+	i_texturePath = reinterpret_cast<const char*>(fileContents + offset);
 
 	//Updating offset
 	offset += strlen(i_texturePath) + 1;
 	
-	//Load Texture
-	eae6320::Graphics::LoadTexture(i_texturePath, i_material);
+	//Load Texture (unless another material already has)
+	texturePath = i_texturePath;
+	if (!ShareCachedAsset(s_cachedTextures, texturePath, textureAsset, i_material.m_3dTexture))
+	{
+		const uint64_t contentBytes = s_openedContentBytes;
+		if (!eae6320::Graphics::LoadTexture(i_texturePath, i_material))
+		{
+			//The material doesn't hold a reference to a texture that failed to load
+			texturePath.clear();
+			wereThereErrors = true;
+			goto OnExit;
+		}
+		CacheAsset(s_cachedTextures, texturePath, textureAsset, i_material.m_3dTexture, s_openedContentBytes - contentBytes);
+	}
 
 	//Get the handles
-	eae6320::Graphics::LoadSamplerID(i_textureHandle, i_material);
+	if (!eae6320::Graphics::LoadSamplerID(i_textureHandle, i_material))
+	{
+		wereThereErrors = true;
+		goto OnExit;
+	}
 
 	//Read number of uniforms.
-	i_material.m_noOfUniforms = *reinterpret_cast<uint8_t*>(temporaryBuffer + offset);
+	i_material.m_noOfUniforms = *(fileContents + offset);
 
 	//Load the sUniformHelpers
-	sUniformHelper *uniformsArray = NULL;
 	offset += 1;
-	uniformsArray = reinterpret_cast<sUniformHelper*>(temporaryBuffer + offset);
+	uniformsArray = reinterpret_cast<const sUniformHelper*>(fileContents + offset);
 
 	i_material.m_uniforms = new sUniformHelper[i_material.m_noOfUniforms];
 	std::memcpy(i_material.m_uniforms, uniformsArray, (sizeof(sUniformHelper) * i_material.m_noOfUniforms));
+	s_loadStatistics.copiedBytes += sizeof(sUniformHelper) * i_material.m_noOfUniforms;
 
 	//Load the uniform names.
-	char** uniformNamesArray = NULL;
-	uniformNamesArray = new char*[i_material.m_noOfUniforms];
+	uniformNamesArray = new const char*[i_material.m_noOfUniforms];
 	offset += (sizeof(sUniformHelper) * i_material.m_noOfUniforms);
 
 	for (int i = 0; i < i_material.m_noOfUniforms; i++)
 	{
-		uniformNamesArray[i] = reinterpret_cast<char*>(temporaryBuffer + offset);
+		uniformNamesArray[i] = reinterpret_cast<const char*>(fileContents + offset);
 		offset += strlen(uniformNamesArray[i]) + 1;
 	}
 
-	for (int i = 0; i < i_material.m_noOfUniforms; i++)
+	//Read the constant block that MaterialBuilder baked
+	std::memcpy(&i_material.m_constantsSize, fileContents + offset, sizeof(uint16_t));
+	offset += sizeof(uint16_t);
+	i_material.m_constants = new uint8_t[i_material.m_constantsSize];
+	std::memcpy(i_material.m_constants, fileContents + offset, i_material.m_constantsSize);
+	s_loadStatistics.copiedBytes += i_material.m_constantsSize;
+	i_material.m_areConstantsDirty = new bool(false);
+	offset += i_material.m_constantsSize;
+
+	if (!CreateMaterialConstants(i_material, uniformNamesArray))
 	{
-		i_material.m_uniforms[i].uniformHandle = GetUniform(i_material.m_effect, uniformNamesArray[i], i_material.m_uniforms[i].shaderType);
+		wereThereErrors = true;
+		goto OnExit;
 	}
 
 	goto OnExit;
 
 OnExit:
 
-	free(temporaryBuffer);
+	//The names pointed into the file's contents and were only needed to find the uniforms
+	delete[] uniformNamesArray;
+	file.Close();
 
 	if (!wereThereErrors)
 	{
-		uniformsArray = NULL;
-		uniformNamesArray = NULL;
+		sCachedMaterial& material = CacheAsset(s_cachedMaterials, sortId, materialAsset, i_material,
+			(sizeof(sUniformHelper) * i_material.m_noOfUniforms) + i_material.m_constantsSize);
+		material.hasEffect = hasEffect;
+		material.texturePath = texturePath;
+	}
+	else
+	{
+		//Nothing shares a material that failed to load, but its effect and texture might be shared
+		DestroyMaterial(i_material);
+		ReleaseMaterialAssets(hasEffect, effectSortId, texturePath);
 	}
 
 	return !wereThereErrors;
 }
 
-std::vector<eae6320::Graphics::Renderable*>* eae6320::Graphics::GetOpaqueRenderableList()
+void eae6320::Graphics::UnloadMaterial(const Material& i_material)
 {
-	return &s_opaqueRenderableList;
+	sCachedMaterial material;
+	if (ReleaseCachedAsset(s_cachedMaterials, i_material.m_sortId, materialAsset, material))
+	{
+		DestroyMaterial(material.asset);
+		ReleaseMaterialAssets(material.hasEffect, material.asset.m_effect.m_sortId, material.texturePath);
+	}
 }
 
-std::vector<eae6320::Graphics::Renderable*>* eae6320::Graphics::GetTransparentRenderableList()
+void eae6320::Graphics::AddRenderable(const char* const i_pathMesh, const char* const i_pathMaterial, eae6320::Graphics::Renderable *i_renderable)
 {
-	return &s_transparentRenderableList;
-}
\ No newline at end of file
+	//Loading creates graphics objects, so it has to be done where the context is current
+	RunOnRenderThread([=]()
+	{
+		//A renderable whose assets couldn't be loaded is never drawn
+		if (LoadRenderable(i_pathMesh, i_pathMaterial, *i_renderable))
+		{
+			//The draw order is decided by the render queue every frame, so the list order doesn't matter
+			s_renderableList.push_back(i_renderable);
+			s_drawPackets.push_back(CreateDrawPacket(*i_renderable));
+		}
+	});
+}
+
+void eae6320::Graphics::RemoveRenderable(eae6320::Graphics::Renderable *i_renderable)
+{
+	//A renderable that is still being streamed in isn't in the list yet
+	tLoadHandle canceledLoad = s_assetStreamer.Cancel(i_renderable);
+	if (canceledLoad != 0)
+	{
+		SetLoadState(canceledLoad, loadCanceled);
+		return;
+	}
+	//Once this returns no frame uses the renderable anymore and so the caller can delete it
+	RunOnRenderThread([&canceledLoad, i_renderable]()
+	{
+		//Queued loads are only uploaded on this thread, and so one that is found here hasn't been started
+		{
+			std::lock_guard<std::mutex> lock(s_uploadMutex);
+			for (std::vector<cAssetStreamer::sLoad*>::iterator i = s_loadsToUpload.begin(); i < s_loadsToUpload.end(); ++i)
+			{
+				if ((*i)->renderable == i_renderable)
+				{
+					canceledLoad = (*i)->handle;
+					delete *i;
+					s_loadsToUpload.erase(i);
+					return;
+				}
+			}
+		}
+		for (std::vector<eae6320::Graphics::Renderable*>::iterator i = s_renderableList.begin(); i < s_renderableList.end(); ++i)
+		{
+			if (*(i) == i_renderable)
+			{
+				s_drawPackets.erase(s_drawPackets.begin() + (i - s_renderableList.begin()));
+				s_renderableList.erase(i);
+				//The assets are only destroyed if no other renderable shares them
+				UnloadMesh(i_renderable->m_mesh);
+				UnloadMaterial(i_renderable->m_material);
+				break;
+			}
+		}
+	});
+	if (canceledLoad != 0)
+	{
+		SetLoadState(canceledLoad, loadCanceled);
+	}
+}
+
+bool eae6320::Graphics::SetMaterialConstant(Material& io_material, const uint8_t i_uniformIndex, const float* const i_values)
+{
+	if (i_uniformIndex >= io_material.m_noOfUniforms)
+	{
+		std::stringstream errorMessage;
+		errorMessage << "The material doesn't have a uniform #" << static_cast<int>(i_uniformIndex);
+		eae6320::UserOutput::Print(errorMessage.str());
+		return false;
+	}
+	//The render thread reads the constants while it binds the material
+	RunOnRenderThread([&]()
+	{
+		sUniformHelper& uniform = io_material.m_uniforms[i_uniformIndex];
+		const size_t valueSize = sizeof(float) * uniform.valueCountToSet;
+		std::memcpy(uniform.values, i_values, valueSize);
+		std::memcpy(io_material.m_constants + uniform.blockOffset, i_values, valueSize);
+		*io_material.m_areConstantsDirty = true;
+	});
+	return true;
+}
+
+std::vector<eae6320::Graphics::Renderable*>* eae6320::Graphics::GetRenderableList()
+{
+	return &s_renderableList;
+}
+
+const eae6320::Graphics::cCommandBuffer& eae6320::Graphics::GetFrameCommands()
+{
+	return s_commandBuffer;
+}
+
+bool eae6320::Graphics::OpenAssetFile(const char* const i_path, cMappedFile& o_file)
+{
+	//A streamed renderable's files have already been opened
+	if (s_preloadedFiles)
+	{
+		for (cAssetStreamer::sPreloadedFile& preloadedFile : *s_preloadedFiles)
+		{
+			if (preloadedFile.file.IsOpen() && (preloadedFile.path == i_path))
+			{
+				o_file = std::move(preloadedFile.file);
+				break;
+			}
+		}
+	}
+	//Everything else is looked for in the asset pack before its own file is opened
+	if (!o_file.IsOpen())
+	{
+		const uint8_t* contents;
+		size_t size;
+		if (s_assetPack.Find(i_path, contents, size))
+		{
+			o_file.Borrow(contents, size);
+		}
+	}
+	std::string errorMessage;
+	if (!o_file.IsOpen() && !o_file.Open(i_path, s_shouldReadAssetFilesIntoMemory, &errorMessage))
+	{
+		eae6320::UserOutput::Print(errorMessage);
+		return false;
+	}
+	//Compressed files are decompressed on the worker threads
+	//(a streamed renderable's files were already decompressed on the streaming thread)
+	if (AssetCompression::IsCompressed(o_file.GetContents(), o_file.GetSize()) && !o_file.Decompress(i_path, &GetWorkerPool(), &errorMessage))
+	{
+		eae6320::UserOutput::Print(errorMessage);
+		o_file.Close();
+		return false;
+	}
+	++s_loadStatistics.fileCount;
+	if (o_file.IsBorrowed())
+	{
+		++s_loadStatistics.packedFileCount;
+	}
+	s_loadStatistics.fileBytes += o_file.GetStoredSize();
+	if (o_file.WasReadIntoMemory())
+	{
+		s_loadStatistics.copiedBytes += o_file.GetStoredSize();
+	}
+	if (o_file.WasDecompressed())
+	{
+		++s_loadStatistics.compressedFileCount;
+		s_loadStatistics.decompressedBytes += o_file.GetSize();
+	}
+	s_openedContentBytes += o_file.GetSize();
+	return true;
+}
+
+bool eae6320::Graphics::OpenAssetPack(const char* const i_path)
+{
+	bool wereThereErrors = false;
+	//Assets are loaded on the render thread
+	RunOnRenderThread([&]()
+	{
+		//The files of a streamed renderable might have been found in the pack that is about to be closed
+		assert(!AreRenderablesBeingStreamed());
+		std::string errorMessage;
+		if (!s_assetPack.Open(i_path, &errorMessage))
+		{
+			wereThereErrors = true;
+			eae6320::UserOutput::Print(errorMessage);
+		}
+	});
+	return !wereThereErrors;
+}
+
+void eae6320::Graphics::CloseAssetPack()
+{
+	RunOnRenderThread([]()
+	{
+		assert(!AreRenderablesBeingStreamed());
+		s_assetPack.Close();
+	});
+}
+
+void eae6320::Graphics::SetShouldReadAssetFilesIntoMemory(const bool i_shouldReadAssetFilesIntoMemory)
+{
+	//Assets are loaded on the render thread
+	RunOnRenderThread([=]()
+	{
+		s_shouldReadAssetFilesIntoMemory = i_shouldReadAssetFilesIntoMemory;
+	});
+}
+
+const eae6320::Graphics::sLoadStatistics& eae6320::Graphics::GetLoadStatistics()
+{
+	return s_loadStatistics;
+}
+
+const eae6320::Graphics::sAssetCacheStatistics& eae6320::Graphics::GetAssetCacheStatistics(const eAssetType i_type)
+{
+	assert(i_type < assetTypeCount);
+	return s_assetCacheStatistics[i_type];
+}
+
+void eae6320::Graphics::StopWorkerThreads()
+{
+	//The streamed files might be in the asset pack, and so this must be done before it is closed
+	s_assetStreamer.CleanUp();
+	PublishUploadedLoads();
+	for (cAssetStreamer::sLoad* const load : s_loadsToUpload)
+	{
+		delete load;
+	}
+	s_loadsToUpload.clear();
+	s_areLoadsWaitingForUpload.store(false);
+	for (std::pair<const tLoadHandle, eLoadState>& loadState : s_loadStates)
+	{
+		if (loadState.second == loadPending)
+		{
+			loadState.second = loadCanceled;
+		}
+	}
+	//The threads are started again the next time that they are used
+	s_workerPool.CleanUp();
+	s_isWorkerPoolInitialized = false;
+}
+
+void eae6320::Graphics::UnloadAllAssets()
+{
+	//Every reference is dropped at once, so the materials don't release their effects and textures
+	for (std::pair<const uint16_t, sCachedMaterial>& material : s_cachedMaterials)
+	{
+		DestroyMaterial(material.second.asset);
+	}
+	s_cachedMaterials.clear();
+	for (std::pair<const uint16_t, sCachedAsset<Effect>>& effect : s_cachedEffects)
+	{
+		DestroyEffect(effect.second.asset);
+	}
+	s_cachedEffects.clear();
+	for (std::pair<const std::string, sCachedAsset<tTexture>>& texture : s_cachedTextures)
+	{
+		Material material;
+		material.m_3dTexture = texture.second.asset;
+		DestroyTexture(material);
+	}
+	s_cachedTextures.clear();
+	for (std::pair<const uint16_t, sCachedAsset<Mesh>>& mesh : s_cachedMeshes)
+	{
+		DestroyBuffers(mesh.second.asset);
+	}
+	s_cachedMeshes.clear();
+	for (sAssetCacheStatistics& statistics : s_assetCacheStatistics)
+	{
+		statistics.loadedCount = 0;
+		statistics.loadedBytes = 0;
+	}
+}
+
+eae6320::Graphics::tLoadHandle eae6320::Graphics::AddRenderableAsync(const char* const i_pathMesh, const char* const i_pathMaterial, Renderable *i_renderable)
+{
+	//The setting can only change on the render thread while this thread waits for it,
+	//and so it is safe to read here
+	const tLoadHandle handle = s_assetStreamer.Add(i_pathMesh, i_pathMaterial, i_renderable, s_shouldReadAssetFilesIntoMemory, &s_assetPack);
+	s_loadStates[handle] = loadPending;
+	return handle;
+}
+
+eae6320::Graphics::eLoadState eae6320::Graphics::GetLoadState(const tLoadHandle i_handle)
+{
+	const std::map<tLoadHandle, eLoadState>::const_iterator loadState = s_loadStates.find(i_handle);
+	return (loadState != s_loadStates.end()) ? loadState->second : loadFailed;
+}
+
+void eae6320::Graphics::ReleaseLoadHandle(const tLoadHandle i_handle)
+{
+	s_loadStates.erase(i_handle);
+}
+
+void eae6320::Graphics::SetMaxStreamingUploadsPerFrame(const size_t i_maxUploadCount)
+{
+	//At least one renderable has to be uploaded every frame or nothing would ever finish loading
+	s_maxStreamingUploadsPerFrame = std::max<size_t>(i_maxUploadCount, 1);
+}
+
+const eae6320::Graphics::sStreamingStatistics& eae6320::Graphics::GetStreamingStatistics()
+{
+	return s_streamingStatistics;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	sDrawPacket CreateDrawPacket( const eae6320::Graphics::Renderable& i_renderable )
+	{
+		const eae6320::Graphics::Mesh& mesh = i_renderable.m_mesh;
+		const eae6320::Graphics::Effect& effect = i_renderable.m_material.m_effect;
+		sDrawPacket drawPacket;
+		for ( size_t i = 0; i < 3; ++i )
+		{
+			drawPacket.sphereCenter[i] = mesh.m_bounds.sphereCenter[i];
+		}
+		drawPacket.sphereRadius = mesh.m_bounds.sphereRadius;
+		drawPacket.effectSortId = effect.m_sortId;
+		drawPacket.materialSortId = i_renderable.m_material.m_sortId;
+		drawPacket.meshSortId = mesh.m_sortId;
+		drawPacket.flags = 0;
+		if ( effect.m_renderStates & eae6320::Graphics::alpha )
+		{
+			drawPacket.flags |= isTransparent;
+		}
+		if ( effect.m_isInstanced )
+		{
+			drawPacket.flags |= isInstanced;
+		}
+		if ( mesh.m_vertexFormat != eae6320::Graphics::floatVertices )
+		{
+			drawPacket.flags |= isQuantized;
+		}
+		return drawPacket;
+	}
+
+	void TakeSnapshot( const std::vector<eae6320::Graphics::Renderable*>& i_renderableList, sFrameSnapshot& o_snapshot )
+	{
+		o_snapshot.creationTime = std::chrono::steady_clock::now();
+		const size_t renderableCount = i_renderableList.size();
+		o_snapshot.orientations.resize( renderableCount );
+		o_snapshot.offsets.resize( renderableCount );
+		for ( size_t i = 0; i < renderableCount; ++i )
+		{
+			o_snapshot.orientations[i] = i_renderableList[i]->m_orientation;
+			o_snapshot.offsets[i] = i_renderableList[i]->m_offset;
+		}
+		const eae6320::Graphics::Camera& camera = eae6320::Graphics::Camera::getInstance();
+		o_snapshot.cameraOrientation = camera.m_orientation;
+		o_snapshot.cameraOffset = camera.m_offset;
+		o_snapshot.fieldOfView = camera.FOV;
+		o_snapshot.nearPlane = camera.m_nearPlane;
+		o_snapshot.farPlane = camera.m_farPlane;
+	}
+
+	void RenderSnapshot( const sFrameSnapshot& i_snapshot )
+	{
+		// Every frame an entirely new image will be created.
+		// Before drawing anything, then, the previous image will be erased
+		// by "clearing" the image buffer (filling it with a solid color)
+		eae6320::Graphics::Clear();
+
+		// The camera doesn't move during a frame so everything is culled, sorted and drawn with the same view
+		const eae6320::Graphics::sViewConstants viewConstants = CreateViewConstants( i_snapshot );
+		const eae6320::Math::cFrustum frustum( viewConstants.worldToProjected );
+
+		// Recording the frame only reads the scene; nothing is sent to the graphics API until it is executed
+		s_commandBuffer.Clear();
+		{
+			s_commandBuffer.SetViewConstants( viewConstants );
+			// Only the visible renderables are queued,
+			// and the sort puts opaque ones first (grouped by state, front-to-back) and transparent ones last (back-to-front)
+			FillRenderQueue( s_drawPackets, s_renderableList, i_snapshot, viewConstants, frustum );
+			s_renderQueue.Sort();
+
+			// Consecutive draws that could share a single instanced draw call are merged into runs
+			CreateDrawRuns( s_drawPackets );
+			s_commandBuffer.SetInstanceTransforms( s_instanceTransforms.empty() ? NULL : &s_instanceTransforms[0], s_instanceTransforms.size() );
+			RecordDrawRuns( s_renderableList, s_commandBuffer );
+		}
+
+		{
+			eae6320::Graphics::BeginScene();
+			{
+				eae6320::Graphics::ExecuteCommandBuffer( s_commandBuffer );
+			}
+			eae6320::Graphics::EndScene();
+		}
+		// Everything has been drawn to the "back buffer", which is just an image in memory.
+		// In order to display it, the contents of the back buffer must be "presented"
+		// (to the front buffer)
+		eae6320::Graphics::SwapBuffers();
+
+		const std::chrono::duration<float> latency = std::chrono::steady_clock::now() - i_snapshot.creationTime;
+		s_frameLatency.store( latency.count(), std::memory_order_relaxed );
+	}
+
+	eae6320::Graphics::sViewConstants CreateViewConstants( const sFrameSnapshot& i_snapshot )
+	{
+		eae6320::Graphics::sViewConstants viewConstants;
+		viewConstants.worldToView = eae6320::Math::cMatrix_transformation::CreateWorldToViewTransform( i_snapshot.cameraOrientation, i_snapshot.cameraOffset );
+		viewConstants.viewToScreen = eae6320::Math::cMatrix_transformation::CreateViewToScreenTransform(
+			i_snapshot.fieldOfView, eae6320::Graphics::getAspectRatio(), i_snapshot.nearPlane, i_snapshot.farPlane );
+		viewConstants.worldToProjected = viewConstants.worldToView * viewConstants.viewToScreen;
+		return viewConstants;
+	}
+
+	void FillRenderQueue( const std::vector<sDrawPacket>& i_drawPackets, const std::vector<eae6320::Graphics::Renderable*>& i_renderableList,
+		const sFrameSnapshot& i_snapshot, const eae6320::Graphics::sViewConstants& i_viewConstants, const eae6320::Math::cFrustum& i_frustum )
+	{
+		// Every chunk writes to its own part of these
+		// Renderables that were streamed in after the snapshot was taken are drawn from the next one
+		const size_t renderableCount = i_snapshot.offsets.size();
+		s_localToWorldTransforms.resize( renderableCount );
+		s_localToProjectedTransforms.resize( renderableCount );
+		s_sphereCenters_x.resize( renderableCount );
+		s_sphereCenters_y.resize( renderableCount );
+		s_sphereCenters_z.resize( renderableCount );
+		s_sphereRadii.resize( renderableCount );
+		s_areVisible.resize( renderableCount );
+		const size_t chunkCount = ( renderableCount + s_drawListChunkSize - 1 ) / s_drawListChunkSize;
+		if ( s_drawListChunks.size() < chunkCount )
+		{
+			s_drawListChunks.resize( chunkCount );
+		}
+
+		GetWorkerPool().Run( chunkCount, [&]( const size_t i_chunkIndex )
+		{
+			const size_t begin = i_chunkIndex * s_drawListChunkSize;
+			const size_t end = std::min( begin + s_drawListChunkSize, renderableCount );
+			CreateLocalToWorldTransforms( i_snapshot, begin, end );
+			CullRenderables( i_drawPackets, i_frustum, begin, end );
+			CreateSortKeys( i_drawPackets, i_renderableList, i_snapshot, i_viewConstants, begin, end, s_drawListChunks[i_chunkIndex] );
+		} );
+
+		s_renderQueue.Clear();
+		for ( size_t i = 0; i < chunkCount; ++i )
+		{
+			const sDrawListChunk& chunk = s_drawListChunks[i];
+			if ( !chunk.keys.empty() )
+			{
+				s_renderQueue.Submit( &chunk.keys[0], &chunk.drawIndices[0], chunk.keys.size() );
+			}
+		}
+	}
+
+	void CreateLocalToWorldTransforms( const sFrameSnapshot& i_snapshot, const size_t i_begin, const size_t i_end )
+	{
+		if ( i_end > i_begin )
+		{
+			eae6320::Math::cMatrix_transformation::CreateFromRotationsAndTranslations(
+				&i_snapshot.orientations[i_begin], &i_snapshot.offsets[i_begin], i_end - i_begin, &s_localToWorldTransforms[i_begin] );
+		}
+	}
+
+	void CullRenderables( const std::vector<sDrawPacket>& i_drawPackets, const eae6320::Math::cFrustum& i_frustum,
+		const size_t i_begin, const size_t i_end )
+	{
+		for ( size_t i = i_begin; i < i_end; ++i )
+		{
+			// The transforms only have rotation and translation,
+			// so only the center needs to be moved into world space (the radius stays the same)
+			const sDrawPacket& drawPacket = i_drawPackets[i];
+			const eae6320::Math::cVector center_world = s_localToWorldTransforms[i].TransformPoint(
+				eae6320::Math::cVector( drawPacket.sphereCenter[0], drawPacket.sphereCenter[1], drawPacket.sphereCenter[2] ) );
+			s_sphereCenters_x[i] = center_world.x;
+			s_sphereCenters_y[i] = center_world.y;
+			s_sphereCenters_z[i] = center_world.z;
+			s_sphereRadii[i] = drawPacket.sphereRadius;
+		}
+		if ( i_end > i_begin )
+		{
+			i_frustum.AreSpheresVisible( &s_sphereCenters_x[i_begin], &s_sphereCenters_y[i_begin], &s_sphereCenters_z[i_begin], &s_sphereRadii[i_begin],
+				i_end - i_begin, &s_areVisible[i_begin] );
+		}
+	}
+
+	void CreateSortKeys( const std::vector<sDrawPacket>& i_drawPackets, const std::vector<eae6320::Graphics::Renderable*>& i_renderableList,
+		const sFrameSnapshot& i_snapshot, const eae6320::Graphics::sViewConstants& i_viewConstants, const size_t i_begin, const size_t i_end,
+		sDrawListChunk& o_chunk )
+	{
+		o_chunk.keys.clear();
+		o_chunk.drawIndices.clear();
+		for ( size_t i = i_begin; i < i_end; ++i )
+		{
+			if ( !s_areVisible[i] )
+			{
+				continue;
+			}
+			const sDrawPacket& drawPacket = i_drawPackets[i];
+			// The camera looks down negative Z in view space
+			const float distance = -i_viewConstants.worldToView.TransformPoint(
+				eae6320::Math::cVector( s_sphereCenters_x[i], s_sphereCenters_y[i], s_sphereCenters_z[i] ) ).z;
+			const eae6320::Graphics::cRenderQueue::eLayer layer = ( drawPacket.flags & isTransparent ) ?
+				eae6320::Graphics::cRenderQueue::transparent : eae6320::Graphics::cRenderQueue::opaque;
+			const uint64_t key = eae6320::Graphics::cRenderQueue::CreateKey( layer,
+				drawPacket.effectSortId, drawPacket.materialSortId, drawPacket.meshSortId,
+				eae6320::Graphics::cRenderQueue::QuantizeDepth( distance, i_snapshot.nearPlane, i_snapshot.farPlane ) );
+			o_chunk.keys.push_back( key );
+			o_chunk.drawIndices.push_back( static_cast<uint32_t>( i ) );
+			// Instanced draws read their whole transform from the instance buffer
+			// (and quantized positions have to be expanded back into local space first)
+			if ( drawPacket.flags & isInstanced )
+			{
+				if ( !( drawPacket.flags & isQuantized ) )
+				{
+					s_localToProjectedTransforms[i] = s_localToWorldTransforms[i] * i_viewConstants.worldToProjected;
+				}
+				else
+				{
+					s_localToProjectedTransforms[i] =
+						i_renderableList[i]->m_mesh.m_dequantizeTransform * s_localToWorldTransforms[i] * i_viewConstants.worldToProjected;
+				}
+			}
+		}
+	}
+
+	void CreateDrawRuns( const std::vector<sDrawPacket>& i_drawPackets )
+	{
+		s_drawRuns.clear();
+		s_instanceTransforms.clear();
+		const size_t drawCount = s_renderQueue.GetCount();
+		for ( size_t j = 0; j < drawCount; ++j )
+		{
+			const uint32_t i = s_renderQueue.GetDrawIndex( j );
+			const sDrawPacket& drawPacket = i_drawPackets[i];
+			if ( drawPacket.flags & isInstanced )
+			{
+				// The sort keeps draws with the same effect, material and mesh next to each other
+				// (except for transparent ones at different depths, which must not be merged anyway)
+				bool canJoinPreviousRun = false;
+				if ( !s_drawRuns.empty() )
+				{
+					const sDrawPacket& previous = i_drawPackets[s_renderQueue.GetDrawIndex( s_drawRuns.back().firstDraw )];
+					canJoinPreviousRun = ( previous.flags & isInstanced ) &&
+						( previous.effectSortId == drawPacket.effectSortId ) &&
+						( previous.materialSortId == drawPacket.materialSortId ) &&
+						( previous.meshSortId == drawPacket.meshSortId );
+				}
+				if ( canJoinPreviousRun )
+				{
+					++s_drawRuns.back().drawCount;
+				}
+				else
+				{
+					const sDrawRun run = { static_cast<uint32_t>( j ), 1, static_cast<uint32_t>( s_instanceTransforms.size() ) };
+					s_drawRuns.push_back( run );
+				}
+				s_instanceTransforms.push_back( s_localToProjectedTransforms[i] );
+			}
+			else
+			{
+				const sDrawRun run = { static_cast<uint32_t>( j ), 1, 0 };
+				s_drawRuns.push_back( run );
+			}
+		}
+	}
+
+	void RecordDrawRuns( const std::vector<eae6320::Graphics::Renderable*>& i_renderableList, eae6320::Graphics::cCommandBuffer& o_commandBuffer )
+	{
+		const size_t runCount = s_drawRuns.size();
+		for ( size_t j = 0; j < runCount; ++j )
+		{
+			const sDrawRun& run = s_drawRuns[j];
+			// Every renderable in a run uses the same files, so the first one stands in for all of them
+			const uint32_t i = s_renderQueue.GetDrawIndex( run.firstDraw );
+			eae6320::Graphics::Renderable& toRender = *i_renderableList[i];
+			o_commandBuffer.BindEffect( toRender.m_material.m_effect );
+			o_commandBuffer.BindMaterialConstants( toRender.m_material );
+			o_commandBuffer.SetTexture( toRender.m_material );
+			if ( toRender.m_material.m_effect.m_isInstanced )
+			{
+				// The transforms are already in the instance buffer
+				o_commandBuffer.DrawMeshInstanced( toRender.m_mesh, run.firstInstance, run.drawCount );
+			}
+			else
+			{
+				// The localToWorld matrix was generated with the rest of the batch,
+				// but quantized positions have to be expanded back into local space first
+				if ( toRender.m_mesh.m_vertexFormat == eae6320::Graphics::floatVertices )
+				{
+					o_commandBuffer.SetDrawCallTransform( toRender.m_material.m_effect, s_localToWorldTransforms[i] );
+				}
+				else
+				{
+					o_commandBuffer.SetDrawCallTransform( toRender.m_material.m_effect,
+						toRender.m_mesh.m_dequantizeTransform * s_localToWorldTransforms[i] );
+				}
+				o_commandBuffer.DrawMesh( toRender.m_mesh );
+			}
+		}
+	}
+
+	uint16_t GetSortId( const char* const i_path, std::map<std::string, uint16_t>& io_sortIds )
+	{
+		const std::map<std::string, uint16_t>::const_iterator existingId = io_sortIds.find( i_path );
+		if ( existingId != io_sortIds.end() )
+		{
+			return existingId->second;
+		}
+		const uint16_t newId = static_cast<uint16_t>( io_sortIds.size() );
+		io_sortIds[i_path] = newId;
+		return newId;
+	}
+
+	template<typename tKey, typename tEntry, typename tAsset>
+	bool ShareCachedAsset( std::map<tKey, tEntry>& io_cache, const tKey& i_key, const eae6320::Graphics::eAssetType i_type, tAsset& o_asset )
+	{
+		const typename std::map<tKey, tEntry>::iterator entry = io_cache.find( i_key );
+		if ( entry == io_cache.end() )
+		{
+			++s_assetCacheStatistics[i_type].misses;
+			return false;
+		}
+		++entry->second.referenceCount;
+		++s_assetCacheStatistics[i_type].hits;
+		o_asset = entry->second.asset;
+		return true;
+	}
+
+	template<typename tKey, typename tEntry, typename tAsset>
+	tEntry& CacheAsset( std::map<tKey, tEntry>& io_cache, const tKey& i_key, const eae6320::Graphics::eAssetType i_type,
+		const tAsset& i_asset, const uint64_t i_byteCount )
+	{
+		tEntry& entry = io_cache[i_key];
+		entry.asset = i_asset;
+		entry.referenceCount = 1;
+		entry.byteCount = i_byteCount;
+		++s_assetCacheStatistics[i_type].loadedCount;
+		s_assetCacheStatistics[i_type].loadedBytes += i_byteCount;
+		return entry;
+	}
+
+	template<typename tKey, typename tEntry>
+	bool ReleaseCachedAsset( std::map<tKey, tEntry>& io_cache, const tKey& i_key, const eae6320::Graphics::eAssetType i_type, tEntry& o_entry )
+	{
+		const typename std::map<tKey, tEntry>::iterator entry = io_cache.find( i_key );
+		// UnloadAllAssets() might already have destroyed it
+		if ( entry == io_cache.end() )
+		{
+			return false;
+		}
+		if ( --entry->second.referenceCount > 0 )
+		{
+			return false;
+		}
+		o_entry = std::move( entry->second );
+		io_cache.erase( entry );
+		--s_assetCacheStatistics[i_type].loadedCount;
+		s_assetCacheStatistics[i_type].loadedBytes -= o_entry.byteCount;
+		return true;
+	}
+
+	void ReleaseEffect( const uint16_t i_sortId )
+	{
+		sCachedAsset<eae6320::Graphics::Effect> effect;
+		if ( ReleaseCachedAsset( s_cachedEffects, i_sortId, eae6320::Graphics::effectAsset, effect ) )
+		{
+			eae6320::Graphics::DestroyEffect( effect.asset );
+		}
+	}
+
+	void ReleaseTexture( const std::string& i_path )
+	{
+		sCachedAsset<tTexture> texture;
+		if ( ReleaseCachedAsset( s_cachedTextures, i_path, eae6320::Graphics::textureAsset, texture ) )
+		{
+			// Textures are loaded into materials and so that is also how they are destroyed
+			eae6320::Graphics::Material material;
+			material.m_3dTexture = texture.asset;
+			eae6320::Graphics::DestroyTexture( material );
+		}
+	}
+
+	void DestroyMaterial( eae6320::Graphics::Material& io_material )
+	{
+		eae6320::Graphics::DestroyMaterialConstants( io_material );
+		delete[] io_material.m_uniforms;
+		io_material.m_uniforms = NULL;
+		delete[] io_material.m_constants;
+		io_material.m_constants = NULL;
+		delete io_material.m_areConstantsDirty;
+		io_material.m_areConstantsDirty = NULL;
+	}
+
+	void ReleaseMaterialAssets( const bool i_hasEffect, const uint16_t i_effectSortId, const std::string& i_texturePath )
+	{
+		if ( i_hasEffect )
+		{
+			ReleaseEffect( i_effectSortId );
+		}
+		if ( !i_texturePath.empty() )
+		{
+			ReleaseTexture( i_texturePath );
+		}
+	}
+
+	bool LoadRenderable( const char* const i_meshPath, const char* const i_materialPath, eae6320::Graphics::Renderable& io_renderable )
+	{
+		if ( !eae6320::Graphics::LoadMesh( i_meshPath, io_renderable.m_mesh ) )
+		{
+			return false;
+		}
+		if ( !eae6320::Graphics::LoadMaterial( i_materialPath, io_renderable.m_material ) )
+		{
+			eae6320::Graphics::UnloadMesh( io_renderable.m_mesh );
+			return false;
+		}
+		return true;
+	}
+
+	void UploadStreamedRenderables()
+	{
+		const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+		// Loads are only taken from the streamer once there is room for them,
+		// so that no more than s_maxStreamingUploadsPerFrame of them wait for the render thread at a time
+		size_t queuedCount;
+		{
+			std::lock_guard<std::mutex> lock( s_uploadMutex );
+			if ( s_loadsToUpload.size() < s_maxStreamingUploadsPerFrame )
+			{
+				s_assetStreamer.TakeReadyLoads( s_maxStreamingUploadsPerFrame - s_loadsToUpload.size(), s_loadsToUpload );
+			}
+			queuedCount = s_loadsToUpload.size();
+			s_areLoadsWaitingForUpload.store( queuedCount > 0, std::memory_order_release );
+		}
+		if ( ( queuedCount > 0 ) && !eae6320::Graphics::IsRenderThreadRunning() )
+		{
+			UploadQueuedLoads();
+			queuedCount = 0;
+		}
+		const size_t uploadedCount = PublishUploadedLoads();
+
+		size_t readingCount, readyCount;
+		s_assetStreamer.GetLoadCounts( readingCount, readyCount );
+		s_streamingStatistics.readingLoads = static_cast<uint32_t>( readingCount );
+		s_streamingStatistics.waitingLoads = static_cast<uint32_t>( readyCount + queuedCount );
+		s_streamingStatistics.uploadedLoads = static_cast<uint32_t>( uploadedCount );
+		s_streamingStatistics.stallMilliseconds = std::chrono::duration<float, std::milli>( std::chrono::steady_clock::now() - startTime ).count();
+	}
+
+	void UploadQueuedLoads()
+	{
+		std::vector<eae6320::Graphics::cAssetStreamer::sLoad*> loads;
+		{
+			std::lock_guard<std::mutex> lock( s_uploadMutex );
+			loads.swap( s_loadsToUpload );
+			s_areLoadsWaitingForUpload.store( false, std::memory_order_release );
+		}
+		for ( eae6320::Graphics::cAssetStreamer::sLoad* const load : loads )
+		{
+			// The graphics objects are created without the lock so that the game thread can take its snapshot meanwhile
+			eae6320::Graphics::Renderable& renderable = *load->renderable;
+			s_preloadedFiles = &load->files;
+			const bool wasLoaded = LoadRenderable( load->meshPath.c_str(), load->materialPath.c_str(), renderable );
+			s_preloadedFiles = NULL;
+			{
+				std::lock_guard<std::mutex> lock( s_uploadMutex );
+				if ( wasLoaded )
+				{
+					s_renderableList.push_back( &renderable );
+					s_drawPackets.push_back( CreateDrawPacket( renderable ) );
+				}
+				const sUploadedLoad uploadedLoad = { load->handle, wasLoaded ? eae6320::Graphics::loadSucceeded : eae6320::Graphics::loadFailed };
+				s_uploadedLoads.push_back( uploadedLoad );
+			}
+			// This closes any files that weren't used
+			delete load;
+		}
+	}
+
+	size_t PublishUploadedLoads()
+	{
+		std::vector<sUploadedLoad> uploadedLoads;
+		{
+			std::lock_guard<std::mutex> lock( s_uploadMutex );
+			uploadedLoads.swap( s_uploadedLoads );
+		}
+		for ( const sUploadedLoad& uploadedLoad : uploadedLoads )
+		{
+			SetLoadState( uploadedLoad.handle, uploadedLoad.state );
+		}
+		return uploadedLoads.size();
+	}
+
+	bool AreRenderablesBeingStreamed()
+	{
+		size_t readingCount, readyCount;
+		s_assetStreamer.GetLoadCounts( readingCount, readyCount );
+		std::lock_guard<std::mutex> lock( s_uploadMutex );
+		return ( readingCount + readyCount + s_loadsToUpload.size() ) > 0;
+	}
+
+	void SetLoadState( const eae6320::Graphics::tLoadHandle i_handle, const eae6320::Graphics::eLoadState i_state )
+	{
+		const std::map<eae6320::Graphics::tLoadHandle, eae6320::Graphics::eLoadState>::iterator loadState = s_loadStates.find( i_handle );
+		if ( loadState != s_loadStates.end() )
+		{
+			loadState->second = i_state;
+		}
+	}
+
+	void RenderThreadMain()
+	{
+		if ( !eae6320::Graphics::MakeContextCurrent() )
+		{
+			s_renderThreadState.store( failedToStart );
+			WakeRenderThreadWaiter( s_renderThreadWorkFinished );
+			return;
+		}
+		s_renderThreadState.store( running );
+		WakeRenderThreadWaiter( s_renderThreadWorkFinished );
+
+		uint32_t renderedSnapshotCount = s_renderedSnapshotCount.load();
+		while ( true )
+		{
+			const std::function<void()>* const task = s_renderThreadTask.load( std::memory_order_acquire );
+			if ( task )
+			{
+				( *task )();
+				s_renderThreadTask.store( NULL, std::memory_order_release );
+				WakeRenderThreadWaiter( s_renderThreadWorkFinished );
+			}
+			// Nothing waits for the uploads, and so the game thread can go on with the next frame while they are done
+			else if ( s_areLoadsWaitingForUpload.load( std::memory_order_acquire ) )
+			{
+				UploadQueuedLoads();
+			}
+			else if ( s_publishedSnapshotCount.load( std::memory_order_acquire ) != renderedSnapshotCount )
+			{
+				RenderSnapshot( s_frameSnapshots[renderedSnapshotCount % 2] );
+				s_renderedSnapshotCount.store( ++renderedSnapshotCount, std::memory_order_release );
+				WakeRenderThreadWaiter( s_renderThreadWorkFinished );
+			}
+			// The thread is only told to exit after every snapshot has been handed to it
+			else if ( s_shouldRenderThreadExit.load() )
+			{
+				break;
+			}
+			else
+			{
+				WaitForRenderThreadCondition( s_renderThreadWorkAdded, [&]()
+				{
+					return ( s_renderThreadTask.load( std::memory_order_acquire ) != NULL )
+						|| s_areLoadsWaitingForUpload.load( std::memory_order_acquire )
+						|| ( s_publishedSnapshotCount.load( std::memory_order_acquire ) != renderedSnapshotCount )
+						|| s_shouldRenderThreadExit.load();
+				} );
+			}
+		}
+
+		eae6320::Graphics::ReleaseContext();
+	}
+
+	void RunOnRenderThread( const std::function<void()>& i_task )
+	{
+		if ( !eae6320::Graphics::IsRenderThreadRunning() )
+		{
+			i_task();
+			return;
+		}
+		// The snapshots that have already been handed over were taken from the renderable list as it is now,
+		// and they might use whatever the task changes
+		WaitForRenderedSnapshots( s_publishedSnapshotCount.load( std::memory_order_relaxed ) );
+		s_renderThreadTask.store( &i_task, std::memory_order_release );
+		WakeRenderThreadWaiter( s_renderThreadWorkAdded );
+		WaitForRenderThreadCondition( s_renderThreadWorkFinished, []() { return s_renderThreadTask.load( std::memory_order_acquire ) == NULL; } );
+	}
+
+	eae6320::Graphics::cWorkerPool& GetWorkerPool()
+	{
+		if ( !s_isWorkerPoolInitialized )
+		{
+			s_workerPool.Initialize( 0 );
+			s_isWorkerPoolInitialized = true;
+		}
+		return s_workerPool;
+	}
+
+	void WaitForRenderedSnapshots( const uint32_t i_snapshotCount )
+	{
+		// The counts only ever increase (and the difference stays correct when they wrap)
+		WaitForRenderThreadCondition( s_renderThreadWorkFinished, [=]()
+		{
+			return static_cast<int32_t>( i_snapshotCount - s_renderedSnapshotCount.load( std::memory_order_acquire ) ) <= 0;
+		} );
+	}
+
+	template<typename tPredicate>
+	void WaitForRenderThreadCondition( std::condition_variable& io_condition, const tPredicate& i_isDone )
+	{
+		// The other thread is usually about to finish, and then it is quicker not to sleep
+		for ( unsigned int i = 0; i < s_spinCount; ++i )
+		{
+			if ( i_isDone() )
+			{
+				return;
+			}
+			std::this_thread::yield();
+		}
+		std::unique_lock<std::mutex> lock( s_renderThreadMutex );
+		io_condition.wait( lock, i_isDone );
+	}
+
+	void WakeRenderThreadWaiter( std::condition_variable& io_condition )
+	{
+		// The waiting thread checks its condition with the mutex locked and only unlocks it once it is asleep,
+		// and so locking it here makes sure that the waiter either already sees the change or gets woken up
+		{
+			std::lock_guard<std::mutex> lock( s_renderThreadMutex );
+		}
+		io_condition.notify_one();
+	}
+}
@@ -17,8 +17,15 @@
 #include <d3d9.h>
 #include <d3dx9shader.h>
 #elif defined(EAE6320_PLATFORM_GL)
+#if defined(_WIN32)
 #include <gl/GL.h>
 #include <gl/GLU.h>
+#else
+//OpenGlExtensions provides its own glext.h
+#define GL_GLEXT_LEGACY
+#include <GL/gl.h>
+#include <GL/glu.h>
+#endif
 #endif
 
 // Interface
@@ -29,9 +36,44 @@ namespace eae6320
 	namespace Graphics
 	{
 		class Renderable;
+		class cCommandBuffer;
+		class cMappedFile;
+
+		//Bounding volumes in the mesh's local space.
+		//The MeshBuilder calculates these and they are stored in the .lmesh file right after the vertex format.
+		struct sMeshBounds
+		{
+			float sphereCenter[3];
+			float sphereRadius;
+			float aabbMin[3];
+			float aabbMax[3];
+		};
+
+		//How the vertices are laid out in a .lmesh file (and in the vertex buffer).
+		//The MeshBuilder writes this right after the counts
+		//and only uses the quantized formats when it is given the "quantized" argument.
+		enum eVertexFormat : uint32_t
+		{
+			//sVertex (24 bytes)
+			floatVertices,
+			//sVertex_quantized (16 bytes)
+			quantizedVertices,
+			//sVertex_quantized without the color (12 bytes)
+			//This is only built for OpenGL, where the shader gets opaque white instead.
+			quantizedVerticesNoColor,
+		};
+
 		struct Mesh 
 		{
 			uint32_t m_noOfIndices, m_noOfVertices;
+			sMeshBounds m_bounds;
+			eVertexFormat m_vertexFormat = floatVertices;
+			//Every mesh loaded from the same file gets the same ID (see cRenderQueue)
+			//and shares the same buffers
+			uint16_t m_sortId = 0;
+			//Quantized positions are [0,1] across the AABB;
+			//this scales and offsets them back into local space and is concatenated in front of localToWorld.
+			eae6320::Math::cMatrix_transformation m_dequantizeTransform;
 			//Mesh structure for Direct X
 #if defined(EAE6320_PLATFORM_D3D)
 			IDirect3DVertexBuffer9* m_vertexBuffer = NULL;
@@ -48,6 +90,10 @@ namespace eae6320
 			//Mesh structure for OpenGL
 #elif defined(EAE6320_PLATFORM_GL)
 			GLuint m_vertexArrayID;
+
+			//Mesh structure for the null platform (nothing is created, so the mesh is only identified)
+#elif defined(EAE6320_PLATFORM_NULL)
+			uint32_t m_vertexArrayID = 0;
 #endif
 		};
 
@@ -63,15 +109,24 @@ namespace eae6320
 		struct Effect
 		{
 			uint8_t m_renderStates;
+			//Every effect loaded from the same file gets the same ID (see cRenderQueue)
+			uint16_t m_sortId = 0;
+			//Instanced effects read their transform from the instance buffer instead of a uniform,
+			//so draws that share a mesh and material can be made with a single draw call
+			//(only the OpenGL code supports this)
+			bool m_isInstanced = false;
 #if defined(EAE6320_PLATFORM_D3D)
 			//Effect structure for DirectX.
 			IDirect3DVertexShader9 *m_vertexShader				= NULL;
 			IDirect3DPixelShader9 *m_pixelShader				= NULL;
-			ID3DXConstantTable *vertexShaderConstantTable;
-			ID3DXConstantTable *fragmentShaderConstantTable;
+			ID3DXConstantTable *vertexShaderConstantTable		= NULL;
+			ID3DXConstantTable *fragmentShaderConstantTable	= NULL;
 			D3DXHANDLE localToWorld								= NULL;
 			D3DXHANDLE worldToView								= NULL;
 			D3DXHANDLE viewToScreen								= NULL;
+			//If the shader declares this the three transforms are concatenated on the CPU instead.
+			D3DXHANDLE localToProjected							= NULL;
+			D3DXHANDLE worldToProjected							= NULL;
 			~Effect()
 			{
 				//m_vertexShader->Release();
@@ -84,8 +139,14 @@ namespace eae6320
 #elif defined(EAE6320_PLATFORM_GL)
 			GLuint m_programID	= 0;
 			GLint localToWorld	= -1;
-			GLint worldToView	= -1;
-			GLint viewToScreen	= -1;
+			//If the shader declares this the three transforms are concatenated on the CPU instead.
+			GLint localToProjected	= -1;
+			//Whether the program reads the per-frame transforms from the g_viewConstants uniform block
+			bool m_usesViewConstants	= false;
+
+			//Effect structure for the null platform.
+#elif defined(EAE6320_PLATFORM_NULL)
+			uint32_t m_programID	= 0;
 #endif
 		};
 		
@@ -104,17 +165,45 @@ namespace eae6320
 			// Offset = 20
 #if defined(EAE6320_PLATFORM_D3D)
 			uint8_t b, g, r, a;	// 8 bits [0,255] per RGBA channel (the alpha channel is unused but is present so that color uses a full 4 bytes)
-#elif defined(EAE6320_PLATFORM_GL)
+#elif defined(EAE6320_PLATFORM_GL) || defined(EAE6320_PLATFORM_NULL)
 			uint8_t r, g, b, a;	// 8 bits [0,255] per RGBA channel (the alpha channel is unused but is present so that color uses a full 4 bytes)
 #endif
 		};
 
+		//The compact layout for built meshes.
+		//Positions are stored relative to the mesh's AABB and are expanded by Mesh::m_dequantizeTransform,
+		//and the texture coordinates must be in [0,1].
+		struct sVertex_quantized
+		{
+			// POSITION
+			// 4 uint16_ts == 8 bytes (normalized; w is always 1 and is only there for alignment)
+			// Offset = 0
+			uint16_t x, y, z, w;
+			// TEXTURE COORDINATES
+			// 2 uint16_ts == 4 bytes (normalized)
+			// Offset = 8
+			uint16_t u, v;
+			// COLOR0
+			// 4 uint8_ts == 4 bytes (left out of each vertex by quantizedVerticesNoColor)
+			// Offset = 12
+#if defined(EAE6320_PLATFORM_D3D)
+			uint8_t b, g, r, a;
+#elif defined(EAE6320_PLATFORM_GL) || defined(EAE6320_PLATFORM_NULL)
+			uint8_t r, g, b, a;
+#endif
+		};
+
 		struct Context
 		{
 #if defined(EAE6320_PLATFORM_D3D)
 			IDirect3DDevice9* m_direct3dDevice;
-#elif defined(EAE6320_PLATFORM_GL)
+#elif defined(EAE6320_PLATFORM_GL) && defined(_WIN32)
 			HGLRC m_openGlRenderingContext;
+#elif defined(EAE6320_PLATFORM_GL)
+			//An EGLContext
+			void* m_openGlRenderingContext;
+#elif defined(EAE6320_PLATFORM_NULL)
+			void* m_unused;
 #endif
 		};
 
@@ -126,6 +215,8 @@ namespace eae6320
 			const char*
 #elif defined( EAE6320_PLATFORM_GL )
 			GLint
+#elif defined( EAE6320_PLATFORM_NULL )
+			int32_t
 #endif
 			tUniformHandle;
 
@@ -140,6 +231,8 @@ namespace eae6320
 			float values[4];
 			uint8_t valueCountToSet;
 			eShaderType shaderType;
+			//Where the value is in the material's constant block (MaterialBuilder bakes this using the std140 rules)
+			uint16_t blockOffset;
 		};
 
 		//Material struct decleration
@@ -148,46 +241,315 @@ namespace eae6320
 			Effect m_effect;
 			sUniformHelper* m_uniforms = NULL;
 			uint8_t m_noOfUniforms;
+			//Every material loaded from the same file gets the same ID (see cRenderQueue)
+			uint16_t m_sortId = 0;
+			//The unit that the texture is bound to, which belongs to the effect's sampler rather than to the draw
+			//(so materials that share a sampler share a unit and only the texture has to change between them)
+			uint8_t m_textureUnit = 0;
+			//Every uniform's values laid out as a std140 block, exactly as it is uploaded
+			uint8_t* m_constants = NULL;
+			uint16_t m_constantsSize = 0;
+			//Set by SetMaterialConstant(); the values are only uploaded again the next time the material is bound.
+			//Every renderable that loads the material gets a copy of it that shares the same constants and graphics objects,
+			//and so this is shared too (whichever copy is bound first uploads the values for all of them)
+			bool* m_areConstantsDirty = NULL;
 #if defined(EAE6320_PLATFORM_D3D)
 			IDirect3DTexture9* m_3dTexture;
 			DWORD m_texHandle;
 #elif defined(EAE6320_PLATFORM_GL)
 			GLuint m_3dTexture;
 			GLint m_texHandle;
+			//Zero if the effect doesn't declare a g_materialConstants block
+			//(the uniforms are then set one at a time instead)
+			GLuint m_constantBufferId = 0;
+#elif defined(EAE6320_PLATFORM_NULL)
+			uint32_t m_3dTexture = 0;
+			int32_t m_texHandle = -1;
+			//Every material is treated like an OpenGL one with a g_materialConstants block
+			uint32_t m_constantBufferId = 0;
 #endif
 		};
 
+		//Everything that only depends on the camera
+		//(it is calculated once per frame and then shared by every draw call)
+		struct sViewConstants
+		{
+			Math::cMatrix_transformation worldToView;
+			Math::cMatrix_transformation viewToScreen;
+			Math::cMatrix_transformation worldToProjected;
+		};
+
+		//Counted while a frame is being rendered (they are reset by BeginScene())
+		struct sFrameStatistics
+		{
+			uint32_t drawCalls;
+			//State-setting API calls that were made
+			uint32_t stateChanges;
+			//State-setting API calls that were skipped because the state was already set
+			//(the Direct3D code only filters texture binds and material constants)
+			uint32_t redundantStateChanges;
+			//Textures that were bound, and those that were skipped because the unit already had them
+			//(these are also counted in the state changes above)
+			uint32_t textureBinds;
+			uint32_t redundantTextureBinds;
+			//Constants, uniforms and instance transforms that were sent to the GPU
+			//(only the null platform counts these)
+			uint32_t uploadedBytes;
+			//API errors that the error checks found (see SetErrorCheckMode())
+			uint32_t apiErrors;
+		};
+
+		//How the graphics API is checked for errors while it renders
+		//(loading always checks its calls, because it reports what failed)
+		enum eErrorCheckMode : uint8_t
+		{
+			//Nothing is checked
+			//(this is the default in Release builds)
+			errorChecksOff,
+			//glGetError() is called once after every frame, in EndScene()
+			//(this is the default in Debug builds)
+			errorChecksPerFrame,
+			//glGetError() is called after every call, which says exactly where an error happened
+			//but makes many drivers wait for the GPU every time
+			errorChecksPerCall,
+			//The driver reports errors to a GL_KHR_debug callback as soon as they happen
+			errorChecksDebugOutput,
+		};
+
+		//What loading assets has cost since the program started
+		struct sLoadStatistics
+		{
+			uint32_t fileCount;
+			//How many of those files were found in the asset pack instead of being opened one at a time
+			uint32_t packedFileCount;
+			//The size of every file that was opened, as it is stored
+			//(which for compressed files is the compressed size)
+			uint64_t fileBytes;
+			//Bytes that the CPU copied while loading
+			//(reading a file into memory counts, mapping it doesn't,
+			//and neither does the copy that the graphics API makes when a buffer or texture is created)
+			uint64_t copiedBytes;
+			//How many of the files were compressed, and how many bytes decompressing them produced
+			uint32_t compressedFileCount;
+			uint64_t decompressedBytes;
+		};
+
+		//Loading renderables asynchronously (see AddRenderableAsync())
+		typedef uint32_t tLoadHandle;
+		enum eLoadState : uint8_t
+		{
+			loadPending,
+			loadSucceeded,
+			loadFailed,
+			loadCanceled,
+		};
+		//What streaming did during the last Render()
+		struct sStreamingStatistics
+		{
+			//Loads whose files were still being read, and those that were read but whose graphics objects hadn't been created yet
+			uint32_t readingLoads;
+			uint32_t waitingLoads;
+			//Loads whose graphics objects were created (and whose renderables started being drawn) since the last Render()
+			uint32_t uploadedLoads;
+			//How long Render() was held up by streaming
+			//(the render thread creates the graphics objects between frames, and so this is only long without it)
+			float stallMilliseconds;
+		};
+
+		//Every asset is only loaded once and is then shared by everything that loads it again
+		//(see LoadMesh() and LoadMaterial())
+		enum eAssetType : uint8_t
+		{
+			meshAsset,
+			effectAsset,
+			materialAsset,
+			textureAsset,
+			assetTypeCount,
+		};
+		struct sAssetCacheStatistics
+		{
+			//Loads that shared an asset that was already loaded, and those that had to load it
+			uint32_t hits;
+			uint32_t misses;
+			//Assets that are loaded now (an asset is only counted once however many renderables share it)
+			uint32_t loadedCount;
+			//Roughly how much memory they use:
+			//the size of the meshes' buffers, of the effect and texture files, and of the materials' uniforms and constants
+			uint64_t loadedBytes;
+		};
+
+#if defined(EAE6320_PLATFORM_NULL)
+		//Everything that the null platform has been asked to create since it was initialized
+		//(it doesn't create anything, so this is only counted)
+		struct sResourceStatistics
+		{
+			uint32_t meshCount;
+			uint32_t effectCount;
+			uint32_t materialCount;
+			uint64_t vertexBufferBytes;
+			uint64_t indexBufferBytes;
+			uint64_t textureBytes;
+		};
+#endif
+
 		bool Initialize( const HWND i_renderingWindow );
+		//This copies every renderable's transform and the camera into a snapshot,
+		//and then records the snapshot into a command buffer and executes it.
+		//If the render thread is running the snapshot is handed to it instead
+		//(this only waits if the render thread hasn't finished the frame before the previous one,
+		//so the game can simulate the next frame while the last one is rendered but can never be more than one frame ahead)
 		void Render();
+		//This must be called after StopRenderThread()
 		bool ShutDown();
 
+		//Rendering on a thread of its own is optional; without it Render() does all of the work.
+		//While the render thread is running:
+		//	* AddRenderable(), RemoveRenderable() and SetMaterialConstant() are run on it between frames
+		//		(after the frames that it has already been given are finished, so they should be rare)
+		//	* GetFrameStatistics() and GetFrameCommands() belong to it and shouldn't be read until it is stopped
+		bool StartRenderThread();
+		//Every frame that has been given to the render thread is finished first
+		void StopRenderThread();
+		bool IsRenderThreadRunning();
+		//How long it was from the last presented frame's Render() until it was presented (in seconds).
+		//With the render thread this includes the time that the snapshot waited for it.
+		float GetFrameLatency();
+		//The transforms, culling and sort keys are built in chunks by this many threads
+		//(including the one that renders, and zero means one per core, which is also what is used if this isn't called).
+		//The draw list is exactly the same no matter how many threads build it
+		bool SetDrawListThreadCount(const size_t i_threadCount);
+		//This is zero until the first frame if SetDrawListThreadCount() wasn't called
+		size_t GetDrawListThreadCount();
+		//Only the thread that the context is current on can use the graphics API;
+		//Initialize() makes it current on the calling thread and StartRenderThread() moves it to the render thread
+		bool MakeContextCurrent();
+		void ReleaseContext();
+		//This returns false if the platform can't check errors in that way
+		//(only OpenGL checks for errors at all, and the other platforms only accept errorChecksOff;
+		//errorChecksPerCall is only compiled into Release builds if EAE6320_GRAPHICS_GL_PER_CALL_CHECKS is defined).
+		//Only the first error after the mode is set is reported, and the rest are only counted in the frame statistics
+		bool SetErrorCheckMode(const eErrorCheckMode i_mode);
+		eErrorCheckMode GetErrorCheckMode();
+		//Replays every recorded command through the functions below, in order
+		//(this must be called between BeginScene() and EndScene())
+		void ExecuteCommandBuffer(const cCommandBuffer& i_commandBuffer);
+
 		//Functions that load and draw meshes and other auxillary functions.
 		void DrawMesh( const Mesh& i_mesh );
+		//Draws i_instanceCount copies of the mesh using the transforms set by SetInstanceTransforms(),
+		//starting at i_firstInstance.
+		void DrawMeshInstanced( const Mesh& i_mesh, const size_t i_firstInstance, const size_t i_instanceCount );
+		//A mesh that is already loaded is shared instead of being loaded again (meshes are found by their paths),
+		//and its buffers are only destroyed once everything that loaded it has unloaded it
 		bool LoadMesh(const char* const i_path, Mesh& i_mesh );
-		bool CreateBuffers(sVertex*& i_vertexData, int i_numOfVertices, uint32_t*& i_indexData, int i_numOfIndices, Mesh& i_mesh );
+		void UnloadMesh(const Mesh& i_mesh);
+		//i_vertexData must be laid out as i_mesh.m_vertexFormat says.
+		//The data is uploaded from where it is (usually straight out of the mapped mesh file) and isn't kept.
+		bool CreateBuffers(const uint8_t* const i_vertexData, int i_numOfVertices, const uint32_t* const i_indexData, int i_numOfIndices, Mesh& i_mesh );
+		//UnloadMesh() calls this once nothing shares the mesh anymore
+		void DestroyBuffers(Mesh& io_mesh);
+		size_t GetVertexStride(const eVertexFormat i_vertexFormat);
 
 		//Functions that load and bind effects and other auxillary functions.
 		bool LoadEffect(const char* const i_effectPath, Effect& i_effect);
+		//UnloadMaterial() calls this once no material shares the effect anymore
+		void DestroyEffect(Effect& io_effect);
 		bool BindEffect(Effect& i_effect);
 
 		//Functions that deal with Materials
+		//A material that is already loaded is shared instead of being loaded again, along with its constants,
+		//and so is an effect or texture that another material already loaded (all of them are found by their paths).
+		//Nothing is destroyed until everything that loaded it has unloaded it
 		bool LoadMaterial(const char* const i_path, Material& i_material);
+		void UnloadMaterial(const Material& i_material);
 		bool LoadTexture(const char* const i_path, Material& i_material);
+		//UnloadMaterial() calls this once no material shares the texture anymore
+		void DestroyTexture(Material& io_material);
+		//This also assigns the material's texture unit
 		bool LoadSamplerID(const char* const i_uniformName, Material& i_material);
-		bool SetTexture(Material& i_material, int i_offset);
+		bool SetTexture(Material& i_material);
 
 		//Functions that deal with the uniforms.
+		//This must be called once per frame before any draw calls are made
+		void SetViewConstants(const sViewConstants& i_viewConstants);
 		bool SetDrawCallUniforms(Effect& i_effect, eae6320::Math::cMatrix_transformation& i_offsetMatrix);
+		//The localToProjected transform of every instance that will be drawn this frame
+		//(this must be called once per frame before any instanced draw calls are made)
+		void SetInstanceTransforms(const eae6320::Math::cMatrix_transformation* const i_transforms, const size_t i_count);
 		tUniformHandle GetUniform(Effect& i_effect, const char* const i_uniformName, eShaderType i_shaderType);
 		void SetMaterialUniform(const Effect& i_effect, float i_values[], uint8_t i_valueCountToSet, tUniformHandle i_uniformHandle, eShaderType i_shaderType);
+		//Uploads the material's constant block (or gets its uniforms' handles) once when the material is loaded.
+		//i_uniformNames are in the same order as the material's uniforms.
+		bool CreateMaterialConstants(Material& io_material, const char* const* const i_uniformNames);
+		//Destroys what CreateMaterialConstants() created (the uniforms and constants are deleted by UnloadMaterial())
+		void DestroyMaterialConstants(Material& io_material);
+		//The effect must already be bound.
+		//This does nothing if the material's constants are already bound and haven't changed.
+		void BindMaterialConstants(Material& io_material);
+		//Changes a uniform's values at runtime (i_uniformIndex is the uniform's position in the material file).
+		//i_values must have as many floats as the material file gave the uniform.
+		//Every renderable that shares the material is changed.
+		bool SetMaterialConstant(Material& io_material, const uint8_t i_uniformIndex, const float* const i_values);
 
 		//Accessor Functions.
 		void AddRenderable(const char* const i_pathMesh, const char* const i_pathEffect, eae6320::Graphics::Renderable *i_renderable);
 		void RemoveRenderable(eae6320::Graphics::Renderable *i_renderable);
-		std::vector<Renderable*>* GetOpaqueRenderableList();
-		std::vector<Renderable*>* GetTransparentRenderableList();
+		//Opaque and transparent renderables share one list; Render() sorts them every frame.
+		//While the render thread is running it appends streamed renderables to the list,
+		//and so the list can't be read then unless nothing is being streamed in.
+		std::vector<Renderable*>* GetRenderableList();
+		//This returns straight away instead of loading while the game waits:
+		//the files are opened and read on a streaming thread,
+		//and then a later Render() creates the graphics objects (or has the render thread create them between frames)
+		//and the renderable starts being drawn.
+		//Only the objects of a few renderables are created per frame (see SetMaxStreamingUploadsPerFrame()),
+		//and a renderable whose files couldn't be loaded is never drawn.
+		//Removing the renderable before it is drawn cancels the load.
+		//This, GetLoadState() and Render() must all be called from the same thread.
+		tLoadHandle AddRenderableAsync(const char* const i_pathMesh, const char* const i_pathMaterial, Renderable *i_renderable);
+		eLoadState GetLoadState(const tLoadHandle i_handle);
+		//A load's state is kept until its handle is released, and after that the handle is reported as having failed.
+		//Releasing the handle of a load that hasn't finished doesn't cancel it (see RemoveRenderable() for that).
+		void ReleaseLoadHandle(const tLoadHandle i_handle);
+		//The default is one
+		void SetMaxStreamingUploadsPerFrame(const size_t i_maxUploadCount);
+		const sStreamingStatistics& GetStreamingStatistics();
+
+		//Asset files are memory-mapped and the graphics API reads from them directly.
+		//Every asset file is opened with this so that it is counted in the load statistics.
+		//A file that is in the asset pack is found there instead of being opened (see OpenAssetPack()),
+		//and a file that a builder compressed is decompressed (see AssetCompression.h) and so the loaders never see the compressed contents.
+		bool OpenAssetFile(const char* const i_path, cMappedFile& o_file);
+		//After this every asset that the pack has is loaded from it, and any that it doesn't have is still loaded from its own file.
+		//The pack is only mapped once and its assets are found by the hashes of their paths (see cAssetPack.h),
+		//and they are always mapped even if SetShouldReadAssetFilesIntoMemory() was called.
+		//A pack that is already open is closed first.
+		//Neither this nor CloseAssetPack() can be called while streamed renderables are loading
+		//(debug builds assert that every load has finished or been canceled)
+		bool OpenAssetPack(const char* const i_path);
+		void CloseAssetPack();
+		//Reading files into memory instead is how assets used to be loaded, and it is only there to compare the two
+		void SetShouldReadAssetFilesIntoMemory(const bool i_shouldReadAssetFilesIntoMemory);
+		//The render thread changes these statistics while it creates streamed renderables,
+		//and so they can't be read then unless nothing is being streamed in
+		const sLoadStatistics& GetLoadStatistics();
+		//Hits and misses since the program started, and what is loaded now
+		const sAssetCacheStatistics& GetAssetCacheStatistics(const eAssetType i_type);
+		//ShutDown() calls this to destroy every asset that is still loaded, whether or not anything still uses it
+		void UnloadAllAssets();
+		//ShutDown() calls this first to stop the streaming thread (which cancels every load that hasn't been uploaded)
+		//and the draw list's worker threads (the render thread must already have been stopped)
+		void StopWorkerThreads();
 
 		//Misc Functions
+		const sFrameStatistics& GetFrameStatistics();
+		//Everything that the last Render() submitted
+		const cCommandBuffer& GetFrameCommands();
+#if defined(EAE6320_PLATFORM_NULL)
+		const sResourceStatistics& GetResourceStatistics();
+#endif
+		//This is what SetErrorCheckMode() runs on the thread that renders
+		bool ApplyErrorCheckMode(const eErrorCheckMode i_mode);
 		void Clear();
 		void BeginScene();
 		void EndScene();
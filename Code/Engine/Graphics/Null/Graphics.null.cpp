@@ -0,0 +1,484 @@
+/*
+	This file implements the graphics interface without a GPU or a window
+
+	Assets are read and validated the same way that the OpenGL platform reads them,
+	and every draw goes through the same state filtering,
+	but nothing is ever created or drawn; only the counts and bytes are recorded.
+	It uses OpenGL's conventions everywhere else (e.g. its projected depth range and vertex color order).
+	This lets the CPU cost of Render() be measured (and regression-tested) on machines that have no display
+*/
+
+// Header Files
+//=============
+
+#include "../Graphics.h"
+#include "../cMappedFile.h"
+#include "../../UserOutput/UserOutput.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	HWND s_renderingWindow = NULL;
+	// There is no window to measure, so this is the aspect ratio of a typical one
+	const float s_aspectRatio = 16.0f / 9.0f;
+
+	eae6320::Graphics::sFrameStatistics s_frameStatistics;
+	eae6320::Graphics::sResourceStatistics s_resourceStatistics;
+	eae6320::Graphics::eErrorCheckMode s_errorCheckMode = eae6320::Graphics::errorChecksOff;
+
+	// Every "created" object gets the next handle
+	// (zero is never used, just like in OpenGL, so it can mean "nothing")
+	uint32_t s_nextHandle = 1;
+
+	// These are the same as on OpenGL so that the state changes are counted the same way
+	const uint32_t s_cachedTextureUnitCount = 32;
+	// This is the minimum that OpenGL 3.3 guarantees
+	const uint8_t s_maxTextureUnitCount = 48;
+	struct sStateCache
+	{
+		uint32_t program;
+		uint32_t vertexArray;
+		bool areRenderStatesKnown;
+		uint8_t renderStates;
+		uint32_t activeTextureUnit;
+		uint32_t boundTextures[s_cachedTextureUnitCount];
+		uint32_t materialConstantsBuffer;
+	};
+	sStateCache s_stateCache;
+	// Each program's samplers and whether their units have been set, which are given out the same way as on OpenGL.
+	// There is no shader to ask for locations, and so each distinct sampler name is given its own
+	// (which is the sampler's position in its program's list, the same as its unit)
+	struct sSamplerUnit
+	{
+		std::string name;
+		bool isSet;
+	};
+	std::map<uint32_t, std::vector<sSamplerUnit>> s_programSamplerUnits;
+
+	eae6320::Graphics::sViewConstants s_viewConstants;
+	// The last draw call's transform is kept so that calculating it can't be optimized away
+	eae6320::Math::cMatrix_transformation s_drawCallTransform;
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	void InvalidateStateCache();
+	void BindTexture(const uint32_t i_textureUnit, const uint32_t i_texture);
+	void BindMeshForDrawing(const eae6320::Graphics::Mesh& i_mesh);
+}
+
+// Interface
+//==========
+
+bool eae6320::Graphics::Initialize( const HWND i_renderingWindow )
+{
+	s_renderingWindow = i_renderingWindow;
+	s_resourceStatistics = sResourceStatistics();
+	s_frameStatistics = sFrameStatistics();
+	InvalidateStateCache();
+
+	return true;
+}
+
+bool eae6320::Graphics::CreateBuffers(const uint8_t* const i_vertexData, int i_numOfVertices, const uint32_t* const i_indexData, int i_numOfIndices, Mesh& i_mesh)
+{
+	if (i_vertexData == NULL || i_indexData == NULL)
+	{
+		eae6320::UserOutput::Print("The null platform was given a mesh without any data");
+		return false;
+	}
+	i_mesh.m_vertexArrayID = s_nextHandle++;
+	++s_resourceStatistics.meshCount;
+	s_resourceStatistics.vertexBufferBytes += i_numOfVertices * GetVertexStride(i_mesh.m_vertexFormat);
+	s_resourceStatistics.indexBufferBytes += i_numOfIndices * sizeof(uint32_t);
+
+	return true;
+}
+
+void eae6320::Graphics::DestroyBuffers(Mesh& io_mesh)
+{
+	//Handles are never reused, but OpenGL forgets that a deleted vertex array was bound and so this does too
+	if (s_stateCache.vertexArray == io_mesh.m_vertexArrayID)
+	{
+		s_stateCache.vertexArray = 0;
+	}
+	io_mesh.m_vertexArrayID = 0;
+}
+
+bool eae6320::Graphics::LoadEffect(const char* const i_effectPath, Effect& i_effect)
+{
+	bool wereThereErrors = false;
+	cMappedFile effectFile;
+	cMappedFile vertexShaderFile;
+	const char* vertexShaderPath = NULL;
+
+	//[render states][vertex shader path][fragment shader path]
+	if (!OpenAssetFile(i_effectPath, effectFile))
+	{
+		wereThereErrors = true;
+		goto OnExit;
+	}
+	i_effect.m_renderStates = *effectFile.GetContents();
+	vertexShaderPath = reinterpret_cast<const char*>(effectFile.GetContents() + 1);
+
+	//OpenGL asks the linked program whether it has the per-instance transform,
+	//and the shader source is the only place to find that out here.
+	//(The mapped source isn't NULL-terminated and so it is searched within its size.)
+	if (!OpenAssetFile(vertexShaderPath, vertexShaderFile))
+	{
+		wereThereErrors = true;
+		goto OnExit;
+	}
+	{
+		const char* const source = reinterpret_cast<const char*>(vertexShaderFile.GetContents());
+		const char* const sourceEnd = source + vertexShaderFile.GetSize();
+		const char* const instanceTransform = "i_transform_localToProjected";
+		i_effect.m_isInstanced = std::search(source, sourceEnd, instanceTransform, instanceTransform + strlen(instanceTransform)) != sourceEnd;
+	}
+	i_effect.m_programID = s_nextHandle++;
+	++s_resourceStatistics.effectCount;
+
+OnExit:
+
+	effectFile.Close();
+	vertexShaderFile.Close();
+
+	return !wereThereErrors;
+}
+
+void eae6320::Graphics::DestroyEffect(Effect& io_effect)
+{
+	if (s_stateCache.program == io_effect.m_programID)
+	{
+		s_stateCache.program = 0;
+	}
+	s_programSamplerUnits.erase(io_effect.m_programID);
+	io_effect.m_programID = 0;
+}
+
+bool eae6320::Graphics::LoadTexture(const char* const i_path, Material& i_material)
+{
+	//The texture is mapped (and counted in the load statistics) like OpenGL's, but its contents are never read
+	cMappedFile file;
+	if (!OpenAssetFile(i_path, file))
+	{
+		return false;
+	}
+	i_material.m_3dTexture = s_nextHandle++;
+	s_resourceStatistics.textureBytes += file.GetSize();
+
+	return true;
+}
+
+void eae6320::Graphics::DestroyTexture(Material& io_material)
+{
+	for (uint32_t i = 0; i < s_cachedTextureUnitCount; ++i)
+	{
+		if (s_stateCache.boundTextures[i] == io_material.m_3dTexture)
+		{
+			s_stateCache.boundTextures[i] = 0;
+		}
+	}
+	io_material.m_3dTexture = 0;
+}
+
+bool eae6320::Graphics::LoadSamplerID(const char* const i_uniformName, Material& i_material)
+{
+	//Every sampler gets a location, whether the shader uses it or not
+	std::vector<sSamplerUnit>& samplerUnits = s_programSamplerUnits[i_material.m_effect.m_programID];
+	for (size_t i = 0; i < samplerUnits.size(); ++i)
+	{
+		if (samplerUnits[i].name == i_uniformName)
+		{
+			i_material.m_texHandle = static_cast<int32_t>(i);
+			i_material.m_textureUnit = static_cast<uint8_t>(i);
+			return true;
+		}
+	}
+	if (samplerUnits.size() >= s_maxTextureUnitCount)
+	{
+		std::stringstream errorMessage;
+		errorMessage << "The sampler " << i_uniformName << " needs more than the " << static_cast<int>(s_maxTextureUnitCount) << " texture units that OpenGL guarantees";
+		eae6320::UserOutput::Print(errorMessage.str());
+		return false;
+	}
+	i_material.m_texHandle = static_cast<int32_t>(samplerUnits.size());
+	i_material.m_textureUnit = static_cast<uint8_t>(samplerUnits.size());
+	const sSamplerUnit samplerUnit = { i_uniformName, false };
+	samplerUnits.push_back(samplerUnit);
+
+	return true;
+}
+
+bool eae6320::Graphics::SetTexture(Material& i_material)
+{
+	const int32_t textureUnit = i_material.m_textureUnit;
+	BindTexture(static_cast<uint32_t>(textureUnit), i_material.m_3dTexture);
+	sSamplerUnit& samplerUnit = s_programSamplerUnits[i_material.m_effect.m_programID][textureUnit];
+	if (!samplerUnit.isSet)
+	{
+		samplerUnit.isSet = true;
+		++s_frameStatistics.stateChanges;
+		s_frameStatistics.uploadedBytes += sizeof(int32_t);
+	}
+	else
+	{
+		++s_frameStatistics.redundantStateChanges;
+	}
+
+	return true;
+}
+
+eae6320::Graphics::tUniformHandle eae6320::Graphics::GetUniform(Effect& i_effect, const char* const i_uniformName, eShaderType i_shaderType)
+{
+	return 0;
+}
+
+void eae6320::Graphics::Clear()
+{
+	//OpenGL has to enable depth writes to clear the depth buffer
+	s_stateCache.renderStates |= depthwrite;
+}
+
+const eae6320::Graphics::sFrameStatistics& eae6320::Graphics::GetFrameStatistics()
+{
+	return s_frameStatistics;
+}
+
+const eae6320::Graphics::sResourceStatistics& eae6320::Graphics::GetResourceStatistics()
+{
+	return s_resourceStatistics;
+}
+
+void eae6320::Graphics::BeginScene()
+{
+	s_frameStatistics = sFrameStatistics();
+}
+
+void eae6320::Graphics::EndScene()
+{
+
+}
+
+void eae6320::Graphics::SwapBuffers()
+{
+
+}
+
+bool eae6320::Graphics::MakeContextCurrent()
+{
+	return true;
+}
+
+void eae6320::Graphics::ReleaseContext()
+{
+
+}
+
+bool eae6320::Graphics::ApplyErrorCheckMode(const eErrorCheckMode i_mode)
+{
+	//Nothing can fail, so every mode is accepted and none of them check anything
+	s_errorCheckMode = i_mode;
+	return true;
+}
+
+eae6320::Graphics::eErrorCheckMode eae6320::Graphics::GetErrorCheckMode()
+{
+	return s_errorCheckMode;
+}
+
+bool eae6320::Graphics::BindEffect(Effect& i_effect)
+{
+	if (s_stateCache.program != i_effect.m_programID)
+	{
+		s_stateCache.program = i_effect.m_programID;
+		++s_frameStatistics.stateChanges;
+	}
+	else
+	{
+		++s_frameStatistics.redundantStateChanges;
+	}
+
+	//Each of the four render states is counted separately, like OpenGL sets them
+	const uint8_t renderStatesToSet = s_stateCache.areRenderStatesKnown ?
+		(s_stateCache.renderStates ^ i_effect.m_renderStates) : (alpha | depthtest | depthwrite | faceculling);
+	s_stateCache.renderStates = i_effect.m_renderStates;
+	s_stateCache.areRenderStatesKnown = true;
+	const uint8_t renderStates[] = { alpha, depthtest, depthwrite, faceculling };
+	for (size_t i = 0; i < (sizeof(renderStates) / sizeof(renderStates[0])); ++i)
+	{
+		if (renderStatesToSet & renderStates[i])
+		{
+			++s_frameStatistics.stateChanges;
+		}
+		else
+		{
+			++s_frameStatistics.redundantStateChanges;
+		}
+	}
+
+	return true;
+}
+
+void eae6320::Graphics::SetViewConstants(const sViewConstants& i_viewConstants)
+{
+	s_viewConstants = i_viewConstants;
+	s_frameStatistics.uploadedBytes += sizeof(s_viewConstants);
+}
+
+void eae6320::Graphics::SetInstanceTransforms(const eae6320::Math::cMatrix_transformation* const i_transforms, const size_t i_count)
+{
+	s_frameStatistics.uploadedBytes += static_cast<uint32_t>(i_count * sizeof(eae6320::Math::cMatrix_transformation));
+}
+
+bool eae6320::Graphics::SetDrawCallUniforms(Effect& i_effect, eae6320::Math::cMatrix_transformation& i_offsetMatrix)
+{
+	//The shaders use the single precomputed transform, so this costs what it does on OpenGL
+	s_drawCallTransform = i_offsetMatrix * s_viewConstants.worldToProjected;
+	s_frameStatistics.uploadedBytes += sizeof(s_drawCallTransform);
+
+	return true;
+}
+
+void eae6320::Graphics::SetMaterialUniform(const Effect& i_effect, float i_values[], uint8_t i_valueCountToSet, tUniformHandle i_uniformHandle, eShaderType i_shaderType)
+{
+	++s_frameStatistics.stateChanges;
+	s_frameStatistics.uploadedBytes += i_valueCountToSet * sizeof(float);
+}
+
+bool eae6320::Graphics::CreateMaterialConstants(Material& io_material, const char* const* const i_uniformNames)
+{
+	io_material.m_constantBufferId = s_nextHandle++;
+	*io_material.m_areConstantsDirty = false;
+	++s_resourceStatistics.materialCount;
+
+	return true;
+}
+
+void eae6320::Graphics::DestroyMaterialConstants(Material& io_material)
+{
+	if (s_stateCache.materialConstantsBuffer == io_material.m_constantBufferId)
+	{
+		s_stateCache.materialConstantsBuffer = 0;
+	}
+	io_material.m_constantBufferId = 0;
+}
+
+void eae6320::Graphics::BindMaterialConstants(Material& io_material)
+{
+	if (*io_material.m_areConstantsDirty)
+	{
+		*io_material.m_areConstantsDirty = false;
+		++s_frameStatistics.stateChanges;
+		s_frameStatistics.uploadedBytes += io_material.m_constantsSize;
+	}
+	if (s_stateCache.materialConstantsBuffer != io_material.m_constantBufferId)
+	{
+		s_stateCache.materialConstantsBuffer = io_material.m_constantBufferId;
+		++s_frameStatistics.stateChanges;
+	}
+	else
+	{
+		++s_frameStatistics.redundantStateChanges;
+	}
+}
+
+void eae6320::Graphics::DrawMesh(const eae6320::Graphics::Mesh& i_Mesh)
+{
+	BindMeshForDrawing(i_Mesh);
+	++s_frameStatistics.drawCalls;
+}
+
+void eae6320::Graphics::DrawMeshInstanced(const Mesh& i_mesh, const size_t i_firstInstance, const size_t i_instanceCount)
+{
+	BindMeshForDrawing(i_mesh);
+	//OpenGL points the instance attributes at the run's first transform before every instanced draw
+	++s_frameStatistics.stateChanges;
+	++s_frameStatistics.drawCalls;
+}
+
+bool eae6320::Graphics::ShutDown()
+{
+	StopWorkerThreads();
+	UnloadAllAssets();
+	s_renderingWindow = NULL;
+	InvalidateStateCache();
+
+	return true;
+}
+
+float eae6320::Graphics::getAspectRatio()
+{
+	return s_aspectRatio;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	void InvalidateStateCache()
+	{
+		s_stateCache.program = 0;
+		s_stateCache.vertexArray = 0;
+		s_stateCache.areRenderStatesKnown = false;
+		s_stateCache.renderStates = 0;
+		s_stateCache.activeTextureUnit = 0;
+		for (uint32_t i = 0; i < s_cachedTextureUnitCount; ++i)
+		{
+			s_stateCache.boundTextures[i] = 0;
+		}
+		s_stateCache.materialConstantsBuffer = 0;
+	}
+
+	void BindTexture(const uint32_t i_textureUnit, const uint32_t i_texture)
+	{
+		//Units are stored off by one so that zero means that none has been made active yet
+		const uint32_t textureUnit = i_textureUnit + 1;
+		const bool isUnitCached = i_textureUnit < s_cachedTextureUnitCount;
+		if (isUnitCached && (s_stateCache.boundTextures[i_textureUnit] == i_texture))
+		{
+			++s_frameStatistics.redundantStateChanges;
+			++s_frameStatistics.redundantTextureBinds;
+			return;
+		}
+		if (s_stateCache.activeTextureUnit != textureUnit)
+		{
+			s_stateCache.activeTextureUnit = textureUnit;
+			++s_frameStatistics.stateChanges;
+		}
+		if (isUnitCached)
+		{
+			s_stateCache.boundTextures[i_textureUnit] = i_texture;
+		}
+		++s_frameStatistics.stateChanges;
+		++s_frameStatistics.textureBinds;
+	}
+
+	void BindMeshForDrawing(const eae6320::Graphics::Mesh& i_mesh)
+	{
+		if (s_stateCache.vertexArray != i_mesh.m_vertexArrayID)
+		{
+			s_stateCache.vertexArray = i_mesh.m_vertexArrayID;
+			++s_frameStatistics.stateChanges;
+		}
+		else
+		{
+			++s_frameStatistics.redundantStateChanges;
+		}
+	}
+}
@@ -3,18 +3,19 @@
 
 #include "../Graphics.h"
 #include "../Renderable.h"
+#include "../cMappedFile.h"
 
 #include <cassert>
 #include <cstdint>
 #include <cstdlib>
-#include <gl/GL.h>
-#include <gl/GLU.h>
+#include <cstring>
+#include <map>
 #include <string>
 #include <sstream>
 #include <algorithm>
 #include <vector>
 #include "../../UserOutput/UserOutput.h"
-#include "../../Windows/Functions.h"
+#include "RenderingContext.h"
 #include "../../../External/OpenGlExtensions/OpenGlExtensions.h"
 #include "../../Core/Math/cMatrix_transformation.h"
 #include "../../Core/Math/Functions.h"
@@ -24,13 +25,81 @@
 
 namespace
 {
-	HWND s_renderingWindow = NULL;
-	HDC s_deviceContext = NULL;
-	HGLRC s_openGlRenderingContext = NULL;
 	eae6320::Graphics::Mesh s_MeshSquare;
 	eae6320::Graphics::Mesh s_MeshTriangle;
 
 	eae6320::Graphics::Effect *s_effect = NULL;
+
+	// This is what the OpenGL state was last set to by this file,
+	// so that calls that wouldn't change anything can be skipped
+	// (the driver would otherwise still have to validate every one of them)
+	const GLuint s_cachedTextureUnitCount = 32;
+	struct sStateCache
+	{
+		GLuint program;
+		GLuint vertexArray;
+		// Render states are only compared once BindEffect() has set every one of them
+		bool areRenderStatesKnown;
+		uint8_t renderStates;
+		// Only units below s_cachedTextureUnitCount are tracked;
+		// anything higher is always bound
+		// (units are assigned per effect sampler, so in practice only the first few are ever used)
+		GLenum activeTextureUnit;
+		GLuint boundTextures[s_cachedTextureUnitCount];
+		GLuint materialConstantsBuffer;
+	};
+	sStateCache s_stateCache;
+	// Texture units are handed out per effect sampler, and this is how many the implementation has
+	GLint s_maxTextureUnitCount = 0;
+	eae6320::Graphics::sFrameStatistics s_frameStatistics;
+
+	// OpenGL is checked for errors while it renders as SetErrorCheckMode() says
+#if !defined( NDEBUG )
+	const eae6320::Graphics::eErrorCheckMode s_defaultErrorCheckMode = eae6320::Graphics::errorChecksPerFrame;
+#else
+	const eae6320::Graphics::eErrorCheckMode s_defaultErrorCheckMode = eae6320::Graphics::errorChecksOff;
+#endif
+	eae6320::Graphics::eErrorCheckMode s_errorCheckMode = s_defaultErrorCheckMode;
+	// Only the first error is reported, so that a mistake that is made every frame doesn't flood the output
+	bool s_hasErrorBeenReported = false;
+	// glGetError() is called at most this many times in a row
+	// (some implementations keep returning an error once the context has been lost)
+	const size_t s_maxErrorCountPerCheck = 16;
+	// A debug message waits here until the check after the call that caused it says where that call was
+	std::string s_pendingDebugMessage;
+
+	// The per-frame transforms are uploaded once into a uniform buffer
+	// that every program's g_viewConstants block is bound to
+	// (its std140 layout is three column-major mat4s, which matches sViewConstants exactly)
+	const GLuint s_viewConstantsBindingPoint = 0;
+	GLuint s_viewConstantsBufferId = 0;
+	eae6320::Graphics::sViewConstants s_viewConstants;
+
+	// Every material has its own uniform buffer holding the block that MaterialBuilder baked,
+	// and switching materials only attaches a different buffer to this binding point
+	const GLuint s_materialConstantsBindingPoint = 1;
+	// A program is shared by every material that uses its effect,
+	// and so uniforms that aren't in a g_materialConstants block have to be set again whenever another material binds it.
+	// This is whose uniforms each program has (materials that share uniforms are copies of the same loaded material)
+	std::map<GLuint, const eae6320::Graphics::sUniformHelper*> s_programUniformOwners;
+	// Each of a program's samplers gets the next texture unit the first time that a material uses it
+	// (a sampler's position in the program's list is its unit),
+	// and the unit only has to be set in the program once because it never changes after that
+	struct sSamplerUnit
+	{
+		GLint location;
+		bool isSet;
+	};
+	std::map<GLuint, std::vector<sSamplerUnit>> s_programSamplerUnits;
+
+	// Every instanced draw call reads its transforms from this one buffer,
+	// which holds a column-major mat4 per instance for the whole frame.
+	// Each vertex array has the buffer attached to the locations of i_transform_localToProjected,
+	// and it is never allowed to be empty so that those attributes always have something to read
+	const GLuint s_instanceTransformLocation = 3;
+	const GLuint s_instanceTransformLocationCount = 4;
+	GLuint s_instanceBufferId = 0;
+	size_t s_instanceBufferCapacity = 64;
 	// This struct determines the layout of the data that the CPU will send to the GPU
 	//struct sVertex
 	//{
@@ -68,13 +137,42 @@ namespace
 	//	* The final color that the pixel should be
 }
 
+// Checking after every call would cost a branch after every call even while it is turned off,
+// and so Release builds only have those checks if EAE6320_GRAPHICS_GL_PER_CALL_CHECKS is defined
+// (errorChecksPerFrame and errorChecksDebugOutput cost nothing per call and are always available)
+#if !defined( NDEBUG ) && !defined( EAE6320_GRAPHICS_GL_PER_CALL_CHECKS )
+	#define EAE6320_GRAPHICS_GL_PER_CALL_CHECKS
+#endif
+#if defined( EAE6320_GRAPHICS_GL_PER_CALL_CHECKS )
+	#define EAE6320_GL_CHECKERRORS() CheckErrorsAfterCall( __FILE__, __LINE__ )
+#else
+	#define EAE6320_GL_CHECKERRORS() ( (void)0 )
+#endif
+
 // Helper Function Declarations
 //=============================
 
 namespace
 {
-	bool CreateRenderingContext();
-	bool LoadAndAllocateShaderProgram( const char* i_path, void*& o_shader, size_t& o_size, std::string* o_errorMessage );
+	// Reads (and so clears) every error that OpenGL has recorded, counts them, and reports the first one.
+	// i_file is NULL if the errors could have come from anywhere in the frame
+	void ReportErrors(const char* const i_file, const int i_line);
+	void ReportFirstError(const std::string& i_errorMessage);
+	void ClearErrors();
+#if defined( EAE6320_GRAPHICS_GL_PER_CALL_CHECKS )
+	void CheckErrorsAfterCall(const char* const i_file, const int i_line);
+#endif
+	void APIENTRY OnDebugMessage(GLenum i_source, GLenum i_type, GLuint i_id, GLenum i_severity, GLsizei i_length,
+		const GLchar* i_message, const void* i_userParam);
+	bool IsExtensionSupported(const char* const i_extensionName);
+	// This must be called whenever the state could have been changed without going through the cache
+	void InvalidateStateCache();
+	void BindTexture(const GLuint i_textureUnit, const GLuint i_texture);
+	bool CreateViewConstantsBuffer();
+	bool CreateInstanceBuffer();
+	// This changes the vertex array that is currently bound
+	void SetInstanceTransformAttributes(const size_t i_firstInstance);
+	void BindMeshForDrawing(const eae6320::Graphics::Mesh& i_mesh);
 
 	// This helper struct exists to be able to dynamically allocate memory to get "log info"
 	// which will automatically be freed when the struct goes out of scope
@@ -91,10 +189,8 @@ namespace
 
 bool eae6320::Graphics::Initialize( const HWND i_renderingWindow )
 {
-	s_renderingWindow = i_renderingWindow;
-
 	// Create an OpenGL rendering context
-	if ( !CreateRenderingContext() )
+	if ( !RenderingContext::Create( i_renderingWindow ) )
 	{
 		goto OnError;
 	}
@@ -123,6 +219,16 @@ bool eae6320::Graphics::Initialize( const HWND i_renderingWindow )
 		glDepthMask(GL_TRUE);
 		glDepthFunc(GL_LEQUAL);
 	}
+	if (!CreateViewConstantsBuffer())
+	{
+		goto OnError;
+	}
+	if (!CreateInstanceBuffer())
+	{
+		goto OnError;
+	}
+	glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &s_maxTextureUnitCount);
+	InvalidateStateCache();
 
 	return true;
 
@@ -132,38 +238,7 @@ OnError:
 	return false;
 }
 
-void eae6320::Graphics::AddRenderable(const char* const i_pathMesh, const char* const i_pathMaterial, eae6320::Graphics::Renderable *i_renderable)
-{
-
-	LoadMesh(i_pathMesh, i_renderable->m_mesh);
-	LoadMaterial(i_pathMaterial, i_renderable->m_material);
-	//LoadEffect(i_pathEffect, i_renderable->m_effect);
-	std::vector<eae6320::Graphics::Renderable*>* m_renderableList;
-	if (i_renderable->m_material.m_effect.m_renderStates & alpha)
-		m_renderableList = GetTransparentRenderableList();
-	else
-		m_renderableList = GetOpaqueRenderableList();
-	m_renderableList->push_back(i_renderable);
-}
-
-void eae6320::Graphics::RemoveRenderable(eae6320::Graphics::Renderable *i_renderable)
-{
-	std::vector<eae6320::Graphics::Renderable*>* m_renderableList;
-	if (i_renderable->m_material.m_effect.m_renderStates & alpha)
-		m_renderableList = GetTransparentRenderableList();
-	else
-		m_renderableList = GetOpaqueRenderableList();
-	for (std::vector<eae6320::Graphics::Renderable*>::iterator i = m_renderableList->begin(); i < m_renderableList->end(); ++i)
-	{
-		if (*(i) == i_renderable)
-		{
-			m_renderableList->erase(i);
-			break;
-		}
-	}
-}
-
-bool eae6320::Graphics::CreateBuffers(sVertex*& i_vertexData, int i_numOfVertices, uint32_t*& i_indexData, int i_numOfIndices, Mesh& i_mesh)
+bool eae6320::Graphics::CreateBuffers(const uint8_t* const i_vertexData, int i_numOfVertices, const uint32_t* const i_indexData, int i_numOfIndices, Mesh& i_mesh)
 {
 	bool wereThereErrors = false;
 	GLuint vertexBufferId = 0;
@@ -177,6 +252,7 @@ bool eae6320::Graphics::CreateBuffers(sVertex*& i_vertexData, int i_numOfVertice
 		if (errorCode == GL_NO_ERROR)
 		{
 			glBindVertexArray(i_mesh.m_vertexArrayID);
+			s_stateCache.vertexArray = i_mesh.m_vertexArrayID;
 			const GLenum errorCode = glGetError();
 			if (errorCode != GL_NO_ERROR)
 			{
@@ -230,29 +306,9 @@ bool eae6320::Graphics::CreateBuffers(sVertex*& i_vertexData, int i_numOfVertice
 	}
 	// Assign the data to the buffer
 	{
-		// We are drawing a square
-		const unsigned int vertexCount = i_mesh.m_noOfVertices;	// What is the minimum number of vertices a square needs (so that no data is duplicated)?
-		sVertex *vertexData = new sVertex[i_mesh.m_noOfVertices];
-		// Fill in the data for the triangle
-		{
-			// You will need to fill in two pieces of information for each vertex:
-			//	* 2 floats for the POSITION
-			//	* 4 uint8_ts for the COLOR
-
-			// The floats for POSITION are for the X and Y coordinates, like in Assignment 02.
-			// The difference this time is that there should be fewer (because we are sharing data).
-
-			// The uint8_ts for COLOR are "RGBA", where "RGB" stands for "Red Green Blue" and "A" for "Alpha".
-			// Conceptually each of these values is a [0,1] value, but we store them as an 8-bit value to save space
-			// (color doesn't need as much precision as position),
-			// which means that the data we send to the GPU will be [0,255].
-			// For now the alpha value should _always_ be 255, and so you will choose color by changing the first three RGB values.
-			// To make white you should use (255, 255, 255), to make black (0, 0, 0).
-			// To make pure red you would use the max for R and nothing for G and B, so (1, 0, 0).
-			// Experiment with other values to see what happens!
-			std::memcpy(vertexData, i_vertexData, (i_mesh.m_noOfVertices * sizeof(sVertex)));
-		}
-		glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(sVertex), reinterpret_cast<GLvoid*>(vertexData),
+		// The file's vertices are already laid out the way the GPU expects them
+		const GLsizeiptr bufferSize = i_mesh.m_noOfVertices * GetVertexStride(i_mesh.m_vertexFormat);
+		glBufferData(GL_ARRAY_BUFFER, bufferSize, reinterpret_cast<const GLvoid*>(i_vertexData),
 			// Our code will only ever write to the buffer
 			GL_STATIC_DRAW);
 		const GLenum errorCode = glGetError();
@@ -265,22 +321,26 @@ bool eae6320::Graphics::CreateBuffers(sVertex*& i_vertexData, int i_numOfVertice
 			eae6320::UserOutput::Print(errorMessage.str());
 			goto OnExit;
 		}
-		delete [] vertexData;
-		vertexData = NULL;
 	}
 	// Initialize the vertex format
 	{
-		const GLsizei stride = sizeof(sVertex);
+		const bool isQuantized = i_mesh.m_vertexFormat != floatVertices;
+		const GLsizei stride = static_cast<GLsizei>(GetVertexStride(i_mesh.m_vertexFormat));
 		GLvoid* offset = 0;
 
 		// Position (0)
 		// 3 floats == 12 bytes
+		// or 4 uint16_ts == 8 bytes when quantized
 		// Offset = 0
 		{
 			const GLuint vertexElementLocation = 0;
-			const GLint elementCount = 3;
-			const GLboolean notNormalized = GL_FALSE;	// The given floats should be used as-is
-			glVertexAttribPointer(vertexElementLocation, elementCount, GL_FLOAT, notNormalized, stride, offset);
+			const GLint elementCount = isQuantized ? 4 : 3;
+			const GLenum elementType = isQuantized ? GL_UNSIGNED_SHORT : GL_FLOAT;
+			const size_t elementSize = isQuantized ? sizeof(uint16_t) : sizeof(float);
+			// Quantized values are [0,1] across the mesh's AABB,
+			// and the draw call's transform expands them back into local space
+			const GLboolean normalized = isQuantized ? GL_TRUE : GL_FALSE;
+			glVertexAttribPointer(vertexElementLocation, elementCount, elementType, normalized, stride, offset);
 			const GLenum errorCode = glGetError();
 			if (errorCode == GL_NO_ERROR)
 			{
@@ -288,7 +348,7 @@ bool eae6320::Graphics::CreateBuffers(sVertex*& i_vertexData, int i_numOfVertice
 				const GLenum errorCode = glGetError();
 				if (errorCode == GL_NO_ERROR)
 				{
-					offset = reinterpret_cast<GLvoid*>(reinterpret_cast<uint8_t*>(offset) + (elementCount * sizeof(float)));
+					offset = reinterpret_cast<GLvoid*>(reinterpret_cast<uint8_t*>(offset) + (elementCount * elementSize));
 				}
 				else
 				{
@@ -312,12 +372,15 @@ bool eae6320::Graphics::CreateBuffers(sVertex*& i_vertexData, int i_numOfVertice
 		}
 		// Texture Coordinates (2)
 		// 2 floats == 8 bytes
-		// Offset = 12
+		// or 2 uint16_ts == 4 bytes when quantized
+		// Offset = 12 (or 8)
 		{
 			const GLuint vertexElementLocation = 2;
 			const GLint elementCount = 2;
-			const GLboolean notNormalized = GL_FALSE;	// The given floats should be used as-is
-			glVertexAttribPointer(vertexElementLocation, elementCount, GL_FLOAT, notNormalized, stride, offset);
+			const GLenum elementType = isQuantized ? GL_UNSIGNED_SHORT : GL_FLOAT;
+			const size_t elementSize = isQuantized ? sizeof(uint16_t) : sizeof(float);
+			const GLboolean normalized = isQuantized ? GL_TRUE : GL_FALSE;
+			glVertexAttribPointer(vertexElementLocation, elementCount, elementType, normalized, stride, offset);
 			const GLenum errorCode = glGetError();
 			if (errorCode == GL_NO_ERROR)
 			{
@@ -325,13 +388,13 @@ bool eae6320::Graphics::CreateBuffers(sVertex*& i_vertexData, int i_numOfVertice
 				const GLenum errorCode = glGetError();
 				if (errorCode == GL_NO_ERROR)
 				{
-					offset = reinterpret_cast<GLvoid*>(reinterpret_cast<uint8_t*>(offset) + (elementCount * sizeof(float)));
+					offset = reinterpret_cast<GLvoid*>(reinterpret_cast<uint8_t*>(offset) + (elementCount * elementSize));
 				}
 				else
 				{
 					wereThereErrors = true;
 					std::stringstream errorMessage;
-					errorMessage << "OpenGL failed to enable the POSITION vertex attribute: " <<
+					errorMessage << "OpenGL failed to enable the TEXCOORD0 vertex attribute: " <<
 						reinterpret_cast<const char*>(gluErrorString(errorCode));
 					eae6320::UserOutput::Print(errorMessage.str());
 					goto OnExit;
@@ -341,15 +404,17 @@ bool eae6320::Graphics::CreateBuffers(sVertex*& i_vertexData, int i_numOfVertice
 			{
 				wereThereErrors = true;
 				std::stringstream errorMessage;
-				errorMessage << "OpenGL failed to set the POSITION vertex attribute: " <<
+				errorMessage << "OpenGL failed to set the TEXCOORD0 vertex attribute: " <<
 					reinterpret_cast<const char*>(gluErrorString(errorCode));
 				eae6320::UserOutput::Print(errorMessage.str());
 				goto OnExit;
 			}
 		}
-		// Color (2)
+		// Color (1)
 		// 4 uint8_ts == 4 bytes
-		// Offset = 20
+		// Offset = 20 (or 12)
+		// (meshes without color leave this attribute disabled and DrawMesh() sets a constant white instead)
+		if (i_mesh.m_vertexFormat != quantizedVerticesNoColor)
 		{
 			const GLuint vertexElementLocation = 1;
 			const GLint elementCount = 4;
@@ -389,6 +454,28 @@ bool eae6320::Graphics::CreateBuffers(sVertex*& i_vertexData, int i_numOfVertice
 				goto OnExit;
 			}
 		}
+		// Per-instance transform (3-6)
+		// A mat4 takes up one location per column,
+		// and each of them only advances once per instance instead of once per vertex
+		// (DrawMeshInstanced() points them at the right place in the buffer for every draw call)
+		{
+			SetInstanceTransformAttributes(0);
+			for (GLuint i = 0; i < s_instanceTransformLocationCount; ++i)
+			{
+				glEnableVertexAttribArray(s_instanceTransformLocation + i);
+				glVertexAttribDivisor(s_instanceTransformLocation + i, 1);
+			}
+			const GLenum errorCode = glGetError();
+			if (errorCode != GL_NO_ERROR)
+			{
+				wereThereErrors = true;
+				std::stringstream errorMessage;
+				errorMessage << "OpenGL failed to set the per-instance transform vertex attributes: " <<
+					reinterpret_cast<const char*>(gluErrorString(errorCode));
+				eae6320::UserOutput::Print(errorMessage.str());
+				goto OnExit;
+			}
+		}
 	}
 
 	// Create an index buffer object and make it active
@@ -425,21 +512,11 @@ bool eae6320::Graphics::CreateBuffers(sVertex*& i_vertexData, int i_numOfVertice
 		// We are drawing a square
 		const unsigned int triangleCount = (unsigned int)(i_mesh.m_noOfIndices / 3.0f);	// How many triangles does a square have?
 		const unsigned int vertexCountPerTriangle = 3;
-		uint32_t *indexData = new uint32_t[i_mesh.m_noOfIndices];
-		// Fill in the data for the triangle
-		{
-			// EAE6320_TODO:
-			// You will need to fill in 3 indices for each triangle that needs to be drawn.
-			// Each index will be a 32-bit unsigned integer,
-			// and will index into the vertex buffer array that you have created.
-			// The order of indices is important, but the correct order will depend on
-			// which vertex you have assigned to which spot in your vertex buffer
-			// (also remember to maintain the correct handedness for the triangle winding order).
-			std::memcpy(indexData, i_indexData, (i_mesh.m_noOfIndices * sizeof(uint32_t)));
-		}
 
+		// The indices are uploaded straight from the caller's data
+		// (which is usually the mapped mesh file) without being copied first
 		const GLsizeiptr bufferSize = triangleCount * vertexCountPerTriangle * sizeof(uint32_t);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, bufferSize, reinterpret_cast<const GLvoid*>(indexData),
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, bufferSize, reinterpret_cast<const GLvoid*>(i_indexData),
 			// Our code will only ever write to the buffer
 			GL_STATIC_DRAW);
 		const GLenum errorCode = glGetError();
@@ -452,8 +529,6 @@ bool eae6320::Graphics::CreateBuffers(sVertex*& i_vertexData, int i_numOfVertice
 			eae6320::UserOutput::Print(errorMessage.str());
 			goto OnExit;
 		}
-		delete [] indexData;
-		indexData = NULL;
 	}
 
 OnExit:
@@ -465,6 +540,7 @@ OnExit:
 		// Unbind the vertex array
 		// (this must be done before deleting the vertex buffer)
 		glBindVertexArray(0);
+		s_stateCache.vertexArray = 0;
 		const GLenum errorCode = glGetError();
 		if (errorCode == GL_NO_ERROR)
 		{
@@ -519,6 +595,22 @@ OnExit:
 	return !wereThereErrors;
 }
 
+void eae6320::Graphics::DestroyBuffers(Mesh& io_mesh)
+{
+	if (io_mesh.m_vertexArrayID != 0)
+	{
+		//A new vertex array could be given the same name
+		if (s_stateCache.vertexArray == io_mesh.m_vertexArrayID)
+		{
+			s_stateCache.vertexArray = 0;
+		}
+		const GLsizei arrayCount = 1;
+		glDeleteVertexArrays(arrayCount, &io_mesh.m_vertexArrayID);
+		EAE6320_GL_CHECKERRORS();
+		io_mesh.m_vertexArrayID = 0;
+	}
+}
+
 bool eae6320::Graphics::LoadEffect(const char* const i_effectPath, Effect& i_effect)
 {
 	bool wereThereErrors = false;
@@ -526,48 +618,27 @@ bool eae6320::Graphics::LoadEffect(const char* const i_effectPath, Effect& i_eff
 	//Getting the Paths for the vertex and fragment shader.
 	//Variable declerations.
 
-	char *temporaryBuffer = NULL; //Declaring the temporary buffer to copy file contents into.
-
-								  //File operations.
-	FILE *i_file;
-	errno_t err;
-
-	err = fopen_s(&i_file, i_effectPath, "rb");
-	if (err != 0)
-	{
-		wereThereErrors = true;
-		std::stringstream errorMessage;
-		errorMessage << "Failed to load/open one or more mesh File\n";
-		eae6320::UserOutput::Print(errorMessage.str());
-
-		goto OnExit;
-	}
-
-
-	//Getting File size to initialize Buffer.
-	fseek(i_file, 0, SEEK_END);
-	long fSize = ftell(i_file);
-	rewind(i_file);
-
-	//Initializing the Buffer
-	temporaryBuffer = reinterpret_cast<char*>(malloc(sizeof(char) * fSize));
+	//The shader paths are read straight out of the mapped effect file,
+	//and the shader sources are handed to OpenGL straight out of their mapped files.
+	cMappedFile effectFile;
+	cMappedFile shaderFile;
+	const char* i_vertexPath = NULL;
+	size_t offset = 0;
+	const char* i_fragmentPath = NULL;
+	GLuint fragmentShaderId = 0;
+	GLuint vertexShaderId = 0;
 
-	if (temporaryBuffer == NULL)
+	//File operations.
+	if (!OpenAssetFile(i_effectPath, effectFile))
 	{
 		wereThereErrors = true;
-		std::stringstream errorMessage;
-		errorMessage << "Failed to allocate memory for buffer.\n";
-		eae6320::UserOutput::Print(errorMessage.str());
-
 		goto OnExit;
 	}
 
-	fread(temporaryBuffer, sizeof(char), fSize, i_file);
-
-	i_effect.m_renderStates = *reinterpret_cast<uint8_t*>(temporaryBuffer);
-	const char* i_vertexPath = reinterpret_cast<char*>(temporaryBuffer + 1);
-	size_t offset = strlen(i_vertexPath) + 1;
-	const char* i_fragmentPath = reinterpret_cast<char*>(temporaryBuffer + 1 + offset);
+	i_effect.m_renderStates = *effectFile.GetContents();
+	i_vertexPath = reinterpret_cast<const char*>(effectFile.GetContents() + 1);
+	offset = strlen(i_vertexPath) + 1;
+	i_fragmentPath = reinterpret_cast<const char*>(effectFile.GetContents() + 1 + offset);
 	// Create a program
 	{
 		i_effect.m_programID = glCreateProgram();
@@ -602,20 +673,13 @@ bool eae6320::Graphics::LoadEffect(const char* const i_effectPath, Effect& i_eff
 	}
 
 	// Load the source code from file and set it into a shader
-	GLuint fragmentShaderId = 0;
-	void* shaderSource = NULL;
 	{
-		// Load the shader source code
-		size_t fileSize;
+		// Map the shader source code
+		// (the source isn't NULL-terminated and so its length is passed explicitly)
+		if (!OpenAssetFile(i_fragmentPath, shaderFile))
 		{
-			const char* sourceCodeFileName = i_fragmentPath;
-			std::string errorMessage;
-			if (!LoadAndAllocateShaderProgram(sourceCodeFileName, shaderSource, fileSize, &errorMessage))
-			{
-				wereThereErrors = true;
-				eae6320::UserOutput::Print(errorMessage);
-				goto OnExit;
-			}
+			wereThereErrors = true;
+			goto OnExit;
 		}
 		// Generate a shader
 		fragmentShaderId = glCreateShader(GL_FRAGMENT_SHADER);
@@ -642,10 +706,13 @@ bool eae6320::Graphics::LoadEffect(const char* const i_effectPath, Effect& i_eff
 			const GLsizei shaderSourceCount = 1;
 			const GLchar* shaderSources[] =
 			{
-				reinterpret_cast<GLchar*>(shaderSource)
+				reinterpret_cast<const GLchar*>(shaderFile.GetContents())
+			};
+			const GLint sourceLengths[] =
+			{
+				static_cast<GLint>(shaderFile.GetSize())
 			};
-			const GLint* sourcesAreNullTerminated = NULL;
-			glShaderSource(fragmentShaderId, shaderSourceCount, shaderSources, sourcesAreNullTerminated);
+			glShaderSource(fragmentShaderId, shaderSourceCount, shaderSources, sourceLengths);
 			const GLenum errorCode = glGetError();
 			if (errorCode != GL_NO_ERROR)
 			{
@@ -754,11 +821,7 @@ bool eae6320::Graphics::LoadEffect(const char* const i_effectPath, Effect& i_eff
 		}
 	}
 
-	if (shaderSource != NULL)
-	{
-		free(shaderSource);
-		shaderSource = NULL;
-	}
+	shaderFile.Close();
 
 	//Loading the vertex shader.
 	// Verify that compiling shaders at run-time is supported
@@ -774,19 +837,13 @@ bool eae6320::Graphics::LoadEffect(const char* const i_effectPath, Effect& i_eff
 	}
 
 	// Load the source code from file and set it into a shader
-	GLuint vertexShaderId = 0;
 	{
-		// Load the shader source code
-		size_t fileSize;
+		// Map the shader source code
+		// (the source isn't NULL-terminated and so its length is passed explicitly)
+		if (!OpenAssetFile(i_vertexPath, shaderFile))
 		{
-			const char* sourceCodeFileName = i_vertexPath;
-			std::string errorMessage;
-			if (!LoadAndAllocateShaderProgram(sourceCodeFileName, shaderSource, fileSize, &errorMessage))
-			{
-				wereThereErrors = true;
-				eae6320::UserOutput::Print(errorMessage);
-				goto OnExit;
-			}
+			wereThereErrors = true;
+			goto OnExit;
 		}
 		// Generate a shader
 		vertexShaderId = glCreateShader(GL_VERTEX_SHADER);
@@ -813,10 +870,13 @@ bool eae6320::Graphics::LoadEffect(const char* const i_effectPath, Effect& i_eff
 			const GLsizei shaderSourceCount = 1;
 			const GLchar* shaderSources[] =
 			{
-				reinterpret_cast<GLchar*>(shaderSource)
+				reinterpret_cast<const GLchar*>(shaderFile.GetContents())
 			};
-			const GLint* sourcesAreNullTerminated = NULL;
-			glShaderSource(vertexShaderId, shaderSourceCount, shaderSources, sourcesAreNullTerminated);
+			const GLint sourceLengths[] =
+			{
+				static_cast<GLint>(shaderFile.GetSize())
+			};
+			glShaderSource(vertexShaderId, shaderSourceCount, shaderSources, sourceLengths);
 			const GLenum errorCode = glGetError();
 			if (errorCode != GL_NO_ERROR)
 			{
@@ -1010,10 +1070,22 @@ bool eae6320::Graphics::LoadEffect(const char* const i_effectPath, Effect& i_eff
 	//Get uniform location
 	{
 		//i_effect.location = glGetUniformLocation(i_effect.m_programID, "g_position_offset");
+		i_effect.localToProjected = glGetUniformLocation(i_effect.m_programID, "g_transform_localToProjected");
 		i_effect.localToWorld = glGetUniformLocation(i_effect.m_programID, "g_transform_localToWorld");
-		i_effect.worldToView = glGetUniformLocation(i_effect.m_programID, "g_transform_worldToView");
-		i_effect.viewToScreen = glGetUniformLocation(i_effect.m_programID, "g_transform_viewToScreen");
-		if (i_effect.localToWorld == -1 || i_effect.worldToView == -1 || i_effect.viewToScreen == -1)
+		//The camera's transforms come from the shared uniform buffer (see shaders.inc),
+		//so a program only has to be told which binding point that is.
+		const GLuint viewConstantsBlockIndex = glGetUniformBlockIndex(i_effect.m_programID, "g_viewConstants");
+		i_effect.m_usesViewConstants = viewConstantsBlockIndex != GL_INVALID_INDEX;
+		if (i_effect.m_usesViewConstants)
+		{
+			glUniformBlockBinding(i_effect.m_programID, viewConstantsBlockIndex, s_viewConstantsBindingPoint);
+			EAE6320_GL_CHECKERRORS();
+		}
+		//An instanced vertex shader reads localToProjected as a per-instance attribute instead.
+		i_effect.m_isInstanced = glGetAttribLocation(i_effect.m_programID, "i_transform_localToProjected") == static_cast<GLint>(s_instanceTransformLocation);
+		//A shader must either use the single precomputed transform or localToWorld and the view constants.
+		const bool usesSeparateTransforms = i_effect.localToWorld != -1 && i_effect.m_usesViewConstants;
+		if (i_effect.localToProjected == -1 && !usesSeparateTransforms && !i_effect.m_isInstanced)
 		{
 			wereThereErrors = true;
 			std::stringstream errorMessage;
@@ -1025,7 +1097,7 @@ bool eae6320::Graphics::LoadEffect(const char* const i_effectPath, Effect& i_eff
 
 OnExit:
 
-	free(temporaryBuffer);
+	effectFile.Close();
 	if (fragmentShaderId != 0)
 	{
 		// Even if the shader was successfully compiled
@@ -1061,100 +1133,48 @@ OnExit:
 		}
 		vertexShaderId = 0;
 	}
-	if (shaderSource != NULL)
-	{
-		free(shaderSource);
-		shaderSource = NULL;
-	}
+	shaderFile.Close();
 
 	return !wereThereErrors;
 }
 
+void eae6320::Graphics::DestroyEffect(Effect& io_effect)
+{
+	if (io_effect.m_programID != 0)
+	{
+		//A program that is in use is only deleted once it stops being used,
+		//but a new program could be given the same name
+		if (s_stateCache.program == io_effect.m_programID)
+		{
+			s_stateCache.program = 0;
+		}
+		s_programUniformOwners.erase(io_effect.m_programID);
+		s_programSamplerUnits.erase(io_effect.m_programID);
+		glDeleteProgram(io_effect.m_programID);
+		EAE6320_GL_CHECKERRORS();
+		io_effect.m_programID = 0;
+	}
+}
+
 bool eae6320::Graphics::LoadTexture(const char* const i_path, Material& i_material)
 {
 	bool wereThereErrors = false;
-	HANDLE fileHandle = INVALID_HANDLE_VALUE;
-	void* fileContents = NULL;
+	//The mip levels are uploaded straight out of the mapped file
+	cMappedFile file;
+	const uint8_t* fileContents = NULL;
+	size_t fileSize = 0;
+	const uint8_t* currentPosition = NULL;
 	i_material.m_3dTexture = 0;
 	std::string* o_errorMessage = NULL;
 
-	// Open the texture file
-	{
-		const DWORD desiredAccess = FILE_GENERIC_READ;
-		const DWORD otherProgramsCanStillReadTheFile = FILE_SHARE_READ;
-		SECURITY_ATTRIBUTES* useDefaultSecurity = NULL;
-		const DWORD onlySucceedIfFileExists = OPEN_EXISTING;
-		const DWORD useDefaultAttributes = FILE_ATTRIBUTE_NORMAL;
-		const HANDLE dontUseTemplateFile = NULL;
-		fileHandle = CreateFile(i_path, desiredAccess, otherProgramsCanStillReadTheFile,
-			useDefaultSecurity, onlySucceedIfFileExists, useDefaultAttributes, dontUseTemplateFile);
-		if (fileHandle == INVALID_HANDLE_VALUE)
-		{
-			wereThereErrors = true;
-			if (o_errorMessage)
-			{
-				std::string windowsErrorMessage(GetLastWindowsError());
-				std::stringstream errorMessage;
-				errorMessage << "Windows failed to open the texture file: " << windowsErrorMessage;
-				*o_errorMessage = errorMessage.str();
-			}
-			goto OnExit;
-		}
-	}
-	// Get the file's size
-	size_t fileSize;
-	{
-		LARGE_INTEGER fileSize_integer;
-		if (GetFileSizeEx(fileHandle, &fileSize_integer) != FALSE)
-		{
-			assert(fileSize_integer.QuadPart <= SIZE_MAX);
-			fileSize = static_cast<size_t>(fileSize_integer.QuadPart);
-		}
-		else
-		{
-			wereThereErrors = true;
-			if (o_errorMessage)
-			{
-				std::string windowsErrorMessage(GetLastWindowsError());
-				std::stringstream errorMessage;
-				errorMessage << "Windows failed to get the size of the texture file: " << windowsErrorMessage;
-				*o_errorMessage = errorMessage.str();
-			}
-			goto OnExit;
-		}
-	}
-	// Read the file's contents into temporary memory
-	fileContents = malloc(fileSize);
-	if (fileContents)
-	{
-		DWORD bytesReadCount;
-		OVERLAPPED* readSynchronously = NULL;
-		assert(fileSize < (uint64_t(1) << (sizeof(DWORD) * 8)));
-		if (ReadFile(fileHandle, fileContents, static_cast<DWORD>(fileSize),
-			&bytesReadCount, readSynchronously) == FALSE)
-		{
-			wereThereErrors = true;
-			if (o_errorMessage)
-			{
-				std::string windowsErrorMessage(GetLastWindowsError());
-				std::stringstream errorMessage;
-				errorMessage << "Windows failed to read the contents of the texture file: " << windowsErrorMessage;
-				*o_errorMessage = errorMessage.str();
-			}
-			goto OnExit;
-		}
-	}
-	else
+	// Map the texture file
+	if (!OpenAssetFile(i_path, file))
 	{
 		wereThereErrors = true;
-		if (o_errorMessage)
-		{
-			std::stringstream errorMessage;
-			errorMessage << "Failed to allocate " << fileSize << " bytes to read in the texture " << i_path;
-			*o_errorMessage = errorMessage.str();
-		}
 		goto OnExit;
 	}
+	fileContents = file.GetContents();
+	fileSize = file.GetSize();
 
 	// Create a new texture and make it active
 	{
@@ -1166,6 +1186,10 @@ bool eae6320::Graphics::LoadTexture(const char* const i_path, Material& i_materi
 			// This code only supports 2D textures;
 			// if you want to support other types you will need to improve this code.
 			glBindTexture(GL_TEXTURE_2D, i_material.m_3dTexture);
+			if ((s_stateCache.activeTextureUnit >= GL_TEXTURE0) && (s_stateCache.activeTextureUnit < (GL_TEXTURE0 + s_cachedTextureUnitCount)))
+			{
+				s_stateCache.boundTextures[s_stateCache.activeTextureUnit - GL_TEXTURE0] = i_material.m_3dTexture;
+			}
 			const GLenum errorCode = glGetError();
 			if (errorCode != GL_NO_ERROR)
 			{
@@ -1195,7 +1219,7 @@ bool eae6320::Graphics::LoadTexture(const char* const i_path, Material& i_materi
 	}
 
 	// Extract the data
-	const uint8_t* currentPosition = reinterpret_cast<uint8_t*>(fileContents);
+	currentPosition = fileContents;
 	// Verify that the file is a valid DDS
 	{
 		const size_t fourCcCount = 4;
@@ -1249,7 +1273,9 @@ bool eae6320::Graphics::LoadTexture(const char* const i_path, Material& i_materi
 		uint32_t caps[4];
 		uint32_t reserved2;
 	};
-	const sDdsHeader* ddsHeader = reinterpret_cast<const sDdsHeader*>(currentPosition);
+	//This is assigned separately so that the error gotos above don't jump over an initialization
+	const sDdsHeader* ddsHeader;
+	ddsHeader = reinterpret_cast<const sDdsHeader*>(currentPosition);
 	currentPosition += sizeof(sDdsHeader);
 	// Convert the DDS format into an OpenGL format
 	GLenum format;
@@ -1317,54 +1343,88 @@ bool eae6320::Graphics::LoadTexture(const char* const i_path, Material& i_materi
 		}
 	}
 
-	assert(currentPosition == (reinterpret_cast<uint8_t*>(fileContents) + fileSize));
+	assert(currentPosition == (fileContents + fileSize));
 
 OnExit:
 
-	if (fileContents != NULL)
+	file.Close();
+	if (wereThereErrors && (i_material.m_3dTexture != 0))
 	{
-		free(fileContents);
-		fileContents = NULL;
+		const GLsizei textureCount = 1;
+		glDeleteTextures(textureCount, &(i_material.m_3dTexture));
+		EAE6320_GL_CHECKERRORS();
+		i_material.m_3dTexture = 0;
 	}
-	if (fileHandle != INVALID_HANDLE_VALUE)
+
+	return !wereThereErrors;
+}
+
+void eae6320::Graphics::DestroyTexture(Material& io_material)
+{
+	if (io_material.m_3dTexture != 0)
 	{
-		if (CloseHandle(fileHandle) == FALSE)
+		for (GLuint i = 0; i < s_cachedTextureUnitCount; ++i)
 		{
-			wereThereErrors = true;
-			if (o_errorMessage)
+			if (s_stateCache.boundTextures[i] == io_material.m_3dTexture)
 			{
-				std::string windowsErrorMessage(GetLastWindowsError());
-				std::stringstream errorMessage;
-				errorMessage << "\nWindows failed to close the texture file handle: " << windowsErrorMessage;
-				*o_errorMessage += errorMessage.str();
+				s_stateCache.boundTextures[i] = 0;
 			}
 		}
-		fileHandle = INVALID_HANDLE_VALUE;
-	}
-	if (wereThereErrors && (i_material.m_3dTexture != 0))
-	{
 		const GLsizei textureCount = 1;
-		glDeleteTextures(textureCount, &(i_material.m_3dTexture));
-		assert(glGetError == GL_NO_ERROR);
-		i_material.m_3dTexture = 0;
+		glDeleteTextures(textureCount, &io_material.m_3dTexture);
+		EAE6320_GL_CHECKERRORS();
+		io_material.m_3dTexture = 0;
 	}
-
-	return !wereThereErrors;
 }
 
 bool eae6320::Graphics::LoadSamplerID(const char* const i_uniformName, Material& i_material)
 {
 	i_material.m_texHandle = glGetUniformLocation(i_material.m_effect.m_programID, i_uniformName);
 
+	//Each of the effect's samplers gets the next unit,
+	//so the number of units needed never depends on how many things are drawn.
+	//The units are kept with the program rather than in the material's copy of the effect
+	//so that every material that uses the same sampler gets the same unit.
+	std::vector<sSamplerUnit>& samplerUnits = s_programSamplerUnits[i_material.m_effect.m_programID];
+	for (size_t i = 0; i < samplerUnits.size(); ++i)
+	{
+		if (samplerUnits[i].location == i_material.m_texHandle)
+		{
+			i_material.m_textureUnit = static_cast<uint8_t>(i);
+			return true;
+		}
+	}
+	if (samplerUnits.size() >= static_cast<size_t>(s_maxTextureUnitCount))
+	{
+		std::stringstream errorMessage;
+		errorMessage << "The sampler " << i_uniformName << " needs more than the " << s_maxTextureUnitCount << " texture units that OpenGL has";
+		eae6320::UserOutput::Print(errorMessage.str());
+		return false;
+	}
+	i_material.m_textureUnit = static_cast<uint8_t>(samplerUnits.size());
+	const sSamplerUnit samplerUnit = { i_material.m_texHandle, false };
+	samplerUnits.push_back(samplerUnit);
+
 	return true;
 }
 
-bool eae6320::Graphics::SetTexture(Material& i_material, int i_offset)
+bool eae6320::Graphics::SetTexture(Material& i_material)
 {
-
-	glActiveTexture(GL_TEXTURE0 + i_offset);
-	glBindTexture(GL_TEXTURE_2D, i_material.m_3dTexture);
-	glUniform1i(i_material.m_texHandle, i_offset);
+	const GLint textureUnit = i_material.m_textureUnit;
+	BindTexture(static_cast<GLuint>(textureUnit), i_material.m_3dTexture);
+	//The sampler is part of the program's state, and its unit never changes once LoadSamplerID() has given it one
+	sSamplerUnit& samplerUnit = s_programSamplerUnits[i_material.m_effect.m_programID][textureUnit];
+	if (!samplerUnit.isSet)
+	{
+		glUniform1i(i_material.m_texHandle, textureUnit);
+		EAE6320_GL_CHECKERRORS();
+		samplerUnit.isSet = true;
+		++s_frameStatistics.stateChanges;
+	}
+	else
+	{
+		++s_frameStatistics.redundantStateChanges;
+	}
 
 	return true;
 }
@@ -1378,122 +1438,288 @@ void eae6320::Graphics::Clear()
 {
 	// Black is usually used
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-	assert(glGetError() == GL_NO_ERROR);
+	EAE6320_GL_CHECKERRORS();
 	// In addition to the color, "depth" and "stencil" can also be cleared,
 	// but for now we only care about color
 	const GLbitfield clearColor = GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT;
-	glDepthMask(GL_TRUE);
+	//The depth buffer can only be cleared while depth writes are enabled
+	if (!s_stateCache.areRenderStatesKnown || !(s_stateCache.renderStates & depthwrite))
+	{
+		glDepthMask(GL_TRUE);
+		s_stateCache.renderStates |= depthwrite;
+	}
 	glClear(clearColor);
-	assert(glGetError() == GL_NO_ERROR);
+	EAE6320_GL_CHECKERRORS();
 }
 
-void eae6320::Graphics::BeginScene()
+const eae6320::Graphics::sFrameStatistics& eae6320::Graphics::GetFrameStatistics()
 {
+	return s_frameStatistics;
+}
 
+void eae6320::Graphics::BeginScene()
+{
+	s_frameStatistics = sFrameStatistics();
 }
 
 void eae6320::Graphics::EndScene()
 {
-
+	if (s_errorCheckMode == errorChecksPerFrame)
+	{
+		ReportErrors(NULL, 0);
+	}
+	else if (s_errorCheckMode == errorChecksDebugOutput)
+	{
+		if (!s_pendingDebugMessage.empty())
+		{
+			//The message came from a call that isn't followed by a check
+			ReportFirstError(s_pendingDebugMessage);
+			s_pendingDebugMessage.clear();
+		}
+		//The callback has already counted the errors,
+		//but OpenGL still has them recorded and the next load would think that it had failed
+		ClearErrors();
+	}
 }
 
 void eae6320::Graphics::SwapBuffers()
 {
-	BOOL result = SwapBuffers(s_deviceContext);
-	assert(result != FALSE);
+	RenderingContext::Present();
+}
+
+bool eae6320::Graphics::MakeContextCurrent()
+{
+	return RenderingContext::MakeCurrent();
+}
+
+void eae6320::Graphics::ReleaseContext()
+{
+	RenderingContext::ReleaseCurrent();
+}
+
+bool eae6320::Graphics::ApplyErrorCheckMode(const eErrorCheckMode i_mode)
+{
+#if !defined( EAE6320_GRAPHICS_GL_PER_CALL_CHECKS )
+	if (i_mode == errorChecksPerCall)
+	{
+		eae6320::UserOutput::Print("This build can't check for OpenGL errors after every call (EAE6320_GRAPHICS_GL_PER_CALL_CHECKS isn't defined)");
+		return false;
+	}
+#endif
+	const bool wasDebugOutputEnabled = s_errorCheckMode == errorChecksDebugOutput;
+	const bool shouldDebugOutputBeEnabled = i_mode == errorChecksDebugOutput;
+	if (shouldDebugOutputBeEnabled && !wasDebugOutputEnabled)
+	{
+		if ((glDebugMessageCallback == NULL) || !IsExtensionSupported("GL_KHR_debug"))
+		{
+			eae6320::UserOutput::Print("OpenGL can't report errors to a callback because it doesn't support GL_KHR_debug");
+			return false;
+		}
+		//Synchronous messages are sent from inside the call that caused them,
+		//so that the check after the call can say where it was
+		glDebugMessageCallback(OnDebugMessage, NULL);
+		glEnable(GL_DEBUG_OUTPUT);
+		glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+	}
+	else if (!shouldDebugOutputBeEnabled && wasDebugOutputEnabled)
+	{
+		glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+		glDisable(GL_DEBUG_OUTPUT);
+		glDebugMessageCallback(NULL, NULL);
+	}
+	//Errors that were made before this shouldn't be blamed on the new mode
+	ClearErrors();
+	s_pendingDebugMessage.clear();
+	s_hasErrorBeenReported = false;
+	s_errorCheckMode = i_mode;
+	return true;
+}
+
+eae6320::Graphics::eErrorCheckMode eae6320::Graphics::GetErrorCheckMode()
+{
+	return s_errorCheckMode;
 }
 
 bool eae6320::Graphics::BindEffect(Effect& i_effect)
 {
-	glUseProgram(i_effect.m_programID);
-	assert(glGetError() == GL_NO_ERROR);
+	if (s_stateCache.program != i_effect.m_programID)
+	{
+		glUseProgram(i_effect.m_programID);
+		EAE6320_GL_CHECKERRORS();
+		s_stateCache.program = i_effect.m_programID;
+		++s_frameStatistics.stateChanges;
+	}
+	else
+	{
+		++s_frameStatistics.redundantStateChanges;
+	}
+
+	//Only the render states that differ from the current ones are set
+	const uint8_t renderStatesToSet = s_stateCache.areRenderStatesKnown ?
+		(s_stateCache.renderStates ^ i_effect.m_renderStates) : (alpha | depthtest | depthwrite | faceculling);
+	s_stateCache.renderStates = i_effect.m_renderStates;
+	s_stateCache.areRenderStatesKnown = true;
 
 	//Set Alpha rendering state.
-	if (i_effect.m_renderStates & alpha)
+	if (renderStatesToSet & alpha)
 	{
-		glEnable(GL_BLEND);
-		assert(glGetError() == GL_NO_ERROR);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		assert(glGetError() == GL_NO_ERROR);
+		if (i_effect.m_renderStates & alpha)
+		{
+			glEnable(GL_BLEND);
+			EAE6320_GL_CHECKERRORS();
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+			EAE6320_GL_CHECKERRORS();
+		}
+		else
+		{
+			glDisable(GL_BLEND);
+			EAE6320_GL_CHECKERRORS();
+		}
+		++s_frameStatistics.stateChanges;
 	}
 	else
 	{
-		glDisable(GL_BLEND);
-		assert(glGetError() == GL_NO_ERROR);
+		++s_frameStatistics.redundantStateChanges;
 	}
 
 	//Set Depth Test rendering state.
-	if (i_effect.m_renderStates & depthtest)
+	if (renderStatesToSet & depthtest)
 	{
-		glEnable(GL_DEPTH_TEST);
-		assert(glGetError() == GL_NO_ERROR);
-		glDepthFunc(GL_LEQUAL);
-		assert(glGetError() == GL_NO_ERROR);
+		if (i_effect.m_renderStates & depthtest)
+		{
+			glEnable(GL_DEPTH_TEST);
+			EAE6320_GL_CHECKERRORS();
+			glDepthFunc(GL_LEQUAL);
+			EAE6320_GL_CHECKERRORS();
+		}
+		else
+		{
+			glDisable(GL_DEPTH_TEST);
+			EAE6320_GL_CHECKERRORS();
+		}
+		++s_frameStatistics.stateChanges;
 	}
 	else
 	{
-		glDisable(GL_DEPTH_TEST);
-		assert(glGetError() == GL_NO_ERROR);
+		++s_frameStatistics.redundantStateChanges;
 	}
 
 	//Set Depth Write rendering state.
-	if (i_effect.m_renderStates & depthwrite)
+	if (renderStatesToSet & depthwrite)
 	{
-		glDepthMask(GL_TRUE);
-		assert(glGetError() == GL_NO_ERROR);
+		if (i_effect.m_renderStates & depthwrite)
+		{
+			glDepthMask(GL_TRUE);
+			EAE6320_GL_CHECKERRORS();
+		}
+		else
+		{
+			glDepthMask(GL_FALSE);
+			EAE6320_GL_CHECKERRORS();
+		}
+		++s_frameStatistics.stateChanges;
 	}
 	else
 	{
-		glDepthMask(GL_FALSE);
-		assert(glGetError() == GL_NO_ERROR);
+		++s_frameStatistics.redundantStateChanges;
 	}
 
 	//Set Face Culling rendering state.
-	if (i_effect.m_renderStates & faceculling)
+	if (renderStatesToSet & faceculling)
 	{
-		glEnable(GL_CULL_FACE);
-		assert(glGetError() == GL_NO_ERROR);
-		glFrontFace(GL_CCW);
-		assert(glGetError() == GL_NO_ERROR);
+		if (i_effect.m_renderStates & faceculling)
+		{
+			glEnable(GL_CULL_FACE);
+			EAE6320_GL_CHECKERRORS();
+			glFrontFace(GL_CCW);
+			EAE6320_GL_CHECKERRORS();
+		}
+		else
+		{
+			glDisable(GL_CULL_FACE);
+			EAE6320_GL_CHECKERRORS();
+		}
+		++s_frameStatistics.stateChanges;
 	}
 	else
 	{
-		glDisable(GL_CULL_FACE);
-		assert(glGetError() == GL_NO_ERROR);
+		++s_frameStatistics.redundantStateChanges;
 	}
 
 	return true;
 }
 
-bool eae6320::Graphics::SetDrawCallUniforms(Effect& i_effect, eae6320::Math::cMatrix_transformation& i_offsetMatrix)
+void eae6320::Graphics::SetViewConstants(const sViewConstants& i_viewConstants)
 {
-	const GLboolean dontTranspose = false; // Matrices are already in the correct format
-	const GLsizei uniformCountToSet = 1;
-
-	glUniformMatrix4fv(i_effect.localToWorld, uniformCountToSet, dontTranspose, reinterpret_cast<const GLfloat*>(&i_offsetMatrix));
-
-	eae6320::Math::cMatrix_transformation worldToView = eae6320::Math::cMatrix_transformation::CreateWorldToViewTransform(Camera::getInstance().m_orientation, Camera::getInstance().m_offset);
-	glUniformMatrix4fv(i_effect.worldToView, uniformCountToSet, dontTranspose, reinterpret_cast<const GLfloat*>(&worldToView));
-
-	eae6320::Math::cMatrix_transformation viewToScreen = eae6320::Math::cMatrix_transformation::CreateViewToScreenTransform(Camera::getInstance().FOV, getAspectRatio(), 0.1f, 100.0f);
-	glUniformMatrix4fv(i_effect.viewToScreen, uniformCountToSet, dontTranspose, reinterpret_cast<const GLfloat*>(&viewToScreen));
-
-	return true;
+	s_viewConstants = i_viewConstants;
+
+	//This is the only upload of the camera's transforms for the whole frame,
+	//no matter how many programs or draw calls use them.
+	glBindBuffer(GL_UNIFORM_BUFFER, s_viewConstantsBufferId);
+	EAE6320_GL_CHECKERRORS();
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(s_viewConstants), &s_viewConstants);
+	EAE6320_GL_CHECKERRORS();
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	EAE6320_GL_CHECKERRORS();
 }
 
-void eae6320::Graphics::SetMaterialUniform(const Effect& i_effect, float i_values[], uint8_t i_valueCountToSet, tUniformHandle i_uniformHandle, eShaderType i_shaderType)
+void eae6320::Graphics::SetInstanceTransforms(const eae6320::Math::cMatrix_transformation* const i_transforms, const size_t i_count)
 {
-	switch (i_valueCountToSet)
+	if (i_count == 0)
 	{
-	case 1:
-		glUniform1fv(i_uniformHandle, 1, i_values);
-		break;
+		return;
+	}
+	const size_t instanceSize = sizeof(eae6320::Math::cMatrix_transformation);
+	glBindBuffer(GL_ARRAY_BUFFER, s_instanceBufferId);
+	EAE6320_GL_CHECKERRORS();
+	//The buffer only ever grows, and doubling keeps reallocations rare
+	while (s_instanceBufferCapacity < i_count)
+	{
+		s_instanceBufferCapacity *= 2;
+	}
+	//The last frame's instanced draws might still be reading the buffer,
+	//and so it is orphaned every frame: the driver gives it new storage instead of waiting for them to finish
+	glBufferData(GL_ARRAY_BUFFER, s_instanceBufferCapacity * instanceSize, NULL, GL_STREAM_DRAW);
+	EAE6320_GL_CHECKERRORS();
+	glBufferSubData(GL_ARRAY_BUFFER, 0, i_count * instanceSize, i_transforms);
+	EAE6320_GL_CHECKERRORS();
+}
+
+bool eae6320::Graphics::SetDrawCallUniforms(Effect& i_effect, eae6320::Math::cMatrix_transformation& i_offsetMatrix)
+{
+	const GLboolean dontTranspose = false; // Matrices are already in the correct format
+	const GLsizei uniformCountToSet = 1;
+
+	if (i_effect.localToProjected != -1)
+	{
+		//Concatenating once here saves two matrix multiplies per vertex and two uploads per draw,
+		//and worldToProjected was already concatenated for the whole frame.
+		eae6320::Math::cMatrix_transformation localToProjected = i_offsetMatrix * s_viewConstants.worldToProjected;
+		glUniformMatrix4fv(i_effect.localToProjected, uniformCountToSet, dontTranspose, reinterpret_cast<const GLfloat*>(&localToProjected));
+		EAE6320_GL_CHECKERRORS();
+	}
+	else
+	{
+		//The rest of the transforms are already in the view constants buffer.
+		glUniformMatrix4fv(i_effect.localToWorld, uniformCountToSet, dontTranspose, reinterpret_cast<const GLfloat*>(&i_offsetMatrix));
+		EAE6320_GL_CHECKERRORS();
+	}
+
+	return true;
+}
+
+void eae6320::Graphics::SetMaterialUniform(const Effect& i_effect, float i_values[], uint8_t i_valueCountToSet, tUniformHandle i_uniformHandle, eShaderType i_shaderType)
+{
+	switch (i_valueCountToSet)
+	{
+	case 1:
+		glUniform1fv(i_uniformHandle, 1, i_values);
+		break;
 	case 2:
 		glUniform2fv(i_uniformHandle, 1, i_values);
 		break;
 	case 3:
 		glUniform3fv(i_uniformHandle, 1, i_values);
-		assert(glGetError() == GL_NO_ERROR);
 		break;
 	case 4:
 		glUniform4fv(i_uniformHandle, 1, i_values);
@@ -1501,19 +1727,146 @@ void eae6320::Graphics::SetMaterialUniform(const Effect& i_effect, float i_value
 	default:
 		break;
 	}
-	glUniform2fv(i_uniformHandle, i_valueCountToSet, i_values);
+	EAE6320_GL_CHECKERRORS();
+	++s_frameStatistics.stateChanges;
 }
 
-void eae6320::Graphics::DrawMesh(const eae6320::Graphics::Mesh& i_Mesh)
+bool eae6320::Graphics::CreateMaterialConstants(Material& io_material, const char* const* const i_uniformNames)
 {
-	// The actual function calls that draw geometry
+	const GLuint programId = io_material.m_effect.m_programID;
+	const GLuint blockIndex = glGetUniformBlockIndex(programId, "g_materialConstants");
+	if (blockIndex == GL_INVALID_INDEX)
 	{
-		// Bind a specific vertex buffer to the device as a data source
+		//The uniforms are part of the program's state,
+		//so they are set the first time the material is bound and then only when they change.
+		for (uint8_t i = 0; i < io_material.m_noOfUniforms; i++)
 		{
-			glBindVertexArray(i_Mesh.m_vertexArrayID);
-			const GLenum errorCode = glGetError();
-			assert(glGetError() == GL_NO_ERROR);
+			io_material.m_uniforms[i].uniformHandle = GetUniform(io_material.m_effect, i_uniformNames[i], io_material.m_uniforms[i].shaderType);
+		}
+		*io_material.m_areConstantsDirty = true;
+		return true;
+	}
+	glUniformBlockBinding(programId, blockIndex, s_materialConstantsBindingPoint);
+	EAE6320_GL_CHECKERRORS();
+
+	//The block is uploaded as it was baked, so the shader has to declare the members in the same order as the material file.
+	for (uint8_t i = 0; i < io_material.m_noOfUniforms; i++)
+	{
+		GLuint uniformIndex = GL_INVALID_INDEX;
+		glGetUniformIndices(programId, 1, &i_uniformNames[i], &uniformIndex);
+		GLint uniformOffset = -1;
+		if (uniformIndex != GL_INVALID_INDEX)
+		{
+			glGetActiveUniformsiv(programId, 1, &uniformIndex, GL_UNIFORM_OFFSET, &uniformOffset);
+		}
+		if (uniformOffset != static_cast<GLint>(io_material.m_uniforms[i].blockOffset))
+		{
+			std::stringstream errorMessage;
+			errorMessage << "The uniform " << i_uniformNames[i] << " was baked at offset " << io_material.m_uniforms[i].blockOffset <<
+				" but g_materialConstants has it at " << uniformOffset;
+			eae6320::UserOutput::Print(errorMessage.str());
+			return false;
+		}
+	}
+
+	const GLsizei bufferCount = 1;
+	glGenBuffers(bufferCount, &io_material.m_constantBufferId);
+	GLenum errorCode = glGetError();
+	if (errorCode != GL_NO_ERROR)
+	{
+		std::stringstream errorMessage;
+		errorMessage << "OpenGL failed to get an unused material constants buffer ID: " <<
+			reinterpret_cast<const char*>(gluErrorString(errorCode));
+		eae6320::UserOutput::Print(errorMessage.str());
+		return false;
+	}
+	glBindBuffer(GL_UNIFORM_BUFFER, io_material.m_constantBufferId);
+	//The values are uploaded once here and only again if SetMaterialConstant() changes them
+	glBufferData(GL_UNIFORM_BUFFER, io_material.m_constantsSize, io_material.m_constants, GL_STATIC_DRAW);
+	errorCode = glGetError();
+	if (errorCode != GL_NO_ERROR)
+	{
+		std::stringstream errorMessage;
+		errorMessage << "OpenGL failed to allocate the material constants buffer: " <<
+			reinterpret_cast<const char*>(gluErrorString(errorCode));
+		eae6320::UserOutput::Print(errorMessage.str());
+		return false;
+	}
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	*io_material.m_areConstantsDirty = false;
+	return true;
+}
+
+void eae6320::Graphics::DestroyMaterialConstants(Material& io_material)
+{
+	if (io_material.m_constantBufferId != 0)
+	{
+		if (s_stateCache.materialConstantsBuffer == io_material.m_constantBufferId)
+		{
+			s_stateCache.materialConstantsBuffer = 0;
 		}
+		const GLsizei bufferCount = 1;
+		glDeleteBuffers(bufferCount, &io_material.m_constantBufferId);
+		EAE6320_GL_CHECKERRORS();
+		io_material.m_constantBufferId = 0;
+	}
+	//The uniforms are about to be deleted, and new ones could be allocated at the same address
+	std::map<GLuint, const sUniformHelper*>::iterator owner = s_programUniformOwners.find(io_material.m_effect.m_programID);
+	if ((owner != s_programUniformOwners.end()) && (owner->second == io_material.m_uniforms))
+	{
+		s_programUniformOwners.erase(owner);
+	}
+}
+
+void eae6320::Graphics::BindMaterialConstants(Material& io_material)
+{
+	if (io_material.m_constantBufferId == 0)
+	{
+		const sUniformHelper*& owner = s_programUniformOwners[io_material.m_effect.m_programID];
+		if (*io_material.m_areConstantsDirty || (owner != io_material.m_uniforms))
+		{
+			for (uint8_t i = 0; i < io_material.m_noOfUniforms; i++)
+			{
+				sUniformHelper& uniform = io_material.m_uniforms[i];
+				SetMaterialUniform(io_material.m_effect, uniform.values, uniform.valueCountToSet, uniform.uniformHandle, uniform.shaderType);
+			}
+			*io_material.m_areConstantsDirty = false;
+			owner = io_material.m_uniforms;
+		}
+		else
+		{
+			++s_frameStatistics.redundantStateChanges;
+		}
+		return;
+	}
+
+	if (*io_material.m_areConstantsDirty)
+	{
+		glBindBuffer(GL_UNIFORM_BUFFER, io_material.m_constantBufferId);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, io_material.m_constantsSize, io_material.m_constants);
+		EAE6320_GL_CHECKERRORS();
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		*io_material.m_areConstantsDirty = false;
+		++s_frameStatistics.stateChanges;
+	}
+	if (s_stateCache.materialConstantsBuffer != io_material.m_constantBufferId)
+	{
+		glBindBufferBase(GL_UNIFORM_BUFFER, s_materialConstantsBindingPoint, io_material.m_constantBufferId);
+		EAE6320_GL_CHECKERRORS();
+		s_stateCache.materialConstantsBuffer = io_material.m_constantBufferId;
+		++s_frameStatistics.stateChanges;
+	}
+	else
+	{
+		++s_frameStatistics.redundantStateChanges;
+	}
+}
+
+void eae6320::Graphics::DrawMesh(const eae6320::Graphics::Mesh& i_Mesh)
+{
+	// The actual function calls that draw geometry
+	{
+		BindMeshForDrawing(i_Mesh);
 		// Render objects from the current streams
 		{
 			// We are using triangles as the "primitive" type,
@@ -1530,113 +1883,79 @@ void eae6320::Graphics::DrawMesh(const eae6320::Graphics::Mesh& i_Mesh)
 			const GLsizei vertexCountPerTriangle = 3;
 			const GLsizei vertexCountToRender = primitiveCountToRender * vertexCountPerTriangle;
 			glDrawElements(mode, vertexCountToRender, indexType, offset);
-			assert(glGetError() == GL_NO_ERROR);
+			EAE6320_GL_CHECKERRORS();
+			++s_frameStatistics.drawCalls;
 		}
 	}
 }
 
+void eae6320::Graphics::DrawMeshInstanced(const Mesh& i_mesh, const size_t i_firstInstance, const size_t i_instanceCount)
+{
+	BindMeshForDrawing(i_mesh);
+	//OpenGL 3.3 can't offset the instance index itself, so the attributes are offset instead
+	SetInstanceTransformAttributes(i_firstInstance);
+	{
+		const GLenum mode = GL_TRIANGLES;
+		const GLenum indexType = GL_UNSIGNED_INT;
+		const GLvoid* const offset = 0;
+		const GLsizei vertexCountToRender = static_cast<GLsizei>(i_mesh.m_noOfIndices);
+		glDrawElementsInstanced(mode, vertexCountToRender, indexType, offset, static_cast<GLsizei>(i_instanceCount));
+		EAE6320_GL_CHECKERRORS();
+		++s_frameStatistics.drawCalls;
+	}
+}
+
 bool eae6320::Graphics::ShutDown()
 {
 	bool wereThereErrors = false;
+	StopWorkerThreads();
 
-	if ( s_openGlRenderingContext != NULL )
+	if ( RenderingContext::Exists() )
 	{
-		std::vector<eae6320::Graphics::Renderable*>* m_renderableList = GetOpaqueRenderableList();
-		size_t size = m_renderableList->size();
-		{
-			const GLsizei arrayCount = 1;
-
-			for (unsigned int i = 0; i < size; i++)
-			{
-				{
-					glDeleteProgram((*m_renderableList)[i]->m_material.m_effect.m_programID);
-					const GLenum errorCode = glGetError();
-					if (errorCode != GL_NO_ERROR)
-					{
-						std::stringstream errorMessage;
-						errorMessage << "OpenGL failed to delete the program: " <<
-							reinterpret_cast<const char*>(gluErrorString(errorCode));
-						UserOutput::Print(errorMessage.str());
-					}
-					(*m_renderableList)[i]->m_material.m_effect.m_programID = 0;
-				}
+		//Assets can be shared by several renderables, and so they are destroyed through the cache that shares them
+		UnloadAllAssets();
 
-				{
-					glDeleteVertexArrays(arrayCount, &((*m_renderableList)[i]->m_mesh.m_vertexArrayID));
-					const GLenum errorCode = glGetError();
-					if (errorCode != GL_NO_ERROR)
-					{
-						std::stringstream errorMessage;
-						errorMessage << "OpenGL failed to delete the vertex array: " <<
-							reinterpret_cast<const char*>(gluErrorString(errorCode));
-						UserOutput::Print(errorMessage.str());
-					}
-					(*m_renderableList)[i]->m_mesh.m_vertexArrayID = 0;
-				}
-			}
-		}
-
-		m_renderableList = GetTransparentRenderableList();
-		size = m_renderableList->size();
+		if (s_instanceBufferId != 0)
 		{
-			const GLsizei arrayCount = 1;
-
-			for (unsigned int i = 0; i < size; i++)
+			const GLsizei bufferCount = 1;
+			glDeleteBuffers(bufferCount, &s_instanceBufferId);
+			const GLenum errorCode = glGetError();
+			if (errorCode != GL_NO_ERROR)
 			{
-				{
-					glDeleteProgram((*m_renderableList)[i]->m_material.m_effect.m_programID);
-					const GLenum errorCode = glGetError();
-					if (errorCode != GL_NO_ERROR)
-					{
-						std::stringstream errorMessage;
-						errorMessage << "OpenGL failed to delete the program: " <<
-							reinterpret_cast<const char*>(gluErrorString(errorCode));
-						UserOutput::Print(errorMessage.str());
-					}
-					(*m_renderableList)[i]->m_material.m_effect.m_programID = 0;
-				}
-
-				{
-					glDeleteVertexArrays(arrayCount, &((*m_renderableList)[i]->m_mesh.m_vertexArrayID));
-					const GLenum errorCode = glGetError();
-					if (errorCode != GL_NO_ERROR)
-					{
-						std::stringstream errorMessage;
-						errorMessage << "OpenGL failed to delete the vertex array: " <<
-							reinterpret_cast<const char*>(gluErrorString(errorCode));
-						UserOutput::Print(errorMessage.str());
-					}
-					(*m_renderableList)[i]->m_mesh.m_vertexArrayID = 0;
-				}
+				std::stringstream errorMessage;
+				errorMessage << "OpenGL failed to delete the instance buffer: " <<
+					reinterpret_cast<const char*>(gluErrorString(errorCode));
+				UserOutput::Print(errorMessage.str());
 			}
+			s_instanceBufferId = 0;
 		}
-		
-		if ( wglMakeCurrent( s_deviceContext, NULL ) != FALSE )
+		if (s_viewConstantsBufferId != 0)
 		{
-			if ( wglDeleteContext( s_openGlRenderingContext ) == FALSE )
+			const GLsizei bufferCount = 1;
+			glDeleteBuffers(bufferCount, &s_viewConstantsBufferId);
+			const GLenum errorCode = glGetError();
+			if (errorCode != GL_NO_ERROR)
 			{
 				std::stringstream errorMessage;
-				errorMessage << "Windows failed to delete the OpenGL rendering context: " << GetLastWindowsError();
-				UserOutput::Print( errorMessage.str() );
+				errorMessage << "OpenGL failed to delete the view constants buffer: " <<
+					reinterpret_cast<const char*>(gluErrorString(errorCode));
+				UserOutput::Print(errorMessage.str());
 			}
+			s_viewConstantsBufferId = 0;
 		}
-		else
-		{
-			std::stringstream errorMessage;
-			errorMessage << "Windows failed to unset the current OpenGL rendering context: " << GetLastWindowsError();
-			UserOutput::Print( errorMessage.str() );
-		}
-		s_openGlRenderingContext = NULL;
-	}
 
-	if ( s_deviceContext != NULL )
+		InvalidateStateCache();
+	}
+	//The debug callback belongs to the context
+	if (s_errorCheckMode == errorChecksDebugOutput)
 	{
-		// The documentation says that this call isn't necessary when CS_OWNDC is used
-		ReleaseDC( s_renderingWindow, s_deviceContext );
-		s_deviceContext = NULL;
+		s_errorCheckMode = s_defaultErrorCheckMode;
+	}
+	s_pendingDebugMessage.clear();
+	if ( !RenderingContext::Destroy() )
+	{
+		wereThereErrors = true;
 	}
-
-	s_renderingWindow = NULL;
 
 	return !wereThereErrors;
 }
@@ -1646,203 +1965,269 @@ bool eae6320::Graphics::ShutDown()
 
 float eae6320::Graphics::getAspectRatio()
 {
-	RECT renderingWindow;
-	GetWindowRect(s_renderingWindow, &renderingWindow);
-
-	int screenWidth = renderingWindow.right - renderingWindow.left;
-	int screenHeight = renderingWindow.bottom - renderingWindow.top;
-
-	return static_cast<float>((float)screenWidth / (float)screenHeight);
+	return RenderingContext::GetAspectRatio();
 }
 
-
 namespace
 {
+	void InvalidateStateCache()
+	{
+		//Zero is never a valid active texture unit, so the first SetTexture() will always set it
+		s_stateCache.program = 0;
+		s_stateCache.vertexArray = 0;
+		s_stateCache.areRenderStatesKnown = false;
+		s_stateCache.renderStates = 0;
+		s_stateCache.activeTextureUnit = 0;
+		for (GLuint i = 0; i < s_cachedTextureUnitCount; ++i)
+		{
+			s_stateCache.boundTextures[i] = 0;
+		}
+		s_stateCache.materialConstantsBuffer = 0;
+	}
+
+	void BindTexture(const GLuint i_textureUnit, const GLuint i_texture)
+	{
+		const GLenum textureUnit = GL_TEXTURE0 + i_textureUnit;
+		const bool isUnitCached = i_textureUnit < s_cachedTextureUnitCount;
+		if (isUnitCached && (s_stateCache.boundTextures[i_textureUnit] == i_texture))
+		{
+			++s_frameStatistics.redundantStateChanges;
+			++s_frameStatistics.redundantTextureBinds;
+			return;
+		}
+		if (s_stateCache.activeTextureUnit != textureUnit)
+		{
+			glActiveTexture(textureUnit);
+			EAE6320_GL_CHECKERRORS();
+			s_stateCache.activeTextureUnit = textureUnit;
+			++s_frameStatistics.stateChanges;
+		}
+		glBindTexture(GL_TEXTURE_2D, i_texture);
+		EAE6320_GL_CHECKERRORS();
+		if (isUnitCached)
+		{
+			s_stateCache.boundTextures[i_textureUnit] = i_texture;
+		}
+		++s_frameStatistics.stateChanges;
+		++s_frameStatistics.textureBinds;
+	}
 
-	bool CreateRenderingContext()
+	bool CreateViewConstantsBuffer()
 	{
-		// A "device context" can be thought of an abstraction that Windows uses
-		// to represent the graphics adaptor used to display a given window
-		s_deviceContext = GetDC( s_renderingWindow );
-		if ( s_deviceContext == NULL )
+		const GLsizei bufferCount = 1;
+		glGenBuffers(bufferCount, &s_viewConstantsBufferId);
+		GLenum errorCode = glGetError();
+		if (errorCode != GL_NO_ERROR)
 		{
-			eae6320::UserOutput::Print( "Windows failed to get the device context" );
+			std::stringstream errorMessage;
+			errorMessage << "OpenGL failed to get an unused view constants buffer ID: " <<
+				reinterpret_cast<const char*>(gluErrorString(errorCode));
+			eae6320::UserOutput::Print(errorMessage.str());
 			return false;
 		}
-		// Windows requires that an OpenGL "render context" is made for the window we want to use to render into
+		glBindBuffer(GL_UNIFORM_BUFFER, s_viewConstantsBufferId);
+		errorCode = glGetError();
+		if (errorCode != GL_NO_ERROR)
 		{
-			// Set the pixel format of the rendering window
-			{
-				PIXELFORMATDESCRIPTOR desiredPixelFormat = { 0 };
-				{
-					desiredPixelFormat.nSize = sizeof( PIXELFORMATDESCRIPTOR );
-					desiredPixelFormat.nVersion = 1;
-
-					desiredPixelFormat.dwFlags = PFD_SUPPORT_OPENGL | PFD_DRAW_TO_WINDOW | PFD_DOUBLEBUFFER;
-					desiredPixelFormat.iPixelType = PFD_TYPE_RGBA;
-					desiredPixelFormat.cColorBits = 32;
-					desiredPixelFormat.iLayerType = PFD_MAIN_PLANE ;
-					desiredPixelFormat.cDepthBits = 16;
-				}
-				// Get the ID of the desired pixel format
-				int pixelFormatId;
-				{
-					pixelFormatId = ChoosePixelFormat( s_deviceContext, &desiredPixelFormat );
-					if ( pixelFormatId == 0 )
-					{
-						std::stringstream errorMessage;
-						errorMessage << "Windows couldn't choose the closest pixel format: " << eae6320::GetLastWindowsError();
-						eae6320::UserOutput::Print( errorMessage.str() );
-						return false;
-					}
-				}
-				// Set it
-				if ( SetPixelFormat( s_deviceContext, pixelFormatId, &desiredPixelFormat ) == FALSE )
-				{
-					std::stringstream errorMessage;
-					errorMessage << "Windows couldn't set the desired pixel format: " << eae6320::GetLastWindowsError();
-					eae6320::UserOutput::Print( errorMessage.str() );
-					return false;
-				}
-			}
-			// Create the OpenGL rendering context
-			s_openGlRenderingContext = wglCreateContext( s_deviceContext );
-			if ( s_openGlRenderingContext == NULL )
-			{
-				std::stringstream errorMessage;
-				errorMessage << "Windows failed to create an OpenGL rendering context: " << eae6320::GetLastWindowsError();
-				eae6320::UserOutput::Print( errorMessage.str() );
-				return false;
-			}
-			// Set it as the rendering context of this thread
-			if ( wglMakeCurrent( s_deviceContext, s_openGlRenderingContext ) == FALSE )
-			{
-				std::stringstream errorMessage;
-				errorMessage << "Windows failed to set the current OpenGL rendering context: " << eae6320::GetLastWindowsError();
-				eae6320::UserOutput::Print( errorMessage.str() );
-				return false;
-			}
+			std::stringstream errorMessage;
+			errorMessage << "OpenGL failed to bind the view constants buffer: " <<
+				reinterpret_cast<const char*>(gluErrorString(errorCode));
+			eae6320::UserOutput::Print(errorMessage.str());
+			return false;
+		}
+		// The contents are replaced every frame
+		glBufferData(GL_UNIFORM_BUFFER, sizeof(eae6320::Graphics::sViewConstants), NULL, GL_DYNAMIC_DRAW);
+		errorCode = glGetError();
+		if (errorCode != GL_NO_ERROR)
+		{
+			std::stringstream errorMessage;
+			errorMessage << "OpenGL failed to allocate the view constants buffer: " <<
+				reinterpret_cast<const char*>(gluErrorString(errorCode));
+			eae6320::UserOutput::Print(errorMessage.str());
+			return false;
 		}
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		// The buffer stays attached to its binding point for as long as it exists
+		glBindBufferBase(GL_UNIFORM_BUFFER, s_viewConstantsBindingPoint, s_viewConstantsBufferId);
+		errorCode = glGetError();
+		if (errorCode != GL_NO_ERROR)
+		{
+			std::stringstream errorMessage;
+			errorMessage << "OpenGL failed to bind the view constants buffer to its binding point: " <<
+				reinterpret_cast<const char*>(gluErrorString(errorCode));
+			eae6320::UserOutput::Print(errorMessage.str());
+			return false;
+		}
+		return true;
+	}
 
+	bool CreateInstanceBuffer()
+	{
+		const GLsizei bufferCount = 1;
+		glGenBuffers(bufferCount, &s_instanceBufferId);
+		GLenum errorCode = glGetError();
+		if (errorCode != GL_NO_ERROR)
+		{
+			std::stringstream errorMessage;
+			errorMessage << "OpenGL failed to get an unused instance buffer ID: " <<
+				reinterpret_cast<const char*>(gluErrorString(errorCode));
+			eae6320::UserOutput::Print(errorMessage.str());
+			return false;
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, s_instanceBufferId);
+		// The contents are replaced every frame
+		glBufferData(GL_ARRAY_BUFFER, s_instanceBufferCapacity * sizeof(eae6320::Math::cMatrix_transformation), NULL, GL_STREAM_DRAW);
+		errorCode = glGetError();
+		if (errorCode != GL_NO_ERROR)
+		{
+			std::stringstream errorMessage;
+			errorMessage << "OpenGL failed to allocate the instance buffer: " <<
+				reinterpret_cast<const char*>(gluErrorString(errorCode));
+			eae6320::UserOutput::Print(errorMessage.str());
+			return false;
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
 		return true;
 	}
 
-	bool LoadAndAllocateShaderProgram( const char* i_path, void*& o_shader, size_t& o_size, std::string* o_errorMessage )
+	void SetInstanceTransformAttributes(const size_t i_firstInstance)
 	{
-		bool wereThereErrors = false;
+		const GLsizei stride = static_cast<GLsizei>(sizeof(eae6320::Math::cMatrix_transformation));
+		const size_t columnSize = 4 * sizeof(float);
+		glBindBuffer(GL_ARRAY_BUFFER, s_instanceBufferId);
+		for (GLuint i = 0; i < s_instanceTransformLocationCount; ++i)
+		{
+			const GLvoid* const offset = reinterpret_cast<GLvoid*>((i_firstInstance * stride) + (i * columnSize));
+			glVertexAttribPointer(s_instanceTransformLocation + i, 4, GL_FLOAT, GL_FALSE, stride, offset);
+		}
+		EAE6320_GL_CHECKERRORS();
+	}
 
-		// Load the shader source from disk
-		o_shader = NULL;
-		HANDLE fileHandle = INVALID_HANDLE_VALUE;
+	void BindMeshForDrawing(const eae6320::Graphics::Mesh& i_mesh)
+	{
+		// Bind a specific vertex buffer to the device as a data source
+		if (s_stateCache.vertexArray != i_mesh.m_vertexArrayID)
 		{
-			// Open the file
+			glBindVertexArray(i_mesh.m_vertexArrayID);
+			EAE6320_GL_CHECKERRORS();
+			s_stateCache.vertexArray = i_mesh.m_vertexArrayID;
+			++s_frameStatistics.stateChanges;
+		}
+		else
+		{
+			++s_frameStatistics.redundantStateChanges;
+		}
+		// A disabled attribute array reads the current generic value instead,
+		// and that isn't guaranteed to survive draws that used the array
+		if (i_mesh.m_vertexFormat == eae6320::Graphics::quantizedVerticesNoColor)
+		{
+			const GLuint colorLocation = 1;
+			glVertexAttrib4f(colorLocation, 1.0f, 1.0f, 1.0f, 1.0f);
+			EAE6320_GL_CHECKERRORS();
+		}
+	}
+
+	void ReportErrors(const char* const i_file, const int i_line)
+	{
+		for (size_t i = 0; i < s_maxErrorCountPerCheck; ++i)
+		{
+			const GLenum errorCode = glGetError();
+			if (errorCode == GL_NO_ERROR)
 			{
-				const DWORD desiredAccess = FILE_GENERIC_READ;
-				const DWORD otherProgramsCanStillReadTheFile = FILE_SHARE_READ;
-				SECURITY_ATTRIBUTES* useDefaultSecurity = NULL;
-				const DWORD onlySucceedIfFileExists = OPEN_EXISTING;
-				const DWORD useDefaultAttributes = FILE_ATTRIBUTE_NORMAL;
-				const HANDLE dontUseTemplateFile = NULL;
-				fileHandle = CreateFile( i_path, desiredAccess, otherProgramsCanStillReadTheFile,
-					useDefaultSecurity, onlySucceedIfFileExists, useDefaultAttributes, dontUseTemplateFile );
-				if ( fileHandle == INVALID_HANDLE_VALUE )
-				{
-					wereThereErrors = true;
-					if ( o_errorMessage )
-					{
-						std::string windowsErrorMessage = eae6320::GetLastWindowsError();
-						std::stringstream errorMessage;
-						errorMessage << "Windows failed to open the shader file: " <<
-							windowsErrorMessage;
-						*o_errorMessage = errorMessage.str();
-					}
-					goto OnExit;
-				}
+				return;
 			}
-			// Get the file's size
+			++s_frameStatistics.apiErrors;
+			if (!s_hasErrorBeenReported)
 			{
-				LARGE_INTEGER fileSize_integer;
-				if ( GetFileSizeEx( fileHandle, &fileSize_integer ) != FALSE )
+				std::stringstream errorMessage;
+				errorMessage << "OpenGL error " << std::hex << std::showbase << errorCode << " (" <<
+					reinterpret_cast<const char*>(gluErrorString(errorCode)) << ") ";
+				if (i_file)
 				{
-					assert( fileSize_integer.QuadPart <= SIZE_MAX );
-					o_size = static_cast<size_t>( fileSize_integer.QuadPart );
+					errorMessage << "at " << i_file << "(" << std::dec << i_line << ")";
 				}
 				else
 				{
-					wereThereErrors = true;
-					if ( o_errorMessage )
-					{
-						std::string windowsErrorMessage = eae6320::GetLastWindowsError();
-						std::stringstream errorMessage;
-						errorMessage << "Windows failed to get the size of shader: " <<
-							windowsErrorMessage;
-						*o_errorMessage = errorMessage.str();
-					}
-					goto OnExit;
+					errorMessage << "during the frame";
 				}
-				// Add an extra byte for a NULL terminator
-				o_size += 1;
+				ReportFirstError(errorMessage.str());
 			}
-			// Read the file's contents into temporary memory
-			o_shader = malloc( o_size );
-			if ( o_shader )
-			{
-				DWORD bytesReadCount;
-				OVERLAPPED* readSynchronously = NULL;
-				if ( ReadFile( fileHandle, o_shader, o_size,
-					&bytesReadCount, readSynchronously ) == FALSE )
-				{
-					wereThereErrors = true;
-					if ( o_errorMessage )
-					{
-						std::string windowsErrorMessage = eae6320::GetLastWindowsError();
-						std::stringstream errorMessage;
-						errorMessage << "Windows failed to read the contents of shader: " <<
-							windowsErrorMessage;
-						*o_errorMessage = errorMessage.str();
-					}
-					goto OnExit;
-				}
-			}
-			else
-			{
-				wereThereErrors = true;
-				if ( o_errorMessage )
-				{
-					std::stringstream errorMessage;
-					errorMessage << "Failed to allocate " << o_size << " bytes to read in the shader program " << i_path;
-					*o_errorMessage = errorMessage.str();
-				}
-				goto OnExit;
-			}
-			// Add the NULL terminator
-			reinterpret_cast<char*>(o_shader)[o_size - 1] = '\0';
 		}
+	}
 
-	OnExit:
+	void ReportFirstError(const std::string& i_errorMessage)
+	{
+		if (!s_hasErrorBeenReported)
+		{
+			eae6320::UserOutput::Print(i_errorMessage + " (any errors after this one are only counted in the frame statistics)");
+			s_hasErrorBeenReported = true;
+		}
+	}
 
-		if ( wereThereErrors && o_shader )
+	void ClearErrors()
+	{
+		for (size_t i = 0; (i < s_maxErrorCountPerCheck) && (glGetError() != GL_NO_ERROR); ++i)
 		{
-			free( o_shader );
-			o_shader = NULL;
 		}
-		if ( fileHandle != INVALID_HANDLE_VALUE )
+	}
+
+#if defined( EAE6320_GRAPHICS_GL_PER_CALL_CHECKS )
+	void CheckErrorsAfterCall(const char* const i_file, const int i_line)
+	{
+		if (s_errorCheckMode == eae6320::Graphics::errorChecksPerCall)
+		{
+			ReportErrors(i_file, i_line);
+		}
+		else if (!s_pendingDebugMessage.empty())
 		{
-			if ( CloseHandle( fileHandle ) == FALSE )
+			std::stringstream errorMessage;
+			errorMessage << s_pendingDebugMessage << " at " << i_file << "(" << i_line << ")";
+			ReportFirstError(errorMessage.str());
+			s_pendingDebugMessage.clear();
+		}
+	}
+#endif
+
+	void APIENTRY OnDebugMessage(GLenum i_source, GLenum i_type, GLuint i_id, GLenum i_severity, GLsizei i_length,
+		const GLchar* i_message, const void* i_userParam)
+	{
+		//Performance hints and other notifications aren't errors
+		if ((i_type != GL_DEBUG_TYPE_ERROR) && (i_severity != GL_DEBUG_SEVERITY_HIGH))
+		{
+			return;
+		}
+		++s_frameStatistics.apiErrors;
+		if (s_hasErrorBeenReported || !s_pendingDebugMessage.empty())
+		{
+			return;
+		}
+		const std::string errorMessage = std::string("OpenGL reported \"") + i_message + "\"";
+#if defined( EAE6320_GRAPHICS_GL_PER_CALL_CHECKS )
+		//The check after the call that is running now will report it
+		s_pendingDebugMessage = errorMessage;
+#else
+		ReportFirstError(errorMessage);
+#endif
+	}
+
+	bool IsExtensionSupported(const char* const i_extensionName)
+	{
+		//The names are separated by spaces, and one name can be the start of another
+		const char* const extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+		if (extensions == NULL)
+		{
+			return false;
+		}
+		const size_t nameLength = std::strlen(i_extensionName);
+		for (const char* name = std::strstr(extensions, i_extensionName); name != NULL; name = std::strstr(name + nameLength, i_extensionName))
+		{
+			const bool isStartOfName = (name == extensions) || (name[-1] == ' ');
+			const bool isEndOfName = (name[nameLength] == ' ') || (name[nameLength] == '\0');
+			if (isStartOfName && isEndOfName)
 			{
-				if ( !wereThereErrors && o_errorMessage )
-				{
-					std::string windowsError = eae6320::GetLastWindowsError();
-					std::stringstream errorMessage;
-					errorMessage << "Windows failed to close the shader file handle: " <<
-						windowsError;
-					*o_errorMessage = errorMessage.str();
-				}
-				wereThereErrors = true;
+				return true;
 			}
-			fileHandle = INVALID_HANDLE_VALUE;
 		}
-
-		return !wereThereErrors;
+		return false;
 	}
 }
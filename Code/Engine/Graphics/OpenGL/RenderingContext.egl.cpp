@@ -0,0 +1,230 @@
+// Header Files
+//=============
+
+#include "RenderingContext.h"
+
+#include <cstring>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GL/gl.h>
+#include <sstream>
+#include "../../UserOutput/UserOutput.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	EGLDisplay s_display = EGL_NO_DISPLAY;
+	EGLSurface s_surface = EGL_NO_SURFACE;
+	EGLContext s_openGlRenderingContext = EGL_NO_CONTEXT;
+
+	// There is no window, so this is the size of the offscreen surface that is rendered into instead
+	// (it is the size of a typical game window so that the rasterizer has a realistic amount of work)
+	const EGLint s_surfaceWidth = 1280;
+	const EGLint s_surfaceHeight = 720;
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	EGLDisplay GetDisplay();
+	void PrintEglError( const char* const i_whatFailed );
+}
+
+// Interface
+//==========
+
+bool eae6320::Graphics::RenderingContext::Create( const HWND i_renderingWindow )
+{
+	s_display = GetDisplay();
+	if ( s_display == EGL_NO_DISPLAY )
+	{
+		PrintEglError( "EGL failed to get a display" );
+		return false;
+	}
+	{
+		EGLint majorVersion, minorVersion;
+		if ( eglInitialize( s_display, &majorVersion, &minorVersion ) == EGL_FALSE )
+		{
+			PrintEglError( "EGL failed to initialize" );
+			return false;
+		}
+		if ( ( majorVersion < 1 ) || ( ( majorVersion == 1 ) && ( minorVersion < 5 ) ) )
+		{
+			std::stringstream errorMessage;
+			errorMessage << "EGL 1.5 is required to load the OpenGL functions, but only " << majorVersion << "." << minorVersion << " is available";
+			eae6320::UserOutput::Print( errorMessage.str() );
+			return false;
+		}
+	}
+	if ( eglBindAPI( EGL_OPENGL_API ) == EGL_FALSE )
+	{
+		PrintEglError( "EGL doesn't support desktop OpenGL" );
+		return false;
+	}
+
+	// The same kind of pixel format that Windows asks for, but for a pbuffer instead of a window
+	EGLConfig config;
+	{
+		const EGLint desiredAttributes[] =
+		{
+			EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+			EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+			EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+			EGL_DEPTH_SIZE, 16,
+			EGL_NONE
+		};
+		EGLint configCount = 0;
+		if ( ( eglChooseConfig( s_display, desiredAttributes, &config, 1, &configCount ) == EGL_FALSE ) || ( configCount == 0 ) )
+		{
+			PrintEglError( "EGL couldn't find a pbuffer configuration that supports OpenGL" );
+			return false;
+		}
+	}
+	{
+		const EGLint surfaceAttributes[] = { EGL_WIDTH, s_surfaceWidth, EGL_HEIGHT, s_surfaceHeight, EGL_NONE };
+		s_surface = eglCreatePbufferSurface( s_display, config, surfaceAttributes );
+		if ( s_surface == EGL_NO_SURFACE )
+		{
+			PrintEglError( "EGL failed to create a pbuffer surface" );
+			return false;
+		}
+	}
+	// The shaders are written against the compatibility profile (just like the context that wglCreateContext() makes),
+	// and the version is explicit so that creation fails on implementations that can't run them
+	{
+		const EGLint contextAttributes[] =
+		{
+			EGL_CONTEXT_MAJOR_VERSION, 3,
+			EGL_CONTEXT_MINOR_VERSION, 3,
+			EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT,
+			EGL_NONE
+		};
+		s_openGlRenderingContext = eglCreateContext( s_display, config, EGL_NO_CONTEXT, contextAttributes );
+		if ( s_openGlRenderingContext == EGL_NO_CONTEXT )
+		{
+			PrintEglError( "EGL failed to create an OpenGL 3.3 rendering context" );
+			return false;
+		}
+	}
+	// Set it as the rendering context of this thread
+	if ( eglMakeCurrent( s_display, s_surface, s_surface, s_openGlRenderingContext ) == EGL_FALSE )
+	{
+		PrintEglError( "EGL failed to set the current OpenGL rendering context" );
+		return false;
+	}
+	{
+		std::stringstream message;
+		message << "OpenGL is rendering offscreen with " << reinterpret_cast<const char*>( glGetString( GL_RENDERER ) )
+			<< " (" << reinterpret_cast<const char*>( glGetString( GL_VERSION ) ) << ")";
+		eae6320::UserOutput::Print( message.str() );
+	}
+
+	return true;
+}
+
+bool eae6320::Graphics::RenderingContext::Exists()
+{
+	return s_openGlRenderingContext != EGL_NO_CONTEXT;
+}
+
+bool eae6320::Graphics::RenderingContext::Destroy()
+{
+	bool wereThereErrors = false;
+
+	if ( s_display != EGL_NO_DISPLAY )
+	{
+		if ( eglMakeCurrent( s_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT ) == EGL_FALSE )
+		{
+			wereThereErrors = true;
+			PrintEglError( "EGL failed to unset the current OpenGL rendering context" );
+		}
+		if ( s_openGlRenderingContext != EGL_NO_CONTEXT )
+		{
+			if ( eglDestroyContext( s_display, s_openGlRenderingContext ) == EGL_FALSE )
+			{
+				wereThereErrors = true;
+				PrintEglError( "EGL failed to delete the OpenGL rendering context" );
+			}
+			s_openGlRenderingContext = EGL_NO_CONTEXT;
+		}
+		if ( s_surface != EGL_NO_SURFACE )
+		{
+			if ( eglDestroySurface( s_display, s_surface ) == EGL_FALSE )
+			{
+				wereThereErrors = true;
+				PrintEglError( "EGL failed to delete the pbuffer surface" );
+			}
+			s_surface = EGL_NO_SURFACE;
+		}
+		eglTerminate( s_display );
+		s_display = EGL_NO_DISPLAY;
+	}
+
+	return !wereThereErrors;
+}
+
+bool eae6320::Graphics::RenderingContext::MakeCurrent()
+{
+	if ( eglMakeCurrent( s_display, s_surface, s_surface, s_openGlRenderingContext ) == EGL_FALSE )
+	{
+		PrintEglError( "EGL failed to set the current OpenGL rendering context" );
+		return false;
+	}
+	return true;
+}
+
+void eae6320::Graphics::RenderingContext::ReleaseCurrent()
+{
+	eglMakeCurrent( s_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+}
+
+void eae6320::Graphics::RenderingContext::Present()
+{
+	// Swapping a pbuffer does nothing,
+	// so the frame is finished explicitly the way that a window's swap chain would throttle it
+	// (otherwise the CPU could queue up any number of frames and the timings would only measure submission)
+	glFinish();
+}
+
+float eae6320::Graphics::RenderingContext::GetAspectRatio()
+{
+	return static_cast<float>( s_surfaceWidth ) / static_cast<float>( s_surfaceHeight );
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	EGLDisplay GetDisplay()
+	{
+		// Mesa's surfaceless platform doesn't need a display server (or even a GPU),
+		// but it is only an extension and so the default display is used when it isn't available
+		const char* const clientExtensions = eglQueryString( EGL_NO_DISPLAY, EGL_EXTENSIONS );
+		if ( ( clientExtensions != NULL ) && ( std::strstr( clientExtensions, "EGL_MESA_platform_surfaceless" ) != NULL ) )
+		{
+			PFNEGLGETPLATFORMDISPLAYEXTPROC eglGetPlatformDisplayEXT =
+				reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>( eglGetProcAddress( "eglGetPlatformDisplayEXT" ) );
+			if ( eglGetPlatformDisplayEXT != NULL )
+			{
+				const EGLDisplay display = eglGetPlatformDisplayEXT( EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL );
+				if ( display != EGL_NO_DISPLAY )
+				{
+					return display;
+				}
+			}
+		}
+		return eglGetDisplay( EGL_DEFAULT_DISPLAY );
+	}
+
+	void PrintEglError( const char* const i_whatFailed )
+	{
+		std::stringstream errorMessage;
+		errorMessage << i_whatFailed << " (EGL error 0x" << std::hex << eglGetError() << ")";
+		eae6320::UserOutput::Print( errorMessage.str() );
+	}
+}
@@ -0,0 +1,42 @@
+/*
+	This file declares how the OpenGL platform gets a rendering context
+
+	Windows creates one for the game's window with WGL (RenderingContext.wgl.cpp).
+	Everywhere else it is created with EGL (RenderingContext.egl.cpp) and renders into an offscreen pbuffer,
+	which doesn't need a display or a GPU (e.g. Mesa's llvmpipe software rasterizer),
+	so that the real OpenGL submission path can be run and profiled headless.
+	Only one of the two files is built
+*/
+
+#ifndef EAE6320_GRAPHICS_OPENGL_RENDERINGCONTEXT_H
+#define EAE6320_GRAPHICS_OPENGL_RENDERINGCONTEXT_H
+
+// Header Files
+//=============
+
+#include "../../Windows/Includes.h"
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		namespace RenderingContext
+		{
+			// The new context is made current on the calling thread
+			bool Create( const HWND i_renderingWindow );
+			bool Exists();
+			bool Destroy();
+			// A context can only be current on one thread at a time
+			bool MakeCurrent();
+			void ReleaseCurrent();
+
+			void Present();
+			float GetAspectRatio();
+		}
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_OPENGL_RENDERINGCONTEXT_H
@@ -0,0 +1,169 @@
+// Header Files
+//=============
+
+#include "RenderingContext.h"
+
+#include <cassert>
+#include <sstream>
+#include "../../UserOutput/UserOutput.h"
+#include "../../Windows/Functions.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	HWND s_renderingWindow = NULL;
+	HDC s_deviceContext = NULL;
+	HGLRC s_openGlRenderingContext = NULL;
+}
+
+// Interface
+//==========
+
+bool eae6320::Graphics::RenderingContext::Create( const HWND i_renderingWindow )
+{
+	s_renderingWindow = i_renderingWindow;
+
+	// A "device context" can be thought of an abstraction that Windows uses
+	// to represent the graphics adaptor used to display a given window
+	s_deviceContext = GetDC( s_renderingWindow );
+	if ( s_deviceContext == NULL )
+	{
+		eae6320::UserOutput::Print( "Windows failed to get the device context" );
+		return false;
+	}
+	// Windows requires that an OpenGL "render context" is made for the window we want to use to render into
+	{
+		// Set the pixel format of the rendering window
+		{
+			PIXELFORMATDESCRIPTOR desiredPixelFormat = { 0 };
+			{
+				desiredPixelFormat.nSize = sizeof( PIXELFORMATDESCRIPTOR );
+				desiredPixelFormat.nVersion = 1;
+
+				desiredPixelFormat.dwFlags = PFD_SUPPORT_OPENGL | PFD_DRAW_TO_WINDOW | PFD_DOUBLEBUFFER;
+				desiredPixelFormat.iPixelType = PFD_TYPE_RGBA;
+				desiredPixelFormat.cColorBits = 32;
+				desiredPixelFormat.iLayerType = PFD_MAIN_PLANE ;
+				desiredPixelFormat.cDepthBits = 16;
+			}
+			// Get the ID of the desired pixel format
+			int pixelFormatId;
+			{
+				pixelFormatId = ChoosePixelFormat( s_deviceContext, &desiredPixelFormat );
+				if ( pixelFormatId == 0 )
+				{
+					std::stringstream errorMessage;
+					errorMessage << "Windows couldn't choose the closest pixel format: " << eae6320::GetLastWindowsError();
+					eae6320::UserOutput::Print( errorMessage.str() );
+					return false;
+				}
+			}
+			// Set it
+			if ( SetPixelFormat( s_deviceContext, pixelFormatId, &desiredPixelFormat ) == FALSE )
+			{
+				std::stringstream errorMessage;
+				errorMessage << "Windows couldn't set the desired pixel format: " << eae6320::GetLastWindowsError();
+				eae6320::UserOutput::Print( errorMessage.str() );
+				return false;
+			}
+		}
+		// Create the OpenGL rendering context
+		s_openGlRenderingContext = wglCreateContext( s_deviceContext );
+		if ( s_openGlRenderingContext == NULL )
+		{
+			std::stringstream errorMessage;
+			errorMessage << "Windows failed to create an OpenGL rendering context: " << eae6320::GetLastWindowsError();
+			eae6320::UserOutput::Print( errorMessage.str() );
+			return false;
+		}
+		// Set it as the rendering context of this thread
+		if ( wglMakeCurrent( s_deviceContext, s_openGlRenderingContext ) == FALSE )
+		{
+			std::stringstream errorMessage;
+			errorMessage << "Windows failed to set the current OpenGL rendering context: " << eae6320::GetLastWindowsError();
+			eae6320::UserOutput::Print( errorMessage.str() );
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool eae6320::Graphics::RenderingContext::Exists()
+{
+	return s_openGlRenderingContext != NULL;
+}
+
+bool eae6320::Graphics::RenderingContext::Destroy()
+{
+	bool wereThereErrors = false;
+
+	if ( s_openGlRenderingContext != NULL )
+	{
+		if ( wglMakeCurrent( s_deviceContext, NULL ) != FALSE )
+		{
+			if ( wglDeleteContext( s_openGlRenderingContext ) == FALSE )
+			{
+				wereThereErrors = true;
+				std::stringstream errorMessage;
+				errorMessage << "Windows failed to delete the OpenGL rendering context: " << GetLastWindowsError();
+				UserOutput::Print( errorMessage.str() );
+			}
+		}
+		else
+		{
+			wereThereErrors = true;
+			std::stringstream errorMessage;
+			errorMessage << "Windows failed to unset the current OpenGL rendering context: " << GetLastWindowsError();
+			UserOutput::Print( errorMessage.str() );
+		}
+		s_openGlRenderingContext = NULL;
+	}
+
+	if ( s_deviceContext != NULL )
+	{
+		// The documentation says that this call isn't necessary when CS_OWNDC is used
+		ReleaseDC( s_renderingWindow, s_deviceContext );
+		s_deviceContext = NULL;
+	}
+
+	s_renderingWindow = NULL;
+
+	return !wereThereErrors;
+}
+
+bool eae6320::Graphics::RenderingContext::MakeCurrent()
+{
+	if ( wglMakeCurrent( s_deviceContext, s_openGlRenderingContext ) == FALSE )
+	{
+		std::stringstream errorMessage;
+		errorMessage << "Windows failed to set the current OpenGL rendering context: " << eae6320::GetLastWindowsError();
+		eae6320::UserOutput::Print( errorMessage.str() );
+		return false;
+	}
+	return true;
+}
+
+void eae6320::Graphics::RenderingContext::ReleaseCurrent()
+{
+	wglMakeCurrent( s_deviceContext, NULL );
+}
+
+void eae6320::Graphics::RenderingContext::Present()
+{
+	BOOL result = SwapBuffers( s_deviceContext );
+	assert( result != FALSE );
+}
+
+float eae6320::Graphics::RenderingContext::GetAspectRatio()
+{
+	RECT renderingWindow;
+	GetWindowRect( s_renderingWindow, &renderingWindow );
+
+	int screenWidth = renderingWindow.right - renderingWindow.left;
+	int screenHeight = renderingWindow.bottom - renderingWindow.top;
+
+	return static_cast<float>( (float)screenWidth / (float)screenHeight );
+}
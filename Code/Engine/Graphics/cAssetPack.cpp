@@ -0,0 +1,161 @@
+// Header Files
+//=============
+
+#include "cAssetPack.h"
+
+#include <algorithm>
+#include <sstream>
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	void SetErrorMessage( const char* const i_path, const char* const i_reason, std::string* o_errorMessage );
+}
+
+// Interface
+//==========
+
+// Opening / Closing
+//------------------
+
+bool eae6320::Graphics::cAssetPack::Open( const char* const i_path, std::string* o_errorMessage )
+{
+	Close();
+
+	if ( !m_file.Open( i_path, false, o_errorMessage ) )
+	{
+		return false;
+	}
+	{
+		if ( m_file.GetSize() < sizeof( sHeader ) )
+		{
+			SetErrorMessage( i_path, "It is too small to be an asset pack", o_errorMessage );
+			goto OnError;
+		}
+		const sHeader& header = *reinterpret_cast<const sHeader*>( m_file.GetContents() );
+		if ( header.magic != s_magic )
+		{
+			SetErrorMessage( i_path, "It isn't an asset pack", o_errorMessage );
+			goto OnError;
+		}
+		if ( header.version != s_version )
+		{
+			SetErrorMessage( i_path, "It was written by a different version of AssetPacker", o_errorMessage );
+			goto OnError;
+		}
+		if ( header.fileSize != m_file.GetSize() )
+		{
+			SetErrorMessage( i_path, "It isn't the size that its header says it is", o_errorMessage );
+			goto OnError;
+		}
+		const uint64_t tableOfContentsSize = static_cast<uint64_t>( header.entryCount ) * sizeof( sEntry );
+		if ( tableOfContentsSize > ( m_file.GetSize() - sizeof( sHeader ) ) )
+		{
+			SetErrorMessage( i_path, "Its table of contents is cut short", o_errorMessage );
+			goto OnError;
+		}
+		m_entries = reinterpret_cast<const sEntry*>( m_file.GetContents() + sizeof( sHeader ) );
+		m_entryCount = header.entryCount;
+		// Every entry is checked now so that Find() doesn't have to
+		for ( uint32_t i = 0; i < m_entryCount; ++i )
+		{
+			const sEntry& entry = m_entries[i];
+			if ( ( entry.offset > m_file.GetSize() ) || ( entry.size > ( m_file.GetSize() - entry.offset ) ) )
+			{
+				SetErrorMessage( i_path, "One of its assets is past the end of the pack", o_errorMessage );
+				goto OnError;
+			}
+			if ( ( i > 0 ) && ( m_entries[i - 1].pathHash >= entry.pathHash ) )
+			{
+				SetErrorMessage( i_path, "Its table of contents isn't sorted", o_errorMessage );
+				goto OnError;
+			}
+		}
+	}
+	{
+		const std::string path( i_path );
+		const size_t lastSlash = path.find_last_of( "/\\" );
+		if ( lastSlash != std::string::npos )
+		{
+			m_directory = path.substr( 0, lastSlash + 1 );
+			std::transform( m_directory.begin(), m_directory.end(), m_directory.begin(), NormalizePathCharacter );
+		}
+	}
+
+	return true;
+
+OnError:
+
+	Close();
+	return false;
+}
+
+void eae6320::Graphics::cAssetPack::Close()
+{
+	m_file.Close();
+	m_entries = NULL;
+	m_entryCount = 0;
+	m_directory.clear();
+}
+
+eae6320::Graphics::cAssetPack::cAssetPack()
+	:
+	m_entries( NULL ), m_entryCount( 0 )
+{
+
+}
+
+eae6320::Graphics::cAssetPack::~cAssetPack()
+{
+	Close();
+}
+
+// Access
+//-------
+
+bool eae6320::Graphics::cAssetPack::Find( const char* const i_path, const uint8_t*& o_contents, size_t& o_size ) const
+{
+	if ( m_entryCount == 0 )
+	{
+		return false;
+	}
+	// The path must start with the pack's directory, and only what comes after that is hashed
+	const char* relativePath = i_path;
+	for ( const char directoryCharacter : m_directory )
+	{
+		if ( NormalizePathCharacter( *relativePath ) != directoryCharacter )
+		{
+			return false;
+		}
+		++relativePath;
+	}
+	const uint64_t pathHash = HashPath( relativePath );
+	const sEntry* const entriesEnd = m_entries + m_entryCount;
+	const sEntry* const entry = std::lower_bound( m_entries, entriesEnd, pathHash,
+		[]( const sEntry& i_entry, const uint64_t i_pathHash ) { return i_entry.pathHash < i_pathHash; } );
+	if ( ( entry == entriesEnd ) || ( entry->pathHash != pathHash ) )
+	{
+		return false;
+	}
+	o_contents = m_file.GetContents() + entry->offset;
+	o_size = static_cast<size_t>( entry->size );
+	return true;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	void SetErrorMessage( const char* const i_path, const char* const i_reason, std::string* o_errorMessage )
+	{
+		if ( o_errorMessage )
+		{
+			std::stringstream errorMessage;
+			errorMessage << "Failed to open the asset pack \"" << i_path << "\": " << i_reason;
+			*o_errorMessage = errorMessage.str();
+		}
+	}
+}
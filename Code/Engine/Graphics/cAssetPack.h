@@ -0,0 +1,127 @@
+/*
+	This class finds assets in a pack file that AssetPacker wrote from the built assets
+
+	The whole pack is mapped once, and then an asset's contents are found by hashing its path
+	and searching the table of contents, instead of opening a file for every asset.
+	A pack looks like this:
+		[sHeader][sEntry * entryCount][payloads]
+	The entries are sorted by their path hashes so that they can be binary searched,
+	every payload starts on a multiple of s_payloadAlignment,
+	and assets whose contents are identical share a single payload.
+
+	Paths are hashed relative to the directory that the pack is in
+	(so a pack at "data/Assets.pack" finds "data/Mesh/Earth.lmesh" as "Mesh/Earth.lmesh"),
+	and they are hashed as if they were lowercase and used forward slashes because Windows paths are neither case nor slash sensitive.
+	Only the hashes are stored, and so AssetPacker refuses to write a pack that has two paths with the same hash
+*/
+
+#ifndef EAE6320_GRAPHICS_CASSETPACK_H
+#define EAE6320_GRAPHICS_CASSETPACK_H
+
+// Header Files
+//=============
+
+#include "cMappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Class Declaration
+//==================
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		class cAssetPack
+		{
+			// Interface
+			//==========
+
+		public:
+
+			// File Format
+			//------------
+
+			struct sHeader
+			{
+				uint32_t magic;
+				uint32_t version;
+				uint32_t entryCount;
+				uint32_t payloadAlignment;
+				// This lets a pack that was cut short be told apart from a complete one
+				uint64_t fileSize;
+			};
+			struct sEntry
+			{
+				uint64_t pathHash;
+				// From the start of the pack
+				uint64_t offset;
+				uint64_t size;
+			};
+			// "EAPK"
+			static const uint32_t s_magic = 0x4b504145;
+			static const uint32_t s_version = 1;
+			// Enough for any of the values that the loaders read straight out of the contents
+			static const uint32_t s_payloadAlignment = 16;
+
+			// A 64-bit FNV-1a hash of the path (ignoring case and which way the slashes go)
+			static uint64_t HashPath( const char* const i_path )
+			{
+				uint64_t hash = 14695981039346656037ull;
+				for ( const char* character = i_path; *character != '\0'; ++character )
+				{
+					hash = ( hash ^ static_cast<uint8_t>( NormalizePathCharacter( *character ) ) ) * 1099511628211ull;
+				}
+				return hash;
+			}
+			static char NormalizePathCharacter( const char i_character )
+			{
+				return ( i_character == '\\' ) ? '/' : ( ( ( i_character >= 'A' ) && ( i_character <= 'Z' ) ) ? ( i_character - 'A' + 'a' ) : i_character );
+			}
+
+			// Opening / Closing
+			//------------------
+
+			// A pack that is already open is closed first
+			bool Open( const char* const i_path, std::string* o_errorMessage = NULL );
+			// Anything that was found in the pack can't be used after this
+			void Close();
+
+			cAssetPack();
+			~cAssetPack();
+
+			// Access
+			//-------
+
+			// The contents stay valid until the pack is closed.
+			// This returns false if the path isn't in the pack's directory or the pack doesn't have it
+			bool Find( const char* const i_path, const uint8_t*& o_contents, size_t& o_size ) const;
+			bool IsOpen() const { return m_file.IsOpen(); }
+			uint32_t GetEntryCount() const { return m_entryCount; }
+			size_t GetSize() const { return m_file.GetSize(); }
+
+			// Data
+			//=====
+
+		private:
+
+			cMappedFile m_file;
+			const sEntry* m_entries;
+			uint32_t m_entryCount;
+			// The pack's directory (normalized like the paths that are hashed, and with the slash at the end)
+			std::string m_directory;
+
+			// Implementation
+			//===============
+
+		private:
+
+			cAssetPack( const cAssetPack& ) = delete;
+			cAssetPack& operator =( const cAssetPack& ) = delete;
+		};
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_CASSETPACK_H
@@ -0,0 +1,291 @@
+// Header Files
+//=============
+
+#include "cAssetStreamer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	// How many finished loads can wait to be handed over before the streaming thread stops
+	const size_t s_maxReadyLoadCount = 4;
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	// Returns NULL if the file couldn't be opened or decompressed
+	const eae6320::Graphics::cMappedFile* OpenFile( const std::string& i_path, eae6320::Graphics::cAssetStreamer::sLoad& io_load,
+		eae6320::Graphics::cWorkerPool& io_decompressionPool );
+	// Returns the string that starts at io_offset and moves io_offset past it,
+	// or returns NULL if the file ends before the string does
+	const char* ReadString( const eae6320::Graphics::cMappedFile& i_file, size_t& io_offset );
+}
+
+// Interface
+//==========
+
+// Loads
+//------
+
+uint32_t eae6320::Graphics::cAssetStreamer::Add( const char* const i_meshPath, const char* const i_materialPath, Renderable* const i_renderable,
+	const bool i_shouldReadIntoMemory, const cAssetPack* const i_assetPack )
+{
+	sLoad* const load = new sLoad;
+	load->meshPath = i_meshPath;
+	load->materialPath = i_materialPath;
+	load->renderable = i_renderable;
+	load->shouldReadIntoMemory = i_shouldReadIntoMemory;
+	load->assetPack = i_assetPack;
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		load->handle = m_nextHandle++;
+		// Zero means "no load"
+		if ( m_nextHandle == 0 )
+		{
+			m_nextHandle = 1;
+		}
+		m_loadsToRead.push_back( load );
+		if ( !m_streamingThread.joinable() )
+		{
+			m_shouldStreamingThreadExit = false;
+			m_decompressionPool.Initialize( 0 );
+			m_streamingThread = std::thread( &cAssetStreamer::StreamingThreadMain, this );
+		}
+	}
+	m_loadAdded.notify_one();
+	return load->handle;
+}
+
+uint32_t eae6320::Graphics::cAssetStreamer::Cancel( const Renderable* const i_renderable )
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	std::deque<sLoad*>* const queues[] = { &m_loadsToRead, &m_readyLoads };
+	for ( std::deque<sLoad*>* const queue : queues )
+	{
+		for ( std::deque<sLoad*>::iterator i = queue->begin(); i != queue->end(); ++i )
+		{
+			if ( ( *i )->renderable == i_renderable )
+			{
+				const uint32_t handle = ( *i )->handle;
+				delete *i;
+				queue->erase( i );
+				// The streaming thread might be waiting for room in the queue
+				m_loadTaken.notify_one();
+				return handle;
+			}
+		}
+	}
+	// The streaming thread deletes the load instead of queueing it when it sees that it has no renderable
+	if ( m_loadBeingRead && ( m_loadBeingRead->renderable == i_renderable ) )
+	{
+		m_loadBeingRead->renderable = NULL;
+		const uint32_t handle = m_loadBeingRead->handle;
+		m_loadTaken.notify_one();
+		return handle;
+	}
+	return 0;
+}
+
+void eae6320::Graphics::cAssetStreamer::TakeReadyLoads( const size_t i_maxLoadCount, std::vector<sLoad*>& o_loads )
+{
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		const size_t loadCount = std::min( i_maxLoadCount, m_readyLoads.size() );
+		if ( loadCount == 0 )
+		{
+			return;
+		}
+		o_loads.insert( o_loads.end(), m_readyLoads.begin(), m_readyLoads.begin() + loadCount );
+		m_readyLoads.erase( m_readyLoads.begin(), m_readyLoads.begin() + loadCount );
+	}
+	m_loadTaken.notify_one();
+}
+
+void eae6320::Graphics::cAssetStreamer::GetLoadCounts( size_t& o_readingCount, size_t& o_readyCount )
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	o_readingCount = m_loadsToRead.size() + ( m_loadBeingRead ? 1 : 0 );
+	o_readyCount = m_readyLoads.size();
+}
+
+// Initialization / Shut Down
+//---------------------------
+
+void eae6320::Graphics::cAssetStreamer::CleanUp()
+{
+	if ( m_streamingThread.joinable() )
+	{
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_shouldStreamingThreadExit = true;
+		}
+		m_loadAdded.notify_one();
+		m_loadTaken.notify_one();
+		m_streamingThread.join();
+		m_decompressionPool.CleanUp();
+	}
+	for ( sLoad* const load : m_loadsToRead )
+	{
+		delete load;
+	}
+	m_loadsToRead.clear();
+	for ( sLoad* const load : m_readyLoads )
+	{
+		delete load;
+	}
+	m_readyLoads.clear();
+}
+
+eae6320::Graphics::cAssetStreamer::cAssetStreamer()
+	:
+	m_loadBeingRead( NULL ), m_nextHandle( 1 ), m_shouldStreamingThreadExit( false )
+{
+
+}
+
+eae6320::Graphics::cAssetStreamer::~cAssetStreamer()
+{
+	CleanUp();
+}
+
+// Implementation
+//===============
+
+void eae6320::Graphics::cAssetStreamer::StreamingThreadMain()
+{
+	while ( true )
+	{
+		sLoad* load;
+		{
+			std::unique_lock<std::mutex> lock( m_mutex );
+			m_loadAdded.wait( lock, [this]() { return m_shouldStreamingThreadExit || !m_loadsToRead.empty(); } );
+			if ( m_shouldStreamingThreadExit )
+			{
+				return;
+			}
+			load = m_loadsToRead.front();
+			m_loadsToRead.pop_front();
+			m_loadBeingRead = load;
+		}
+
+		// Cancel() only changes the load's renderable, and so the rest of it can be read without the lock
+		ReadFiles( *load, m_decompressionPool );
+
+		// The load can still be canceled while this thread waits for room in the queue
+		{
+			std::unique_lock<std::mutex> lock( m_mutex );
+			m_loadTaken.wait( lock, [this, load]()
+			{
+				return m_shouldStreamingThreadExit || ( load->renderable == NULL ) || ( m_readyLoads.size() < s_maxReadyLoadCount );
+			} );
+			m_loadBeingRead = NULL;
+			if ( m_shouldStreamingThreadExit || ( load->renderable == NULL ) )
+			{
+				delete load;
+				if ( m_shouldStreamingThreadExit )
+				{
+					return;
+				}
+				continue;
+			}
+			m_readyLoads.push_back( load );
+		}
+	}
+}
+
+void eae6320::Graphics::cAssetStreamer::ReadFiles( sLoad& io_load, cWorkerPool& io_decompressionPool )
+{
+	// A renderable needs at most six files,
+	// and the files must not move while the paths that are read from them are used
+	io_load.files.reserve( 6 );
+
+	OpenFile( io_load.meshPath, io_load, io_decompressionPool );
+
+	// [effect path][texture uniform name][texture path]...
+	const cMappedFile* const material = OpenFile( io_load.materialPath, io_load, io_decompressionPool );
+	if ( material == NULL )
+	{
+		return;
+	}
+	size_t offset = 0;
+	const char* const effectPath = ReadString( *material, offset );
+	const char* const textureUniformName = ReadString( *material, offset );
+	const char* const texturePath = textureUniformName ? ReadString( *material, offset ) : NULL;
+	if ( texturePath )
+	{
+		OpenFile( texturePath, io_load, io_decompressionPool );
+	}
+
+	// [render states][vertex shader path][fragment shader path]
+	const cMappedFile* const effect = effectPath ? OpenFile( effectPath, io_load, io_decompressionPool ) : NULL;
+	if ( effect == NULL )
+	{
+		return;
+	}
+	offset = 1;
+	const char* const vertexShaderPath = ReadString( *effect, offset );
+	const char* const fragmentShaderPath = vertexShaderPath ? ReadString( *effect, offset ) : NULL;
+	if ( vertexShaderPath )
+	{
+		OpenFile( vertexShaderPath, io_load, io_decompressionPool );
+	}
+	if ( fragmentShaderPath )
+	{
+		OpenFile( fragmentShaderPath, io_load, io_decompressionPool );
+	}
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	const eae6320::Graphics::cMappedFile* OpenFile( const std::string& i_path, eae6320::Graphics::cAssetStreamer::sLoad& io_load,
+		eae6320::Graphics::cWorkerPool& io_decompressionPool )
+	{
+		eae6320::Graphics::cAssetStreamer::sPreloadedFile preloadedFile;
+		const uint8_t* contents;
+		size_t size;
+		if ( io_load.assetPack && io_load.assetPack->Find( i_path.c_str(), contents, size ) )
+		{
+			preloadedFile.file.Borrow( contents, size );
+		}
+		else if ( !preloadedFile.file.Open( i_path.c_str(), io_load.shouldReadIntoMemory ) )
+		{
+			return NULL;
+		}
+		preloadedFile.file.Prefetch();
+		// A file that is corrupt is left for the loading code to report
+		if ( !preloadedFile.file.Decompress( i_path.c_str(), &io_decompressionPool ) )
+		{
+			return NULL;
+		}
+		preloadedFile.path = i_path;
+		io_load.files.push_back( std::move( preloadedFile ) );
+		return &io_load.files.back().file;
+	}
+
+	const char* ReadString( const eae6320::Graphics::cMappedFile& i_file, size_t& io_offset )
+	{
+		if ( io_offset >= i_file.GetSize() )
+		{
+			return NULL;
+		}
+		const char* const string = reinterpret_cast<const char*>( i_file.GetContents() + io_offset );
+		const void* const terminator = std::memchr( string, '\0', i_file.GetSize() - io_offset );
+		if ( terminator == NULL )
+		{
+			return NULL;
+		}
+		io_offset += ( reinterpret_cast<const char*>( terminator ) - string ) + 1;
+		return string;
+	}
+}
@@ -0,0 +1,129 @@
+/*
+	This class opens the files that a renderable needs on a thread of its own,
+	so that the thread that renders only has to create the graphics objects
+
+	Add() returns straight away and the streaming thread then maps the mesh and the material
+	(and reads the material and its effect to find out which effect, shaders and texture they use),
+	and touches every page so that the disk reads happen on the streaming thread.
+	The finished load waits until TakeReadyLoads() hands it over, and LoadMesh() and LoadMaterial() then find its files already open
+	(the files of assets that turn out to be loaded already are just closed, because the loaded ones are shared instead).
+	Files that are in the asset pack are found there instead of being opened, but their pages are still touched here.
+	Compressed files are decompressed here too, on a pool of threads that belongs to the streamer.
+	Only a few finished loads can wait at a time: the streaming thread stops once that many are waiting
+	so that files aren't mapped much faster than they are used.
+
+	A file that can't be opened is just left out,
+	and the loading code then tries to open it itself and reports why it failed
+*/
+
+#ifndef EAE6320_GRAPHICS_CASSETSTREAMER_H
+#define EAE6320_GRAPHICS_CASSETSTREAMER_H
+
+// Header Files
+//=============
+
+#include "cAssetPack.h"
+#include "cMappedFile.h"
+#include "cWorkerPool.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Class Declaration
+//==================
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		class Renderable;
+
+		class cAssetStreamer
+		{
+			// Interface
+			//==========
+
+		public:
+
+			struct sPreloadedFile
+			{
+				std::string path;
+				cMappedFile file;
+			};
+			struct sLoad
+			{
+				uint32_t handle;
+				std::string meshPath;
+				std::string materialPath;
+				Renderable* renderable;
+				bool shouldReadIntoMemory;
+				// This can be NULL, and a pack must stay open until every load that uses it has been handed over
+				const cAssetPack* assetPack;
+				std::vector<sPreloadedFile> files;
+			};
+
+			// Loads
+			//------
+
+			// This returns the load's handle (which is never zero).
+			// The streaming thread is started the first time that this is called
+			uint32_t Add( const char* const i_meshPath, const char* const i_materialPath, Renderable* const i_renderable,
+				const bool i_shouldReadIntoMemory, const cAssetPack* const i_assetPack );
+			// A load that hasn't been handed over yet never will be.
+			// This returns the canceled load's handle, or zero if the renderable wasn't being loaded
+			uint32_t Cancel( const Renderable* const i_renderable );
+			// The finished loads are handed over in the order that they were added (up to i_maxLoadCount of them),
+			// and the caller must delete them
+			void TakeReadyLoads( const size_t i_maxLoadCount, std::vector<sLoad*>& o_loads );
+			// Loads that are waiting to be read or are being read, and finished ones that are waiting to be handed over
+			void GetLoadCounts( size_t& o_readingCount, size_t& o_readyCount );
+
+			// Initialization / Shut Down
+			//---------------------------
+
+			// Stops the streaming thread and deletes every load that hasn't been handed over
+			void CleanUp();
+
+			cAssetStreamer();
+			~cAssetStreamer();
+
+			// Data
+			//=====
+
+		private:
+
+			std::thread m_streamingThread;
+			// The mutex guards both queues and the load that is being read
+			std::mutex m_mutex;
+			std::condition_variable m_loadAdded;
+			std::condition_variable m_loadTaken;
+			std::deque<sLoad*> m_loadsToRead;
+			// The load that the streaming thread is reading (the queues don't have it while it's being read)
+			sLoad* m_loadBeingRead;
+			std::deque<sLoad*> m_readyLoads;
+			uint32_t m_nextHandle;
+			bool m_shouldStreamingThreadExit;
+			// Only the streaming thread uses this (it is started along with it)
+			cWorkerPool m_decompressionPool;
+
+			// Implementation
+			//===============
+
+		private:
+
+			void StreamingThreadMain();
+			static void ReadFiles( sLoad& io_load, cWorkerPool& io_decompressionPool );
+
+			cAssetStreamer( const cAssetStreamer& ) = delete;
+			cAssetStreamer& operator =( const cAssetStreamer& ) = delete;
+		};
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_CASSETSTREAMER_H
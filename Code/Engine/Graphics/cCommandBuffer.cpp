@@ -0,0 +1,130 @@
+// Header Files
+//=============
+
+#include "cCommandBuffer.h"
+
+#include <cassert>
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	eae6320::Graphics::cCommandBuffer::sCommand CreateCommand( const eae6320::Graphics::cCommandBuffer::eCommandType i_type,
+		const size_t i_first = 0, const size_t i_count = 0 );
+}
+
+// Interface
+//==========
+
+// Recording
+//----------
+
+void eae6320::Graphics::cCommandBuffer::Clear()
+{
+	m_commands.clear();
+	m_transforms.clear();
+	m_viewConstants.clear();
+}
+
+void eae6320::Graphics::cCommandBuffer::SetViewConstants( const sViewConstants& i_viewConstants )
+{
+	m_commands.push_back( CreateCommand( setViewConstants, m_viewConstants.size(), 1 ) );
+	m_viewConstants.push_back( i_viewConstants );
+}
+
+void eae6320::Graphics::cCommandBuffer::SetInstanceTransforms( const Math::cMatrix_transformation* const i_transforms, const size_t i_count )
+{
+	m_commands.push_back( CreateCommand( setInstanceTransforms, m_transforms.size(), i_count ) );
+	if ( i_count > 0 )
+	{
+		m_transforms.insert( m_transforms.end(), i_transforms, i_transforms + i_count );
+	}
+}
+
+void eae6320::Graphics::cCommandBuffer::BindEffect( Effect& i_effect )
+{
+	sCommand command = CreateCommand( bindEffect );
+	command.effect = &i_effect;
+	m_commands.push_back( command );
+}
+
+void eae6320::Graphics::cCommandBuffer::BindMaterialConstants( Material& i_material )
+{
+	sCommand command = CreateCommand( bindMaterialConstants );
+	command.material = &i_material;
+	m_commands.push_back( command );
+}
+
+void eae6320::Graphics::cCommandBuffer::SetTexture( Material& i_material )
+{
+	sCommand command = CreateCommand( setTexture );
+	command.material = &i_material;
+	m_commands.push_back( command );
+}
+
+void eae6320::Graphics::cCommandBuffer::SetDrawCallTransform( Effect& i_effect, const Math::cMatrix_transformation& i_localToWorld )
+{
+	sCommand command = CreateCommand( setDrawCallTransform, m_transforms.size(), 1 );
+	command.effect = &i_effect;
+	m_commands.push_back( command );
+	m_transforms.push_back( i_localToWorld );
+}
+
+void eae6320::Graphics::cCommandBuffer::DrawMesh( const Mesh& i_mesh )
+{
+	sCommand command = CreateCommand( drawMesh );
+	command.mesh = &i_mesh;
+	m_commands.push_back( command );
+}
+
+void eae6320::Graphics::cCommandBuffer::DrawMeshInstanced( const Mesh& i_mesh, const size_t i_firstInstance, const size_t i_instanceCount )
+{
+	sCommand command = CreateCommand( drawMeshInstanced, i_firstInstance, i_instanceCount );
+	command.mesh = &i_mesh;
+	m_commands.push_back( command );
+}
+
+// Access
+//-------
+
+size_t eae6320::Graphics::cCommandBuffer::GetSize() const
+{
+	return ( m_commands.size() * sizeof( sCommand ) ) + ( m_transforms.size() * sizeof( Math::cMatrix_transformation ) )
+		+ ( m_viewConstants.size() * sizeof( sViewConstants ) );
+}
+
+const char* eae6320::Graphics::cCommandBuffer::GetCommandName( const eCommandType i_type )
+{
+	switch ( i_type )
+	{
+	case setViewConstants: return "SetViewConstants";
+	case setInstanceTransforms: return "SetInstanceTransforms";
+	case bindEffect: return "BindEffect";
+	case bindMaterialConstants: return "BindMaterialConstants";
+	case setTexture: return "SetTexture";
+	case setDrawCallTransform: return "SetDrawCallTransform";
+	case drawMesh: return "DrawMesh";
+	case drawMeshInstanced: return "DrawMeshInstanced";
+	default: return "Unknown";
+	}
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	eae6320::Graphics::cCommandBuffer::sCommand CreateCommand( const eae6320::Graphics::cCommandBuffer::eCommandType i_type,
+		const size_t i_first, const size_t i_count )
+	{
+		// The indices are stored in 32 bits to keep the commands small
+		assert( ( i_first <= UINT32_MAX ) && ( i_count <= UINT32_MAX ) );
+		eae6320::Graphics::cCommandBuffer::sCommand command;
+		command.type = i_type;
+		command.first = static_cast<uint32_t>( i_first );
+		command.count = static_cast<uint32_t>( i_count );
+		command.mesh = NULL;
+		return command;
+	}
+}
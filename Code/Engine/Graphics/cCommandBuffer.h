@@ -0,0 +1,112 @@
+/*
+	This class records what a frame submits so that it can be executed later
+
+	Render() walks the scene and records every state change and draw call as a small fixed-size command
+	into one linear array, and ExecuteCommandBuffer() then replays the array through the platform's graphics functions.
+	Recording doesn't touch the graphics API at all,
+	so it could be done on any thread (even into several buffers at once),
+	and a buffer that has been executed can still be read afterwards to inspect exactly what the frame submitted.
+
+	Commands only point at the effects, materials and meshes that they use,
+	and so those must still exist when the buffer is executed.
+	Matrices don't fit in a command and are copied into a separate array that the commands index into
+*/
+
+#ifndef EAE6320_GRAPHICS_CCOMMANDBUFFER_H
+#define EAE6320_GRAPHICS_CCOMMANDBUFFER_H
+
+// Header Files
+//=============
+
+#include "Graphics.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Class Declaration
+//==================
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		class cCommandBuffer
+		{
+			// Interface
+			//==========
+
+		public:
+
+			enum eCommandType : uint8_t
+			{
+				setViewConstants,
+				setInstanceTransforms,
+				bindEffect,
+				bindMaterialConstants,
+				setTexture,
+				setDrawCallTransform,
+				drawMesh,
+				drawMeshInstanced,
+
+				commandTypeCount
+			};
+
+			struct sCommand
+			{
+				eCommandType type;
+				// What these mean depends on the type:
+				//	* setViewConstants: the index of the view constants
+				//	* setInstanceTransforms: the first transform and how many there are
+				//	* setDrawCallTransform: the index of the localToWorld transform
+				//	* drawMeshInstanced: the first instance and how many are drawn
+				uint32_t first;
+				uint32_t count;
+				union
+				{
+					Effect* effect;
+					Material* material;
+					const Mesh* mesh;
+				};
+			};
+
+			// Recording
+			//----------
+
+			// The capacity is kept so that a steady frame never reallocates
+			void Clear();
+
+			void SetViewConstants( const sViewConstants& i_viewConstants );
+			// The transforms are copied
+			void SetInstanceTransforms( const Math::cMatrix_transformation* const i_transforms, const size_t i_count );
+			void BindEffect( Effect& i_effect );
+			void BindMaterialConstants( Material& i_material );
+			void SetTexture( Material& i_material );
+			void SetDrawCallTransform( Effect& i_effect, const Math::cMatrix_transformation& i_localToWorld );
+			void DrawMesh( const Mesh& i_mesh );
+			void DrawMeshInstanced( const Mesh& i_mesh, const size_t i_firstInstance, const size_t i_instanceCount );
+
+			// Access
+			//-------
+
+			size_t GetCommandCount() const { return m_commands.size(); }
+			const sCommand& GetCommand( const size_t i_index ) const { return m_commands[i_index]; }
+			const Math::cMatrix_transformation& GetTransform( const size_t i_index ) const { return m_transforms[i_index]; }
+			const sViewConstants& GetViewConstants( const size_t i_index ) const { return m_viewConstants[i_index]; }
+			// This is the memory that the recorded frame takes up
+			size_t GetSize() const;
+			static const char* GetCommandName( const eCommandType i_type );
+
+			// Data
+			//=====
+
+		private:
+
+			std::vector<sCommand> m_commands;
+			std::vector<Math::cMatrix_transformation> m_transforms;
+			std::vector<sViewConstants> m_viewConstants;
+		};
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_CCOMMANDBUFFER_H
@@ -0,0 +1,390 @@
+// Header Files
+//=============
+
+#include "cMappedFile.h"
+
+#include "AssetCompression.h"
+#include "cWorkerPool.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <utility>
+#include <vector>
+#if defined( _WIN32 )
+	#include "../Windows/Functions.h"
+#else
+	#include <cerrno>
+	#include <cstring>
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	bool ReadIntoMemory( const char* const i_path, const uint8_t*& o_contents, size_t& o_size, std::string* o_errorMessage );
+	void SetErrorMessage( const char* const i_action, const char* const i_path, const std::string& i_reason, std::string* o_errorMessage );
+}
+
+// Interface
+//==========
+
+// Opening / Closing
+//------------------
+
+bool eae6320::Graphics::cMappedFile::Open( const char* const i_path, const bool i_shouldReadIntoMemory, std::string* o_errorMessage )
+{
+	Close();
+
+	if ( i_shouldReadIntoMemory )
+	{
+		m_wasReadIntoMemory = ReadIntoMemory( i_path, m_contents, m_size, o_errorMessage );
+		return m_wasReadIntoMemory;
+	}
+
+#if defined( _WIN32 )
+	{
+		const DWORD desiredAccess = GENERIC_READ;
+		const DWORD otherProgramsCanStillReadTheFile = FILE_SHARE_READ;
+		SECURITY_ATTRIBUTES* useDefaultSecurity = NULL;
+		const DWORD onlySucceedIfFileExists = OPEN_EXISTING;
+		// Assets are read from front to back
+		const DWORD attributes = FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN;
+		const HANDLE dontUseTemplateFile = NULL;
+		m_file = CreateFile( i_path, desiredAccess, otherProgramsCanStillReadTheFile,
+			useDefaultSecurity, onlySucceedIfFileExists, attributes, dontUseTemplateFile );
+		if ( m_file == INVALID_HANDLE_VALUE )
+		{
+			SetErrorMessage( "open", i_path, GetLastWindowsError(), o_errorMessage );
+			goto OnError;
+		}
+	}
+	{
+		LARGE_INTEGER fileSize;
+		if ( GetFileSizeEx( m_file, &fileSize ) == FALSE )
+		{
+			SetErrorMessage( "get the size of", i_path, GetLastWindowsError(), o_errorMessage );
+			goto OnError;
+		}
+		if ( fileSize.QuadPart == 0 )
+		{
+			SetErrorMessage( "map", i_path, "It is empty", o_errorMessage );
+			goto OnError;
+		}
+		m_size = static_cast<size_t>( fileSize.QuadPart );
+	}
+	{
+		SECURITY_ATTRIBUTES* useDefaultSecurity = NULL;
+		const DWORD mapTheWholeFile = 0;
+		const char* const dontNameTheMapping = NULL;
+		m_mapping = CreateFileMapping( m_file, useDefaultSecurity, PAGE_READONLY, mapTheWholeFile, mapTheWholeFile, dontNameTheMapping );
+		if ( m_mapping == NULL )
+		{
+			SetErrorMessage( "map", i_path, GetLastWindowsError(), o_errorMessage );
+			goto OnError;
+		}
+	}
+	{
+		const DWORD startAtTheBeginning = 0;
+		const SIZE_T viewTheWholeFile = 0;
+		m_contents = reinterpret_cast<const uint8_t*>( MapViewOfFile( m_mapping, FILE_MAP_READ, startAtTheBeginning, startAtTheBeginning, viewTheWholeFile ) );
+		if ( m_contents == NULL )
+		{
+			SetErrorMessage( "map a view of", i_path, GetLastWindowsError(), o_errorMessage );
+			goto OnError;
+		}
+	}
+
+	return true;
+#else
+	{
+		const int file = open( i_path, O_RDONLY );
+		if ( file == -1 )
+		{
+			SetErrorMessage( "open", i_path, std::strerror( errno ), o_errorMessage );
+			goto OnError;
+		}
+		struct stat fileStats;
+		if ( fstat( file, &fileStats ) != 0 )
+		{
+			SetErrorMessage( "get the size of", i_path, std::strerror( errno ), o_errorMessage );
+			close( file );
+			goto OnError;
+		}
+		if ( fileStats.st_size == 0 )
+		{
+			SetErrorMessage( "map", i_path, "It is empty", o_errorMessage );
+			close( file );
+			goto OnError;
+		}
+		m_size = static_cast<size_t>( fileStats.st_size );
+		void* const letTheSystemChooseTheAddress = NULL;
+		const off_t startAtTheBeginning = 0;
+		void* const contents = mmap( letTheSystemChooseTheAddress, m_size, PROT_READ, MAP_PRIVATE, file, startAtTheBeginning );
+		// The mapping keeps its own reference to the file
+		close( file );
+		if ( contents == MAP_FAILED )
+		{
+			SetErrorMessage( "map", i_path, std::strerror( errno ), o_errorMessage );
+			goto OnError;
+		}
+		m_contents = reinterpret_cast<const uint8_t*>( contents );
+	}
+
+	return true;
+#endif
+
+OnError:
+
+	Close();
+	return false;
+}
+
+void eae6320::Graphics::cMappedFile::Borrow( const uint8_t* const i_contents, const size_t i_size )
+{
+	Close();
+
+	m_contents = i_contents;
+	m_size = i_size;
+	m_isBorrowed = true;
+}
+
+void eae6320::Graphics::cMappedFile::Close()
+{
+	// Decompressed contents always belong to the file, even when the compressed ones were borrowed
+	if ( m_wasDecompressed )
+	{
+		free( const_cast<uint8_t*>( m_contents ) );
+	}
+	else if ( m_isBorrowed )
+	{
+		// Whatever lent the contents still owns them
+	}
+	else if ( m_wasReadIntoMemory )
+	{
+		free( const_cast<uint8_t*>( m_contents ) );
+	}
+#if defined( _WIN32 )
+	else
+	{
+		if ( m_contents != NULL )
+		{
+			UnmapViewOfFile( m_contents );
+		}
+		if ( m_mapping != NULL )
+		{
+			CloseHandle( m_mapping );
+		}
+		if ( m_file != INVALID_HANDLE_VALUE )
+		{
+			CloseHandle( m_file );
+		}
+	}
+	m_file = INVALID_HANDLE_VALUE;
+	m_mapping = NULL;
+#else
+	else if ( m_contents != NULL )
+	{
+		munmap( const_cast<uint8_t*>( m_contents ), m_size );
+	}
+#endif
+	m_contents = NULL;
+	m_size = 0;
+	m_wasReadIntoMemory = false;
+	m_isBorrowed = false;
+	m_wasDecompressed = false;
+	m_storedSize = 0;
+}
+
+void eae6320::Graphics::cMappedFile::Prefetch() const
+{
+	if ( m_wasReadIntoMemory || m_wasDecompressed )
+	{
+		return;
+	}
+	// Every page only has to be touched once
+	// (and the reads are volatile so that the compiler can't skip them)
+	const size_t pageSize = 4096;
+	const volatile uint8_t* const contents = m_contents;
+	for ( size_t i = 0; i < m_size; i += pageSize )
+	{
+		contents[i];
+	}
+}
+
+bool eae6320::Graphics::cMappedFile::Decompress( const char* const i_path, cWorkerPool* const i_workerPool, std::string* o_errorMessage )
+{
+	if ( m_wasDecompressed || !AssetCompression::IsCompressed( m_contents, m_size ) )
+	{
+		return true;
+	}
+
+	AssetCompression::sHeader header;
+	std::vector<size_t> chunkOffsets;
+	std::string reason;
+	if ( !AssetCompression::ReadChunkTable( m_contents, m_size, header, chunkOffsets, &reason ) )
+	{
+		SetErrorMessage( "decompress", i_path, reason, o_errorMessage );
+		return false;
+	}
+	uint8_t* const contents = reinterpret_cast<uint8_t*>( malloc( static_cast<size_t>( header.uncompressedSize ) ) );
+	if ( contents == NULL )
+	{
+		SetErrorMessage( "allocate memory to decompress", i_path, "malloc() failed", o_errorMessage );
+		return false;
+	}
+	// Every chunk records whether it was decompressed in its own element
+	std::vector<uint8_t> wereChunksDecompressed( header.chunkCount );
+	{
+		const std::function<void( const size_t )> decompressChunk = [&]( const size_t i_chunkIndex )
+		{
+			wereChunksDecompressed[i_chunkIndex] = AssetCompression::DecompressChunk( m_contents, header, chunkOffsets,
+				static_cast<uint32_t>( i_chunkIndex ), contents ) ? 1 : 0;
+		};
+		if ( i_workerPool && ( header.chunkCount > 1 ) )
+		{
+			i_workerPool->Run( header.chunkCount, decompressChunk );
+		}
+		else
+		{
+			for ( uint32_t i = 0; i < header.chunkCount; ++i )
+			{
+				decompressChunk( i );
+			}
+		}
+	}
+	for ( uint32_t i = 0; i < header.chunkCount; ++i )
+	{
+		if ( wereChunksDecompressed[i] == 0 )
+		{
+			std::stringstream chunkReason;
+			chunkReason << "Chunk #" << i << " is corrupt";
+			SetErrorMessage( "decompress", i_path, chunkReason.str(), o_errorMessage );
+			free( contents );
+			return false;
+		}
+	}
+
+	// The compressed contents aren't needed anymore
+	const size_t storedSize = m_size;
+	const bool wasReadIntoMemory = m_wasReadIntoMemory;
+	const bool isBorrowed = m_isBorrowed;
+	Close();
+	m_contents = contents;
+	m_size = static_cast<size_t>( header.uncompressedSize );
+	m_wasReadIntoMemory = wasReadIntoMemory;
+	m_isBorrowed = isBorrowed;
+	m_wasDecompressed = true;
+	m_storedSize = storedSize;
+	return true;
+}
+
+eae6320::Graphics::cMappedFile::cMappedFile()
+	:
+#if defined( _WIN32 )
+	m_file( INVALID_HANDLE_VALUE ), m_mapping( NULL ),
+#endif
+	m_contents( NULL ), m_size( 0 ), m_wasReadIntoMemory( false ), m_isBorrowed( false ), m_wasDecompressed( false ), m_storedSize( 0 )
+{
+
+}
+
+eae6320::Graphics::cMappedFile::cMappedFile( cMappedFile&& io_file )
+	:
+#if defined( _WIN32 )
+	m_file( INVALID_HANDLE_VALUE ), m_mapping( NULL ),
+#endif
+	m_contents( NULL ), m_size( 0 ), m_wasReadIntoMemory( false ), m_isBorrowed( false ), m_wasDecompressed( false ), m_storedSize( 0 )
+{
+	*this = std::move( io_file );
+}
+
+eae6320::Graphics::cMappedFile& eae6320::Graphics::cMappedFile::operator =( cMappedFile&& io_file )
+{
+	if ( &io_file != this )
+	{
+		Close();
+#if defined( _WIN32 )
+		m_file = io_file.m_file;
+		m_mapping = io_file.m_mapping;
+		io_file.m_file = INVALID_HANDLE_VALUE;
+		io_file.m_mapping = NULL;
+#endif
+		m_contents = io_file.m_contents;
+		m_size = io_file.m_size;
+		m_wasReadIntoMemory = io_file.m_wasReadIntoMemory;
+		m_isBorrowed = io_file.m_isBorrowed;
+		m_wasDecompressed = io_file.m_wasDecompressed;
+		m_storedSize = io_file.m_storedSize;
+		io_file.m_contents = NULL;
+		io_file.m_size = 0;
+		io_file.m_wasReadIntoMemory = false;
+		io_file.m_isBorrowed = false;
+		io_file.m_wasDecompressed = false;
+		io_file.m_storedSize = 0;
+	}
+	return *this;
+}
+
+eae6320::Graphics::cMappedFile::~cMappedFile()
+{
+	Close();
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	bool ReadIntoMemory( const char* const i_path, const uint8_t*& o_contents, size_t& o_size, std::string* o_errorMessage )
+	{
+		FILE* file = NULL;
+		if ( fopen_s( &file, i_path, "rb" ) != 0 )
+		{
+			SetErrorMessage( "open", i_path, "fopen_s() failed", o_errorMessage );
+			return false;
+		}
+		fseek( file, 0, SEEK_END );
+		const long fileSize = ftell( file );
+		rewind( file );
+		if ( fileSize <= 0 )
+		{
+			SetErrorMessage( "read", i_path, ( fileSize == 0 ) ? "It is empty" : "ftell() failed", o_errorMessage );
+			fclose( file );
+			return false;
+		}
+		uint8_t* const contents = reinterpret_cast<uint8_t*>( malloc( static_cast<size_t>( fileSize ) ) );
+		if ( contents == NULL )
+		{
+			SetErrorMessage( "allocate memory for", i_path, "malloc() failed", o_errorMessage );
+			fclose( file );
+			return false;
+		}
+		if ( fread( contents, sizeof( uint8_t ), static_cast<size_t>( fileSize ), file ) != static_cast<size_t>( fileSize ) )
+		{
+			SetErrorMessage( "read", i_path, "fread() failed", o_errorMessage );
+			free( contents );
+			fclose( file );
+			return false;
+		}
+		fclose( file );
+		o_contents = contents;
+		o_size = static_cast<size_t>( fileSize );
+		return true;
+	}
+
+	void SetErrorMessage( const char* const i_action, const char* const i_path, const std::string& i_reason, std::string* o_errorMessage )
+	{
+		if ( o_errorMessage )
+		{
+			std::stringstream errorMessage;
+			errorMessage << "Failed to " << i_action << " \"" << i_path << "\": " << i_reason;
+			*o_errorMessage = errorMessage.str();
+		}
+	}
+}
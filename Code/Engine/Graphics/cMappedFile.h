@@ -0,0 +1,110 @@
+/*
+	This class gives read-only access to a whole file's contents
+
+	The file is mapped into memory (with MapViewOfFile() on Windows and mmap() everywhere else),
+	and so its contents are only read from disk as they are touched
+	and can be handed straight to the graphics API without being copied into a buffer first.
+	The contents are only valid until the file is closed,
+	and so anything that has to outlive the load must still be copied out.
+
+	The file can also be read into memory instead of being mapped,
+	which is how assets used to be loaded and is only kept to compare the two.
+	And it can borrow contents that something else has mapped (like an asset in a cAssetPack),
+	in which case closing it doesn't unmap anything.
+
+	Once it is open, Decompress() replaces contents that a builder compressed (see AssetCompression.h) with the decompressed ones,
+	which are then in memory that the file owns until it is closed
+*/
+
+#ifndef EAE6320_GRAPHICS_CMAPPEDFILE_H
+#define EAE6320_GRAPHICS_CMAPPEDFILE_H
+
+// Header Files
+//=============
+
+#include "../Windows/Includes.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Class Declaration
+//==================
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		class cWorkerPool;
+
+		class cMappedFile
+		{
+			// Interface
+			//==========
+
+		public:
+
+			// Opening / Closing
+			//------------------
+
+			// A file that is already open is closed first.
+			// Empty files can't be mapped and so they fail to open
+			bool Open( const char* const i_path, const bool i_shouldReadIntoMemory = false, std::string* o_errorMessage = NULL );
+			// The contents must stay valid until this is closed
+			void Borrow( const uint8_t* const i_contents, const size_t i_size );
+			void Close();
+			// Reads every page of a mapped file so that the disk reads happen now instead of when the contents are first used
+			// (a file that was read into memory is already there)
+			void Prefetch() const;
+			// This does nothing if the contents aren't compressed.
+			// The chunks are decompressed on the pool's threads if there is one (and on the calling thread if there isn't).
+			// If this fails the file is left as it was and o_errorMessage says why
+			bool Decompress( const char* const i_path, cWorkerPool* const i_workerPool = NULL, std::string* o_errorMessage = NULL );
+
+			cMappedFile();
+			// An open file can be handed to another cMappedFile (which closes whatever it had open)
+			cMappedFile( cMappedFile&& io_file );
+			cMappedFile& operator =( cMappedFile&& io_file );
+			~cMappedFile();
+
+			// Access
+			//-------
+
+			bool IsOpen() const { return m_contents != NULL; }
+			const uint8_t* GetContents() const { return m_contents; }
+			size_t GetSize() const { return m_size; }
+			bool WasReadIntoMemory() const { return m_wasReadIntoMemory; }
+			// This stays true once borrowed contents have been decompressed (even though the file then owns its contents)
+			bool IsBorrowed() const { return m_isBorrowed; }
+			bool WasDecompressed() const { return m_wasDecompressed; }
+			// How many bytes the file takes up (which is the compressed size if the contents were decompressed)
+			size_t GetStoredSize() const { return m_wasDecompressed ? m_storedSize : m_size; }
+
+			// Data
+			//=====
+
+		private:
+
+#if defined( _WIN32 )
+			HANDLE m_file;
+			HANDLE m_mapping;
+#endif
+			const uint8_t* m_contents;
+			size_t m_size;
+			bool m_wasReadIntoMemory;
+			bool m_isBorrowed;
+			bool m_wasDecompressed;
+			size_t m_storedSize;
+
+			// Implementation
+			//===============
+
+		private:
+
+			cMappedFile( const cMappedFile& ) = delete;
+			cMappedFile& operator =( const cMappedFile& ) = delete;
+		};
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_CMAPPEDFILE_H
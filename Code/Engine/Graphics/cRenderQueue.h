@@ -0,0 +1,93 @@
+/*
+	This class orders a frame's draw calls
+
+	Every draw is submitted with a 64-bit key and the index of whatever it draws,
+	and after sorting the draws come back out in key order.
+	The keys are built so that sorting them does three things at once:
+		* Opaque draws come before transparent ones
+		* Opaque draws are grouped by effect, then material, then mesh (to minimize state changes)
+			and are front-to-back within a group (so that the depth test can reject hidden fragments early)
+		* Transparent draws are strictly back-to-front (which blending requires),
+			and are only grouped by state when they are at the same depth
+
+	The sort is a least-significant-digit radix sort on 11-bit digits,
+	so its cost is linear in the number of draws
+	(and digits that are identical in every key, e.g. unused high ID bits, are skipped entirely)
+*/
+
+#ifndef EAE6320_GRAPHICS_CRENDERQUEUE_H
+#define EAE6320_GRAPHICS_CRENDERQUEUE_H
+
+// Header Files
+//=============
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Class Declaration
+//==================
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		class cRenderQueue
+		{
+			// Interface
+			//==========
+
+		public:
+
+			enum eLayer : uint8_t
+			{
+				opaque,
+				transparent,
+			};
+
+			// Sort Keys
+			//----------
+
+			// Opaque:      [layer:2][effect:12][material:14][mesh:12][depth:24]
+			// Transparent: [layer:2][inverted depth:24][effect:12][material:14][mesh:12]
+			// The IDs are masked to fit, so IDs past the field size only make the grouping worse (never the result)
+			static uint64_t CreateKey( const eLayer i_layer, const uint16_t i_effectId, const uint16_t i_materialId, const uint16_t i_meshId,
+				const uint32_t i_depth );
+			// Converts a view-space distance into the 24-bit depth that the keys use
+			// (anything outside of [i_nearPlane, i_farPlane] is clamped)
+			static uint32_t QuantizeDepth( const float i_distance, const float i_nearPlane, const float i_farPlane );
+
+			// Submission
+			//-----------
+
+			void Clear();
+			void Submit( const uint64_t i_key, const uint32_t i_drawIndex );
+			// Equivalent to calling Submit() for each draw in order
+			// (draws can be keyed in parallel into separate lists and then appended one list at a time)
+			void Submit( const uint64_t* const i_keys, const uint32_t* const i_drawIndices, const size_t i_count );
+			// This is stable, so draws with identical keys stay in the order they were submitted
+			void Sort();
+
+			// Access
+			//-------
+
+			size_t GetCount() const { return m_keys.size(); }
+			uint64_t GetKey( const size_t i_index ) const { return m_keys[i_index]; }
+			uint32_t GetDrawIndex( const size_t i_index ) const { return m_drawIndices[i_index]; }
+
+			// Data
+			//=====
+
+		private:
+
+			std::vector<uint64_t> m_keys;
+			std::vector<uint32_t> m_drawIndices;
+			// The radix sort ping-pongs between these and the arrays above
+			// (they are kept around so that sorting doesn't allocate every frame)
+			std::vector<uint64_t> m_keys_scratch;
+			std::vector<uint32_t> m_drawIndices_scratch;
+		};
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_CRENDERQUEUE_H
@@ -0,0 +1,149 @@
+// Header Files
+//=============
+
+#include "cWorkerPool.h"
+
+#include <algorithm>
+
+// Interface
+//==========
+
+// Jobs
+//-----
+
+void eae6320::Graphics::cWorkerPool::Run( const size_t i_jobCount, const std::function<void( const size_t i_jobIndex )>& i_job )
+{
+	if ( m_workerThreads.empty() || ( i_jobCount < 2 ) )
+	{
+		for ( size_t i = 0; i < i_jobCount; ++i )
+		{
+			i_job( i );
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_job = &i_job;
+		m_jobCount = i_jobCount;
+		m_nextJobIndex.store( 0 );
+		++m_batchId;
+	}
+	m_batchStarted.notify_all();
+
+	RunJobs( i_job, i_jobCount, m_nextJobIndex );
+
+	// Every job has been handed out, but the workers might still be running the last ones
+	{
+		std::unique_lock<std::mutex> lock( m_mutex );
+		m_workerFinished.wait( lock, [this]() { return m_busyWorkerCount == 0; } );
+		// A worker that wakes up after this won't join the finished batch
+		m_job = NULL;
+	}
+}
+
+// Initialization / Shut Down
+//---------------------------
+
+bool eae6320::Graphics::cWorkerPool::Initialize( const size_t i_threadCount )
+{
+	CleanUp();
+
+	size_t threadCount = i_threadCount;
+	if ( threadCount == 0 )
+	{
+		// This can be zero if the number of cores can't be determined
+		threadCount = std::max<size_t>( std::thread::hardware_concurrency(), 1 );
+	}
+	m_shouldWorkersExit = false;
+	for ( size_t i = 1; i < threadCount; ++i )
+	{
+		m_workerThreads.push_back( std::thread( &cWorkerPool::WorkerThreadMain, this ) );
+	}
+
+	return true;
+}
+
+void eae6320::Graphics::cWorkerPool::CleanUp()
+{
+	if ( m_workerThreads.empty() )
+	{
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_shouldWorkersExit = true;
+	}
+	m_batchStarted.notify_all();
+	for ( std::thread& workerThread : m_workerThreads )
+	{
+		workerThread.join();
+	}
+	m_workerThreads.clear();
+}
+
+eae6320::Graphics::cWorkerPool::cWorkerPool()
+	:
+	m_job( NULL ), m_jobCount( 0 ), m_nextJobIndex( 0 ), m_batchId( 0 ), m_busyWorkerCount( 0 ), m_shouldWorkersExit( false )
+{
+
+}
+
+eae6320::Graphics::cWorkerPool::~cWorkerPool()
+{
+	CleanUp();
+}
+
+// Implementation
+//===============
+
+void eae6320::Graphics::cWorkerPool::WorkerThreadMain()
+{
+	uint32_t lastBatchId;
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		lastBatchId = m_batchId;
+	}
+	while ( true )
+	{
+		const std::function<void( const size_t )>* job;
+		size_t jobCount;
+		{
+			std::unique_lock<std::mutex> lock( m_mutex );
+			m_batchStarted.wait( lock, [this, lastBatchId]() { return m_shouldWorkersExit || ( m_batchId != lastBatchId ); } );
+			if ( m_shouldWorkersExit )
+			{
+				return;
+			}
+			lastBatchId = m_batchId;
+			job = m_job;
+			jobCount = m_jobCount;
+			if ( job == NULL )
+			{
+				// This thread woke up after the batch had already been finished by the others
+				continue;
+			}
+			++m_busyWorkerCount;
+		}
+		RunJobs( *job, jobCount, m_nextJobIndex );
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			--m_busyWorkerCount;
+		}
+		m_workerFinished.notify_all();
+	}
+}
+
+void eae6320::Graphics::cWorkerPool::RunJobs( const std::function<void( const size_t )>& i_job, const size_t i_jobCount,
+	std::atomic<size_t>& io_nextJobIndex )
+{
+	while ( true )
+	{
+		const size_t jobIndex = io_nextJobIndex.fetch_add( 1 );
+		if ( jobIndex >= i_jobCount )
+		{
+			return;
+		}
+		i_job( jobIndex );
+	}
+}
@@ -0,0 +1,95 @@
+/*
+	This class runs a batch of independent jobs on several threads
+
+	Run() is given how many jobs there are and a function that does one of them,
+	and it returns once every job has finished.
+	The thread that calls Run() does jobs too, and so a pool with a single thread just runs them in order.
+	Jobs are handed out one at a time in index order to whichever thread asks next,
+	and so nothing that a job produces should depend on which thread ran it or on what ran before it
+	(each job should write to its own part of the output and the results should be merged by index afterwards)
+*/
+
+#ifndef EAE6320_GRAPHICS_CWORKERPOOL_H
+#define EAE6320_GRAPHICS_CWORKERPOOL_H
+
+// Header Files
+//=============
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Class Declaration
+//==================
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		class cWorkerPool
+		{
+			// Interface
+			//==========
+
+		public:
+
+			// Jobs
+			//-----
+
+			// Only one thread may call this at a time
+			void Run( const size_t i_jobCount, const std::function<void( const size_t i_jobIndex )>& i_job );
+			// This includes the thread that calls Run()
+			size_t GetThreadCount() const { return m_workerThreads.size() + 1; }
+
+			// Initialization / Shut Down
+			//---------------------------
+
+			// i_threadCount includes the thread that will call Run(), and zero means one thread per core.
+			// A pool that is already running is shut down first
+			bool Initialize( const size_t i_threadCount );
+			void CleanUp();
+
+			cWorkerPool();
+			~cWorkerPool();
+
+			// Data
+			//=====
+
+		private:
+
+			std::vector<std::thread> m_workerThreads;
+			// The mutex only guards starting and finishing a batch;
+			// the jobs themselves are handed out with the atomic index
+			std::mutex m_mutex;
+			std::condition_variable m_batchStarted;
+			std::condition_variable m_workerFinished;
+			const std::function<void( const size_t )>* m_job;
+			size_t m_jobCount;
+			std::atomic<size_t> m_nextJobIndex;
+			// This changes every time that Run() starts a batch
+			uint32_t m_batchId;
+			// How many worker threads are still inside the current batch
+			size_t m_busyWorkerCount;
+			bool m_shouldWorkersExit;
+
+			// Implementation
+			//===============
+
+		private:
+
+			void WorkerThreadMain();
+			// Runs jobs until there are none left
+			static void RunJobs( const std::function<void( const size_t )>& i_job, const size_t i_jobCount, std::atomic<size_t>& io_nextJobIndex );
+
+			cWorkerPool( const cWorkerPool& ) = delete;
+			cWorkerPool& operator =( const cWorkerPool& ) = delete;
+		};
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_CWORKERPOOL_H
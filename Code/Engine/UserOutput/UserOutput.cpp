@@ -3,6 +3,10 @@
 #include "../Windows/Includes.h"
 #include "UserOutput.h"
 
+#if !defined( _WIN32 )
+#include <iostream>
+#endif
+
 // Interface
 //==========
 
@@ -12,8 +16,13 @@ namespace eae6320
 	{
 		void Print(std::string i_str)
 		{
+#if defined( _WIN32 )
 			OutputDebugStringA(i_str.c_str());
 			MessageBox(NULL, i_str.c_str(), NULL, MB_OK);
+#else
+			//There is no window to show a message box in (see Windows/Includes.h)
+			std::cerr << i_str << std::endl;
+#endif
 		}
 	}
 }
\ No newline at end of file
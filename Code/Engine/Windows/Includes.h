@@ -11,8 +11,26 @@
 // Prevent Windows from creating min/max macros
 #define NOMINMAX
 
+#if defined( _WIN32 )
 	// Initialize Windows
 	#include <Windows.h>
+#else
+	// Other operating systems only run the engine headless
+	// (with the null graphics platform or with OpenGL through EGL),
+	// and neither of those touches the window that it is given
+	#include <cerrno>
+	#include <cstdio>
+
+	typedef void* HWND;
+
+	// The engine opens its files with the secure CRT function
+	typedef int errno_t;
+	inline errno_t fopen_s( FILE** o_file, const char* i_path, const char* i_mode )
+	{
+		*o_file = fopen( i_path, i_mode );
+		return ( *o_file != NULL ) ? 0 : errno;
+	}
+#endif
 
 #undef NOMINMAX
 #undef WIN32_LEAN_AND_MEAN
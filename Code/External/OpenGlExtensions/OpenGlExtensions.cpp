@@ -4,7 +4,11 @@
 #include "OpenGlExtensions.h"
 
 #include <sstream>
-#include "../../Engine/Windows/Functions.h"
+#if defined( _WIN32 )
+	#include "../../Engine/Windows/Functions.h"
+#else
+	#include <EGL/egl.h>
+#endif
 
 // Helper Function Declarations
 //=============================
@@ -20,11 +24,16 @@ namespace
 // OpenGL Extension Definitions
 //-----------------------------
 
+#if defined( _WIN32 )
 PFNGLACTIVETEXTUREPROC glActiveTexture = NULL;
+PFNGLCOMPRESSEDTEXIMAGE2DPROC glCompressedTexImage2D = NULL;
+#endif
 PFNGLATTACHSHADERPROC glAttachShader = NULL;
 PFNGLBINDBUFFERPROC glBindBuffer = NULL;
+PFNGLBINDBUFFERBASEPROC glBindBufferBase = NULL;
 PFNGLBINDVERTEXARRAYPROC glBindVertexArray = NULL;
 PFNGLBUFFERDATAPROC glBufferData = NULL;
+PFNGLBUFFERSUBDATAPROC glBufferSubData = NULL;
 PFNGLCOMPILESHADERPROC glCompileShader = NULL;
 PFNGLCREATEPROGRAMPROC glCreateProgram = NULL;
 PFNGLCREATESHADERPROC glCreateShader = NULL;
@@ -32,13 +41,18 @@ PFNGLDELETEBUFFERSPROC glDeleteBuffers = NULL;
 PFNGLDELETEPROGRAMPROC glDeleteProgram = NULL;
 PFNGLDELETESHADERPROC glDeleteShader = NULL;
 PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays = NULL;
+PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstanced = NULL;
 PFNGLENABLEVERTEXATTRIBARRAYARBPROC glEnableVertexAttribArray = NULL;
 PFNGLGENBUFFERSPROC glGenBuffers = NULL;
 PFNGLGENVERTEXARRAYSPROC glGenVertexArrays = NULL;
+PFNGLGETACTIVEUNIFORMSIVPROC glGetActiveUniformsiv = NULL;
+PFNGLGETATTRIBLOCATIONPROC glGetAttribLocation = NULL;
 PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLog = NULL;
 PFNGLGETPROGRAMIVPROC glGetProgramiv = NULL;
 PFNGLGETSHADERINFOLOGPROC glGetShaderInfoLog = NULL;
 PFNGLGETSHADERIVPROC glGetShaderiv = NULL;
+PFNGLGETUNIFORMBLOCKINDEXPROC glGetUniformBlockIndex = NULL;
+PFNGLGETUNIFORMINDICESPROC glGetUniformIndices = NULL;
 PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation = NULL;
 PFNGLLINKPROGRAMPROC glLinkProgram = NULL;
 PFNGLSHADERSOURCEPROC glShaderSource = NULL;
@@ -47,10 +61,13 @@ PFNGLUNIFORM1FVPROC glUniform1fv = NULL;
 PFNGLUNIFORM2FVPROC glUniform2fv = NULL;
 PFNGLUNIFORM3FVPROC glUniform3fv = NULL;
 PFNGLUNIFORM4FVPROC glUniform4fv = NULL;
+PFNGLUNIFORMBLOCKBINDINGPROC glUniformBlockBinding = NULL;
 PFNGLUNIFORMMATRIX4FVPROC glUniformMatrix4fv = NULL;
+PFNGLVERTEXATTRIB4FPROC glVertexAttrib4f = NULL;
+PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor = NULL;
 PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer = NULL;
-PFNGLCOMPRESSEDTEXIMAGE2DPROC glCompressedTexImage2D = NULL;
 PFNGLUNIFORM1IPROC glUniform1i = NULL;
+PFNGLDEBUGMESSAGECALLBACKPROC glDebugMessageCallback = NULL;
 
 // Initialization
 //---------------
@@ -59,8 +76,12 @@ bool eae6320::OpenGlExtensions::Load( std::string* o_errorMessage )
 {
 	// A current OpenGL context must exist before extensions can be loaded
 	{
-		const HGLRC currentContext = wglGetCurrentContext();
-		if ( currentContext == NULL )
+#if defined( _WIN32 )
+		const bool isContextCurrent = wglGetCurrentContext() != NULL;
+#else
+		const bool isContextCurrent = eglGetCurrentContext() != EGL_NO_CONTEXT;
+#endif
+		if ( !isContextCurrent )
 		{
 			if ( o_errorMessage )
 			{
@@ -75,25 +96,35 @@ bool eae6320::OpenGlExtensions::Load( std::string* o_errorMessage )
 		if ( !i_functionName )																							\
 			return false;
 
+#if defined( _WIN32 )
 	EAE6320_LOADGLFUNCTION( glActiveTexture, PFNGLACTIVETEXTUREPROC );
+	EAE6320_LOADGLFUNCTION( glCompressedTexImage2D, PFNGLCOMPRESSEDTEXIMAGE2DPROC );
+#endif
 	EAE6320_LOADGLFUNCTION( glAttachShader, PFNGLATTACHSHADERPROC );
 	EAE6320_LOADGLFUNCTION( glBindBuffer, PFNGLBINDBUFFERPROC );
+	EAE6320_LOADGLFUNCTION( glBindBufferBase, PFNGLBINDBUFFERBASEPROC );
 	EAE6320_LOADGLFUNCTION( glBindVertexArray, PFNGLBINDVERTEXARRAYPROC );
 	EAE6320_LOADGLFUNCTION( glBufferData, PFNGLBUFFERDATAPROC );
+	EAE6320_LOADGLFUNCTION( glBufferSubData, PFNGLBUFFERSUBDATAPROC );
 	EAE6320_LOADGLFUNCTION( glCompileShader, PFNGLCOMPILESHADERPROC );
 	EAE6320_LOADGLFUNCTION( glCreateProgram, PFNGLCREATEPROGRAMPROC );
 	EAE6320_LOADGLFUNCTION( glCreateShader, PFNGLCREATESHADERPROC );
 	EAE6320_LOADGLFUNCTION( glDeleteBuffers, PFNGLDELETEBUFFERSPROC );
 	EAE6320_LOADGLFUNCTION( glDeleteProgram, PFNGLDELETEPROGRAMPROC );
 	EAE6320_LOADGLFUNCTION( glDeleteVertexArrays, PFNGLDELETEVERTEXARRAYSPROC );
+	EAE6320_LOADGLFUNCTION( glDrawElementsInstanced, PFNGLDRAWELEMENTSINSTANCEDPROC );
 	EAE6320_LOADGLFUNCTION( glDeleteShader, PFNGLDELETESHADERPROC );
 	EAE6320_LOADGLFUNCTION( glEnableVertexAttribArray, PFNGLENABLEVERTEXATTRIBARRAYARBPROC );
 	EAE6320_LOADGLFUNCTION( glGenBuffers, PFNGLGENBUFFERSPROC );
 	EAE6320_LOADGLFUNCTION( glGenVertexArrays, PFNGLGENVERTEXARRAYSPROC );
+	EAE6320_LOADGLFUNCTION( glGetActiveUniformsiv, PFNGLGETACTIVEUNIFORMSIVPROC );
+	EAE6320_LOADGLFUNCTION( glGetAttribLocation, PFNGLGETATTRIBLOCATIONPROC );
 	EAE6320_LOADGLFUNCTION( glGetProgramInfoLog, PFNGLGETPROGRAMINFOLOGPROC );
 	EAE6320_LOADGLFUNCTION( glGetProgramiv, PFNGLGETPROGRAMIVPROC );
 	EAE6320_LOADGLFUNCTION( glGetShaderInfoLog, PFNGLGETSHADERINFOLOGPROC );
 	EAE6320_LOADGLFUNCTION( glGetShaderiv, PFNGLGETSHADERIVPROC );
+	EAE6320_LOADGLFUNCTION( glGetUniformBlockIndex, PFNGLGETUNIFORMBLOCKINDEXPROC );
+	EAE6320_LOADGLFUNCTION( glGetUniformIndices, PFNGLGETUNIFORMINDICESPROC );
 	EAE6320_LOADGLFUNCTION( glGetUniformLocation, PFNGLGETUNIFORMLOCATIONPROC );
 	EAE6320_LOADGLFUNCTION( glLinkProgram, PFNGLLINKPROGRAMPROC );
 	EAE6320_LOADGLFUNCTION( glShaderSource, PFNGLSHADERSOURCEPROC );
@@ -101,14 +132,19 @@ bool eae6320::OpenGlExtensions::Load( std::string* o_errorMessage )
 	EAE6320_LOADGLFUNCTION( glUniform2fv, PFNGLUNIFORM2FVPROC );
 	EAE6320_LOADGLFUNCTION( glUniform3fv, PFNGLUNIFORM3FVPROC );
 	EAE6320_LOADGLFUNCTION( glUniform4fv, PFNGLUNIFORM4FVPROC );
+	EAE6320_LOADGLFUNCTION( glUniformBlockBinding, PFNGLUNIFORMBLOCKBINDINGPROC );
 	EAE6320_LOADGLFUNCTION( glUniformMatrix4fv, PFNGLUNIFORMMATRIX4FVPROC );
 	EAE6320_LOADGLFUNCTION( glUseProgram, PFNGLUSEPROGRAMPROC );
+	EAE6320_LOADGLFUNCTION( glVertexAttrib4f, PFNGLVERTEXATTRIB4FPROC );
+	EAE6320_LOADGLFUNCTION( glVertexAttribDivisor, PFNGLVERTEXATTRIBDIVISORPROC );
 	EAE6320_LOADGLFUNCTION( glVertexAttribPointer, PFNGLVERTEXATTRIBPOINTERPROC );
-	EAE6320_LOADGLFUNCTION( glCompressedTexImage2D, PFNGLCOMPRESSEDTEXIMAGE2DPROC );
 	EAE6320_LOADGLFUNCTION( glUniform1i, PFNGLUNIFORM1IPROC );
 
 #undef EAE6320_LOADGLFUNCTION
 
+	// Optional functions don't fail loading if they can't be found
+	glDebugMessageCallback = reinterpret_cast<PFNGLDEBUGMESSAGECALLBACKPROC>( GetGlFunctionAddress( "glDebugMessageCallback" ) );
+
 	return true;
 }
 
@@ -117,6 +153,7 @@ bool eae6320::OpenGlExtensions::Load( std::string* o_errorMessage )
 
 namespace
 {
+#if defined( _WIN32 )
 	void* GetGlFunctionAddress( const char* i_functionName, std::string* o_errorMessage )
 	{
 		void* address = reinterpret_cast<void*>( wglGetProcAddress( i_functionName ) );
@@ -170,4 +207,20 @@ namespace
 
 		return NULL;
 	}
+#else
+	void* GetGlFunctionAddress( const char* i_functionName, std::string* o_errorMessage )
+	{
+		// Unlike wglGetProcAddress(), EGL 1.5 returns core functions as well as extensions
+		// (and an address that isn't NULL doesn't guarantee that the current context supports the function,
+		// which is why the context is created with an explicit version)
+		void* address = reinterpret_cast<void*>( eglGetProcAddress( i_functionName ) );
+		if ( ( address == NULL ) && o_errorMessage )
+		{
+			std::stringstream errorMessage;
+			errorMessage << "EGL failed to find the address of the OpenGL function \"" << i_functionName << "\"";
+			*o_errorMessage = errorMessage.str();
+		}
+		return address;
+	}
+#endif
 }
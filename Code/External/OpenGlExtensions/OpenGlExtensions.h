@@ -8,13 +8,21 @@
 // Header Files
 //=============
 
-// <windows.h> must be #included before <gl/GL.h>
-#include "../../Engine/Windows/Includes.h"
-#include <gl/GL.h>
+#if defined( _WIN32 )
+	// <windows.h> must be #included before <gl/GL.h>
+	#include "../../Engine/Windows/Includes.h"
+	#include <gl/GL.h>
+#else
+	// The system's glext.h would declare everything a second time
+	#define GL_GLEXT_LEGACY
+	#include <GL/gl.h>
+#endif
 
 // The two extension headers come from https://www.opengl.org/registry/
 #include "31597/glext.h"
-#include "31597/wglext.h"
+#if defined( _WIN32 )
+	#include "31597/wglext.h"
+#endif
 
 #include <string>
 
@@ -24,11 +32,18 @@
 // OpenGL Extension Declarations
 //------------------------------
 
+// Linux's libGL exports every OpenGL 1.3 function (and <GL/gl.h> declares them),
+// so only Windows has to load these ones
+#if defined( _WIN32 )
 extern PFNGLACTIVETEXTUREPROC glActiveTexture;
+extern PFNGLCOMPRESSEDTEXIMAGE2DPROC glCompressedTexImage2D;
+#endif
 extern PFNGLATTACHSHADERPROC glAttachShader;
 extern PFNGLBINDBUFFERPROC glBindBuffer;
+extern PFNGLBINDBUFFERBASEPROC glBindBufferBase;
 extern PFNGLBINDVERTEXARRAYPROC glBindVertexArray;
 extern PFNGLBUFFERDATAPROC glBufferData;
+extern PFNGLBUFFERSUBDATAPROC glBufferSubData;
 extern PFNGLCOMPILESHADERPROC glCompileShader;
 extern PFNGLCREATEPROGRAMPROC glCreateProgram;
 extern PFNGLCREATESHADERPROC glCreateShader;
@@ -36,13 +51,18 @@ extern PFNGLDELETEBUFFERSPROC glDeleteBuffers;
 extern PFNGLDELETEPROGRAMPROC glDeleteProgram;
 extern PFNGLDELETESHADERPROC glDeleteShader;
 extern PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays;
+extern PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstanced;
 extern PFNGLENABLEVERTEXATTRIBARRAYARBPROC glEnableVertexAttribArray;
 extern PFNGLGENBUFFERSPROC glGenBuffers;
 extern PFNGLGENVERTEXARRAYSPROC glGenVertexArrays;
+extern PFNGLGETACTIVEUNIFORMSIVPROC glGetActiveUniformsiv;
+extern PFNGLGETATTRIBLOCATIONPROC glGetAttribLocation;
 extern PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLog;
 extern PFNGLGETPROGRAMIVPROC glGetProgramiv;
 extern PFNGLGETSHADERINFOLOGPROC glGetShaderInfoLog;
 extern PFNGLGETSHADERIVPROC glGetShaderiv;
+extern PFNGLGETUNIFORMBLOCKINDEXPROC glGetUniformBlockIndex;
+extern PFNGLGETUNIFORMINDICESPROC glGetUniformIndices;
 extern PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation;
 extern PFNGLLINKPROGRAMPROC glLinkProgram;
 extern PFNGLSHADERSOURCEPROC glShaderSource;
@@ -50,11 +70,16 @@ extern PFNGLUNIFORM1FVPROC glUniform1fv;
 extern PFNGLUNIFORM2FVPROC glUniform2fv;
 extern PFNGLUNIFORM3FVPROC glUniform3fv;
 extern PFNGLUNIFORM4FVPROC glUniform4fv;
+extern PFNGLUNIFORMBLOCKBINDINGPROC glUniformBlockBinding;
 extern PFNGLUNIFORMMATRIX4FVPROC glUniformMatrix4fv;
 extern PFNGLUSEPROGRAMPROC glUseProgram;
+extern PFNGLVERTEXATTRIB4FPROC glVertexAttrib4f;
+extern PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor;
 extern PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer;
-extern PFNGLCOMPRESSEDTEXIMAGE2DPROC glCompressedTexImage2D;
 extern PFNGLUNIFORM1IPROC glUniform1i;
+// These are optional, and are NULL if the implementation doesn't have them
+// (an address isn't a guarantee on its own; check for the extension before using it)
+extern PFNGLDEBUGMESSAGECALLBACKPROC glDebugMessageCallback;
 
 // Initialization
 //---------------
@@ -63,6 +88,7 @@ namespace eae6320
 {
 	namespace OpenGlExtensions
 	{
+		// The functions are found with wglGetProcAddress() on Windows and eglGetProcAddress() everywhere else
 		bool Load( std::string* o_errorMessage = NULL );
 	}
 }
@@ -12,6 +12,7 @@
 #include "../../Engine/Graphics/Renderable.h"
 #include "../../Engine/Core/Time/Time.h"
 #include "../../Engine/Core/UserInput/UserInput.h"
+#include "../../Engine/UserOutput/UserOutput.h"
 #include "../../Engine/Graphics/Camera.h"
 // Resource.h contains the #defines for the icon resources
 // that the main window will use
@@ -51,6 +52,9 @@ namespace
 	std::vector<eae6320::Math::cVector> pointerPosition;
 	std::vector<eae6320::Math::cVector> cameraPosition;
 	std::vector<char *> textureList;
+	//The game simulates the next frame while the render thread is submitting the last one
+	//(turning this off does all of the rendering on the message loop's thread instead)
+	const bool s_shouldRenderOnItsOwnThread = true;
 }
 
 // Main Function
@@ -66,6 +70,9 @@ int CreateMainWindowAndReturnExitCodeWhenItCloses( const HINSTANCE i_thisInstanc
 		{
 			return -1;
 		}
+		//The build packs every asset into one file.
+		//If it can't be opened the assets are still loaded from their own files
+		eae6320::Graphics::OpenAssetPack("data/Assets.pack");
 		//Initializing the timer.
 		eae6320::Time::Initialize();
 
@@ -156,6 +163,12 @@ int CreateMainWindowAndReturnExitCodeWhenItCloses( const HINSTANCE i_thisInstanc
 			textureList.push_back("data/Material/PlutoPanel.mat");
 		}
 
+		//The scene is loaded before the render thread starts, so that the loads don't have to wait for it
+		if (s_shouldRenderOnItsOwnThread && !eae6320::Graphics::StartRenderThread())
+		{
+			eae6320::UserOutput::Print("The render thread couldn't be started, and so the game will render on its main thread");
+		}
+
 		const int exitCode = WaitForMainWindowToCloseAndReturnExitCode( i_thisInstanceOfTheProgram );
 		return exitCode;
 	}
@@ -737,7 +750,9 @@ bool WaitForMainWindowToClose( int& o_exitCode )
 					{
 						eae6320::Graphics::Renderable *Panel = new eae6320::Graphics::Renderable(eae6320::Math::cVector((cameraOffset.x + 2.0f), 0.0f, -15.0f));
 						listOfEntity.push_back(Panel);
-						eae6320::Graphics::AddRenderable("data/Mesh/Panel.lmesh", textureList[pointerPos], listOfEntity[11]);
+						//The panel's files are read in the background and it appears once it has been uploaded,
+						//so the frame that the camera stops in doesn't hitch (and nothing checks whether it was)
+						eae6320::Graphics::ReleaseLoadHandle(eae6320::Graphics::AddRenderableAsync("data/Mesh/Panel.lmesh", textureList[pointerPos], listOfEntity[11]));
 						panelLoaded = true;
 					}
 				}
@@ -752,11 +767,21 @@ bool WaitForMainWindowToClose( int& o_exitCode )
 
 			//Rotating the Planets
 			{
-				for (int i = 2; i < 11; i++)
+				//All of the orientations are built in one batch so that the sines and cosines can be vectorized.
+				const int firstPlanet = 2;
+				const int planetCount = 9;
+				float planetAngles[planetCount];
+				eae6320::Math::cQuaternion planetOrientations[planetCount];
+				for (int i = 0; i < planetCount; i++)
 				{
-					listOfEntity[i]->m_orientation = eae6320::Math::cQuaternion(eae6320::Math::ConvertDegreesToRadians(planetRotator), eae6320::Math::cVector(0.0f, 1.0f, 0.0f));
+					planetAngles[i] = eae6320::Math::ConvertDegreesToRadians(planetRotator);
 					planetRotator += 0.05f;
 				}
+				eae6320::Math::cQuaternion::CreateFromAnglesAndAxis(planetAngles, eae6320::Math::cVector(0.0f, 1.0f, 0.0f), planetCount, planetOrientations);
+				for (int i = 0; i < planetCount; i++)
+				{
+					listOfEntity[firstPlanet + i]->m_orientation = planetOrientations[i];
+				}
 			}
 			// Usually there will be no messages in the queue, and the game can run
 
@@ -787,6 +812,7 @@ bool WaitForMainWindowToClose( int& o_exitCode )
 		}
 	} while ( message.message != WM_QUIT );
 
+	eae6320::Graphics::StopRenderThread();
 	eae6320::Graphics::ShutDown();
 	for (auto it = listOfEntity.begin(); it != listOfEntity.end(); it++)
 	{
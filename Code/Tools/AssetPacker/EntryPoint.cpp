@@ -0,0 +1,16 @@
+/*
+	The main() function is where the program starts execution
+*/
+
+// Header Files
+//=============
+
+#include "cAssetPacker.h"
+
+// Entry Point
+//============
+
+int main( int i_argumentCount, char** i_arguments )
+{
+	return eae6320::Build<eae6320::cAssetPacker>( i_arguments, i_argumentCount );
+}
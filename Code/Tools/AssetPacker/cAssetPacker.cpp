@@ -0,0 +1,248 @@
+// Header Files
+//=============
+
+#include "cAssetPacker.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include "../../Engine/Graphics/cAssetPack.h"
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	struct sAsset
+	{
+		const std::string* relativePath;
+		uint64_t pathHash;
+		// Identical assets share the same payload
+		size_t payloadIndex;
+	};
+	struct sPayload
+	{
+		std::vector<uint8_t> contents;
+		uint64_t offset;
+	};
+
+	bool ReadAsset( const std::string& i_path, std::vector<uint8_t>& o_contents );
+	uint64_t HashContents( const std::vector<uint8_t>& i_contents );
+	uint64_t Align( const uint64_t i_offset );
+	bool WritePadding( FILE* const io_file, const uint64_t i_byteCount );
+}
+
+// Interface
+//==========
+
+// Build
+//------
+
+bool eae6320::cAssetPacker::Build( const std::vector<std::string>& i_relativePaths )
+{
+	// The build script leaves the slash off of the end of the directory
+	// (because Windows would read a backslash right before the closing quote as an escaped quote)
+	std::string assetDirectory( m_path_source );
+	if ( !assetDirectory.empty() && ( assetDirectory.back() != '/' ) && ( assetDirectory.back() != '\\' ) )
+	{
+		assetDirectory += '/';
+	}
+	sPackStatistics statistics;
+	if ( !WritePack( assetDirectory, i_relativePaths, m_path_target, statistics ) )
+	{
+		return false;
+	}
+	std::cout << "Packed " << statistics.assetCount << " assets (" << statistics.assetBytes << " bytes) into "
+		<< statistics.payloadCount << " payloads (" << statistics.packBytes << " bytes)\n";
+	return true;
+}
+
+bool eae6320::cAssetPacker::WritePack( const std::string& i_assetDirectory, const std::vector<std::string>& i_relativePaths,
+	const char* const i_path_target, sPackStatistics& o_statistics )
+{
+	bool wereThereErrors = false;
+	std::vector<sAsset> assets;
+	std::vector<sPayload> payloads;
+	Graphics::cAssetPack::sHeader header;
+	FILE* file = NULL;
+	o_statistics.assetCount = 0;
+	o_statistics.payloadCount = 0;
+	o_statistics.assetBytes = 0;
+	o_statistics.packBytes = 0;
+
+	// Read every asset and find the ones that are identical
+	{
+		// The payloads that have each content hash (which are then compared byte by byte)
+		std::multimap<uint64_t, size_t> payloadsByHash;
+		for ( const std::string& relativePath : i_relativePaths )
+		{
+			sAsset asset;
+			asset.relativePath = &relativePath;
+			asset.pathHash = Graphics::cAssetPack::HashPath( relativePath.c_str() );
+			std::vector<uint8_t> contents;
+			if ( !ReadAsset( i_assetDirectory + relativePath, contents ) )
+			{
+				wereThereErrors = true;
+				goto OnExit;
+			}
+			o_statistics.assetBytes += contents.size();
+			const uint64_t contentHash = HashContents( contents );
+			asset.payloadIndex = payloads.size();
+			const std::pair<std::multimap<uint64_t, size_t>::iterator, std::multimap<uint64_t, size_t>::iterator> sameHash =
+				payloadsByHash.equal_range( contentHash );
+			for ( std::multimap<uint64_t, size_t>::iterator i = sameHash.first; i != sameHash.second; ++i )
+			{
+				if ( payloads[i->second].contents == contents )
+				{
+					asset.payloadIndex = i->second;
+					break;
+				}
+			}
+			if ( asset.payloadIndex == payloads.size() )
+			{
+				payloadsByHash.insert( std::make_pair( contentHash, payloads.size() ) );
+				payloads.push_back( sPayload() );
+				payloads.back().contents.swap( contents );
+			}
+			assets.push_back( asset );
+		}
+	}
+	// The table of contents is sorted so that the game can binary search it,
+	// and only the hashes are stored and so no two paths can have the same one
+	std::sort( assets.begin(), assets.end(), []( const sAsset& i_lhs, const sAsset& i_rhs ) { return i_lhs.pathHash < i_rhs.pathHash; } );
+	for ( size_t i = 1; i < assets.size(); ++i )
+	{
+		if ( assets[i - 1].pathHash == assets[i].pathHash )
+		{
+			wereThereErrors = true;
+			std::stringstream errorMessage;
+			errorMessage << "\"" << *assets[i - 1].relativePath << "\" and \"" << *assets[i].relativePath << "\" have the same path hash"
+				" (either they are the same asset or one of them has to be renamed)";
+			OutputErrorMessage( errorMessage.str().c_str(), i_path_target );
+			goto OnExit;
+		}
+	}
+
+	// Lay out the pack
+	header.magic = Graphics::cAssetPack::s_magic;
+	header.version = Graphics::cAssetPack::s_version;
+	header.entryCount = static_cast<uint32_t>( assets.size() );
+	header.payloadAlignment = Graphics::cAssetPack::s_payloadAlignment;
+	header.fileSize = Align( sizeof( header ) + ( assets.size() * sizeof( Graphics::cAssetPack::sEntry ) ) );
+	for ( sPayload& payload : payloads )
+	{
+		payload.offset = header.fileSize;
+		header.fileSize = Align( header.fileSize + payload.contents.size() );
+	}
+
+	// Write it
+	{
+		if ( fopen_s( &file, i_path_target, "wb" ) != 0 )
+		{
+			wereThereErrors = true;
+			OutputErrorMessage( "The asset pack couldn't be opened for writing", i_path_target );
+			goto OnExit;
+		}
+		bool wasWritten = fwrite( &header, sizeof( header ), 1, file ) == 1;
+		for ( const sAsset& asset : assets )
+		{
+			const sPayload& payload = payloads[asset.payloadIndex];
+			Graphics::cAssetPack::sEntry entry;
+			entry.pathHash = asset.pathHash;
+			entry.offset = payload.offset;
+			entry.size = payload.contents.size();
+			wasWritten = wasWritten && ( fwrite( &entry, sizeof( entry ), 1, file ) == 1 );
+		}
+		uint64_t offset = sizeof( header ) + ( assets.size() * sizeof( Graphics::cAssetPack::sEntry ) );
+		for ( const sPayload& payload : payloads )
+		{
+			wasWritten = wasWritten && WritePadding( file, payload.offset - offset );
+			wasWritten = wasWritten && ( fwrite( &payload.contents[0], sizeof( uint8_t ), payload.contents.size(), file ) == payload.contents.size() );
+			offset = payload.offset + payload.contents.size();
+		}
+		wasWritten = wasWritten && WritePadding( file, header.fileSize - offset );
+		wasWritten = ( fclose( file ) == 0 ) && wasWritten;
+		file = NULL;
+		if ( !wasWritten )
+		{
+			wereThereErrors = true;
+			OutputErrorMessage( "The asset pack couldn't be written", i_path_target );
+			goto OnExit;
+		}
+	}
+	o_statistics.assetCount = static_cast<uint32_t>( assets.size() );
+	o_statistics.payloadCount = static_cast<uint32_t>( payloads.size() );
+	o_statistics.packBytes = header.fileSize;
+
+OnExit:
+
+	if ( file )
+	{
+		fclose( file );
+	}
+	if ( wereThereErrors )
+	{
+		// A pack that is only partly written mustn't be mistaken for a complete one
+		std::remove( i_path_target );
+	}
+	return !wereThereErrors;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	bool ReadAsset( const std::string& i_path, std::vector<uint8_t>& o_contents )
+	{
+		FILE* file = NULL;
+		if ( fopen_s( &file, i_path.c_str(), "rb" ) != 0 )
+		{
+			eae6320::OutputErrorMessage( "The asset couldn't be opened (has it been built?)", i_path.c_str() );
+			return false;
+		}
+		fseek( file, 0, SEEK_END );
+		const long fileSize = ftell( file );
+		rewind( file );
+		// The game can't load empty assets from their own files either
+		if ( fileSize <= 0 )
+		{
+			eae6320::OutputErrorMessage( "The asset is empty", i_path.c_str() );
+			fclose( file );
+			return false;
+		}
+		o_contents.resize( static_cast<size_t>( fileSize ) );
+		const bool wasRead = fread( &o_contents[0], sizeof( uint8_t ), o_contents.size(), file ) == o_contents.size();
+		fclose( file );
+		if ( !wasRead )
+		{
+			eae6320::OutputErrorMessage( "The asset couldn't be read", i_path.c_str() );
+		}
+		return wasRead;
+	}
+
+	uint64_t HashContents( const std::vector<uint8_t>& i_contents )
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for ( const uint8_t byte : i_contents )
+		{
+			hash = ( hash ^ byte ) * 1099511628211ull;
+		}
+		return hash;
+	}
+
+	uint64_t Align( const uint64_t i_offset )
+	{
+		const uint64_t alignment = eae6320::Graphics::cAssetPack::s_payloadAlignment;
+		return ( ( i_offset + alignment - 1 ) / alignment ) * alignment;
+	}
+
+	bool WritePadding( FILE* const io_file, const uint64_t i_byteCount )
+	{
+		const uint8_t zeros[eae6320::Graphics::cAssetPack::s_payloadAlignment] = {};
+		return ( i_byteCount == 0 ) || ( fwrite( zeros, sizeof( uint8_t ), static_cast<size_t>( i_byteCount ), io_file ) == i_byteCount );
+	}
+}
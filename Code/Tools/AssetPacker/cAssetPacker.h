@@ -0,0 +1,56 @@
+/*
+	This builder writes every built asset into a single pack file (see Engine/Graphics/cAssetPack.h)
+	so that the game only has to open and map one file instead of one for every asset
+
+	The source path is the directory that the assets were built into (with or without a slash at the end),
+	the target path is the pack,
+	and the optional arguments are the paths of the assets relative to the source directory.
+	Assets whose contents are identical are only written once.
+	It is run by BuildAssets.lua after every asset has been built
+*/
+
+#ifndef EAE6320_CASSETPACKER_H
+#define EAE6320_CASSETPACKER_H
+
+// Header Files
+//=============
+
+#include "../BuilderHelper/cbBuilder.h"
+
+#include <cstdint>
+
+// Class Declaration
+//==================
+
+namespace eae6320
+{
+	class cAssetPacker : public cbBuilder
+	{
+		// Interface
+		//==========
+
+	public:
+
+		struct sPackStatistics
+		{
+			uint32_t assetCount;
+			// Assets that are identical share a payload
+			uint32_t payloadCount;
+			// The size of every asset that was packed, and then the size of the pack
+			uint64_t assetBytes;
+			uint64_t packBytes;
+		};
+
+		// Build
+		//------
+
+		virtual bool Build( const std::vector<std::string>& i_relativePaths );
+
+		// The directory must end with a slash (or be empty for the current directory).
+		// This is also how RenderBenchmark packs the assets that it writes
+		static bool WritePack( const std::string& i_assetDirectory, const std::vector<std::string>& i_relativePaths,
+			const char* const i_path_target, sPackStatistics& o_statistics );
+	};
+}
+
+#endif	// EAE6320_CASSETPACKER_H
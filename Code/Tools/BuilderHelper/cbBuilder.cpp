@@ -3,7 +3,13 @@
 
 #include "cbBuilder.h"
 
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
 #include <sstream>
+#include "../../Engine/Graphics/AssetCompression.h"
+#include "../../Engine/Windows/Includes.h"
 
 // Interface
 //==========
@@ -22,11 +28,19 @@ bool eae6320::cbBuilder::ParseCommandArgumentsAndBuild( char** i_arguments, cons
 		m_path_target = i_arguments[commandCount + 1];
 
 		std::vector<std::string> optionalArguments;
+		bool shouldCompress = false;
 		for ( unsigned int i = ( commandCount + requiredArgumentCount ); i < i_argumentCount; ++i )
 		{
-			optionalArguments.push_back( i_arguments[i] );
+			if ( std::strcmp( i_arguments[i], "compressed" ) == 0 )
+			{
+				shouldCompress = true;
+			}
+			else
+			{
+				optionalArguments.push_back( i_arguments[i] );
+			}
 		}
-		return Build( optionalArguments );
+		return Build( optionalArguments ) && ( !shouldCompress || CompressTarget() );
 	}
 	else
 	{
@@ -59,3 +73,83 @@ eae6320::cbBuilder::cbBuilder()
 {
 
 }
+
+// Implementation
+//===============
+
+bool eae6320::cbBuilder::CompressTarget() const
+{
+	bool wereThereErrors = false;
+	std::vector<uint8_t> contents;
+	std::vector<uint8_t> compressedContents;
+	FILE* file = NULL;
+
+	// Read the target that was just built
+	{
+		if ( fopen_s( &file, m_path_target, "rb" ) != 0 )
+		{
+			wereThereErrors = true;
+			OutputErrorMessage( "The built asset couldn't be opened to be compressed", m_path_target );
+			goto OnExit;
+		}
+		fseek( file, 0, SEEK_END );
+		const long fileSize = ftell( file );
+		rewind( file );
+		// Empty assets can't be loaded anyway, and so there's nothing to compress
+		if ( fileSize <= 0 )
+		{
+			goto OnExit;
+		}
+		contents.resize( static_cast<size_t>( fileSize ) );
+		const bool wasRead = fread( &contents[0], sizeof( uint8_t ), contents.size(), file ) == contents.size();
+		fclose( file );
+		file = NULL;
+		if ( !wasRead )
+		{
+			wereThereErrors = true;
+			OutputErrorMessage( "The built asset couldn't be read to be compressed", m_path_target );
+			goto OnExit;
+		}
+	}
+
+	Graphics::AssetCompression::Compress( &contents[0], contents.size(), compressedContents );
+	if ( compressedContents.size() >= contents.size() )
+	{
+		std::cout << "\"" << m_path_target << "\" was left uncompressed (" << contents.size() << " bytes) because it didn't get any smaller\n";
+		goto OnExit;
+	}
+
+	// Replace it with the compressed one
+	{
+		if ( fopen_s( &file, m_path_target, "wb" ) != 0 )
+		{
+			wereThereErrors = true;
+			OutputErrorMessage( "The built asset couldn't be opened to write the compressed one", m_path_target );
+			goto OnExit;
+		}
+		bool wasWritten = fwrite( &compressedContents[0], sizeof( uint8_t ), compressedContents.size(), file ) == compressedContents.size();
+		wasWritten = ( fclose( file ) == 0 ) && wasWritten;
+		file = NULL;
+		if ( !wasWritten )
+		{
+			wereThereErrors = true;
+			OutputErrorMessage( "The compressed asset couldn't be written", m_path_target );
+			goto OnExit;
+		}
+	}
+	std::cout << "Compressed \"" << m_path_target << "\" from " << contents.size() << " to " << compressedContents.size() << " bytes\n";
+
+OnExit:
+
+	if ( file )
+	{
+		fclose( file );
+	}
+	if ( wereThereErrors )
+	{
+		// The build script only checks the target's time,
+		// and so a target that is only partly written must be removed or it would never be built again
+		std::remove( m_path_target );
+	}
+	return !wereThereErrors;
+}
@@ -63,6 +63,16 @@ namespace eae6320
 
 		const char* m_path_source;
 		const char* m_path_target;
+
+		// Implementation
+		//===============
+
+	private:
+
+		// Any builder's assets can be compressed (see Engine/Graphics/AssetCompression.h) by giving it the optional argument "compressed",
+		// which isn't passed on to Build() and instead makes this compress the target once it has been built
+		// (unless it wouldn't get any smaller, in which case it is left as it is because the game can load either)
+		bool CompressTarget() const;
 	};
 }
 
@@ -12,6 +12,7 @@
 
 #include <sstream>
 #include <cassert>
+#include <cstring>
 #include <stdio.h>
 #include <sys/stat.h>
 #include <string>
@@ -41,7 +42,12 @@ namespace
 		float values[4];
 		uint8_t valueCountToSet;
 		eShaderType shaderType;
+		uint16_t blockOffset;
 	};
+
+	//Lays the uniforms out the way a std140 uniform block would
+	//and returns the size of the block.
+	uint16_t CalculateConstantBlockLayout(sUniformHelper* io_uniforms, const uint8_t i_uniformCount);
 }
 
 // Build
@@ -128,6 +134,8 @@ bool eae6320::cMaterialBuilder::Build( const std::vector<std::string>& )
 		uint8_t uniformCount;
 		sUniformHelper *uniforms = NULL;
 		std::string *uniformNames = NULL;
+		uint16_t constantBlockSize = 0;
+		uint8_t *constantBlock = NULL;
 
 		//Load the Effect Path
 		{
@@ -203,6 +211,17 @@ bool eae6320::cMaterialBuilder::Build( const std::vector<std::string>& )
 			lua_pop(luaState, 1);
 		}
 
+		//Baking the constant block.
+		//The runtime uploads this as it is, so nothing has to be laid out when the material is loaded.
+		{
+			constantBlockSize = CalculateConstantBlockLayout(uniforms, uniformCount);
+			constantBlock = new uint8_t[constantBlockSize]();
+			for (uint8_t i = 0; i < uniformCount; i++)
+			{
+				memcpy(constantBlock + uniforms[i].blockOffset, uniforms[i].values, sizeof(float) * uniforms[i].valueCountToSet);
+			}
+		}
+
 		{
 			//Getting the textures
 			{
@@ -260,6 +279,10 @@ bool eae6320::cMaterialBuilder::Build( const std::vector<std::string>& )
 			{
 				fwrite(uniformNames[i].c_str(), sizeof(char), (uniformNames[i].length() + 1), o_file);
 			}
+
+			fwrite(&constantBlockSize, sizeof(uint16_t), 1, o_file);
+
+			fwrite(constantBlock, sizeof(uint8_t), constantBlockSize, o_file);
 			
 			err = fclose(o_file);
 			if (err != 0)
@@ -278,6 +301,9 @@ bool eae6320::cMaterialBuilder::Build( const std::vector<std::string>& )
 
 		delete[] uniformNames;
 		uniformNames = NULL;
+
+		delete[] constantBlock;
+		constantBlock = NULL;
 	}
 
 OnExit:
@@ -295,3 +321,25 @@ OnExit:
 
 	return !wereThereErrors;
 }
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	uint16_t CalculateConstantBlockLayout(sUniformHelper* io_uniforms, const uint8_t i_uniformCount)
+	{
+		//A float is aligned to 4 bytes, a vec2 to 8 and a vec3 or vec4 to 16
+		//(so a float that follows a vec3 fits into the vec3's last 4 bytes).
+		uint16_t size = 0;
+		for (uint8_t i = 0; i < i_uniformCount; i++)
+		{
+			const uint16_t valueSize = static_cast<uint16_t>(sizeof(float) * io_uniforms[i].valueCountToSet);
+			const uint16_t alignment = (io_uniforms[i].valueCountToSet == 1) ? 4 : ((io_uniforms[i].valueCountToSet == 2) ? 8 : 16);
+			io_uniforms[i].blockOffset = static_cast<uint16_t>((size + (alignment - 1)) & ~(alignment - 1));
+			size = io_uniforms[i].blockOffset + valueSize;
+		}
+		//The size of a block is rounded up to a whole vec4
+		return static_cast<uint16_t>((size + 15) & ~15);
+	}
+}
@@ -0,0 +1,503 @@
+/*
+	The main() function is where the program starts execution
+
+	This program measures the throughput of the Math library's kernels
+	for batch sizes from 1 to 1M elements, prints a table,
+	and writes the results as JSON so that they can be compared across commits.
+
+	Usage:
+		MathBenchmark [outputPath.json] [-quick]
+
+	It only depends on the Math library and the standard library,
+	and so on Linux it can be built from this directory with:
+		g++ -std=c++11 -O2 -DNDEBUG -DEAE6320_PLATFORM_GL EntryPoint.cpp ../../Engine/Core/Math/{cMatrix_transformation,cQuaternion,cVector,Functions}.cpp -o MathBenchmark
+	(add -mavx to measure the AVX path, or -DEAE6320_MATH_SIMD_DISABLED to measure the library with no SIMD at all)
+*/
+
+// Header Files
+//=============
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../../Engine/Core/Math/cMatrix_transformation.h"
+#include "../../Engine/Core/Math/cQuaternion.h"
+#include "../../Engine/Core/Math/cVector.h"
+#include "../../Engine/Core/Math/Functions.h"
+#include "../../Engine/Core/Math/Simd.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	struct sResult
+	{
+		std::string kernel;
+		// "scalar" is the one-element-at-a-time interface;
+		// "batch" is the array interface, which is vectorized when SIMD is available
+		std::string variant;
+		size_t batchSize;
+		double nanosecondsPerOperation;
+		double operationsPerSecond;
+	};
+	struct sAccuracy
+	{
+		std::string kernel;
+		// The largest absolute difference between the batch and scalar results
+		double maxDifference;
+		double tolerance;
+	};
+
+	std::vector<sResult> s_results;
+	std::vector<sAccuracy> s_accuracies;
+
+	const size_t s_batchSizes[] = { 1, 16, 256, 4096, 65536, 1048576 };
+	// Every measurement is repeated until at least this much time has passed
+	// and the fastest repetition is reported
+	double s_minimumSecondsPerMeasurement = 0.1;
+	const size_t s_minimumRepetitionCount = 5;
+	// Small batches are run many times per repetition so that the timer's resolution doesn't matter
+	const size_t s_minimumOperationsPerRepetition = 1 << 16;
+
+	// Results are accumulated here so that the compiler can't optimize the kernels away
+	volatile float s_sink = 0.0f;
+
+	std::mt19937 s_randomNumberGenerator( 6320 );
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	template<class tKernel>
+		void Measure( const char* const i_kernel, const char* const i_variant, const size_t i_batchSize,
+			const void* const i_output, tKernel i_function );
+	void RecordAccuracy( const char* const i_kernel, const float* const i_batch, const float* const i_scalar,
+		const size_t i_floatCount, const double i_tolerance );
+
+	float GetRandomFloat( const float i_min, const float i_max );
+	eae6320::Math::cVector GetRandomVector();
+	eae6320::Math::cQuaternion GetRandomRotation();
+
+	const char* GetSimdName();
+	bool WriteJson( const char* const i_path );
+}
+
+// Entry Point
+//============
+
+int main( int i_argumentCount, char** i_arguments )
+{
+	using namespace eae6320::Math;
+
+	const char* outputPath = "MathBenchmark.json";
+	for ( int i = 1; i < i_argumentCount; ++i )
+	{
+		if ( std::strcmp( i_arguments[i], "-quick" ) == 0 )
+		{
+			s_minimumSecondsPerMeasurement = 0.01;
+		}
+		else
+		{
+			outputPath = i_arguments[i];
+		}
+	}
+
+	std::cout << "Math library benchmark (SIMD: " << GetSimdName() << ")\n\n"
+		<< std::left << std::setw( 28 ) << "kernel" << std::setw( 8 ) << "variant" << std::right
+		<< std::setw( 10 ) << "batch" << std::setw( 12 ) << "ns/op" << std::setw( 14 ) << "Mops/sec" << "\n";
+
+	const cVector axis = cVector( 1.0f, 2.0f, 3.0f ).CreateNormalized();
+	const float aspectRatio = 16.0f / 9.0f;
+
+	for ( const size_t batchSize : s_batchSizes )
+	{
+		std::vector<cVector> vectors_a( batchSize ), vectors_b( batchSize ), vectors_result( batchSize );
+		std::vector<cQuaternion> quaternions_a( batchSize ), quaternions_b( batchSize ), quaternions_result( batchSize );
+		std::vector<cMatrix_transformation> matrices( batchSize ), matrices_result( batchSize );
+		std::vector<float> angles( batchSize ), floats_result_a( batchSize ), floats_result_b( batchSize );
+		for ( size_t i = 0; i < batchSize; ++i )
+		{
+			vectors_a[i] = GetRandomVector();
+			vectors_b[i] = GetRandomVector();
+			quaternions_a[i] = GetRandomRotation();
+			quaternions_b[i] = GetRandomRotation();
+			matrices[i] = cMatrix_transformation( quaternions_a[i], vectors_a[i] );
+			angles[i] = GetRandomFloat( -Pi, Pi );
+		}
+		const cMatrix_transformation viewToScreen = cMatrix_transformation::CreateViewToScreenTransform(
+			ConvertDegreesToRadians( 60.0f ), aspectRatio, 0.1f, 100.0f );
+
+		// Vector Arithmetic
+		//------------------
+
+		Measure( "vector_add", "scalar", batchSize, vectors_result.data(), [&]()
+		{
+			for ( size_t i = 0; i < batchSize; ++i )
+			{
+				vectors_result[i] = vectors_a[i] + vectors_b[i];
+			}
+		} );
+		Measure( "vector_multiply_add", "scalar", batchSize, vectors_result.data(), [&]()
+		{
+			for ( size_t i = 0; i < batchSize; ++i )
+			{
+				vectors_result[i] += vectors_a[i] * 0.5f;
+			}
+		} );
+		Measure( "vector_dot", "scalar", batchSize, floats_result_a.data(), [&]()
+		{
+			for ( size_t i = 0; i < batchSize; ++i )
+			{
+				floats_result_a[i] = Dot( vectors_a[i], vectors_b[i] );
+			}
+		} );
+		Measure( "vector_cross", "scalar", batchSize, vectors_result.data(), [&]()
+		{
+			for ( size_t i = 0; i < batchSize; ++i )
+			{
+				vectors_result[i] = Cross( vectors_a[i], vectors_b[i] );
+			}
+		} );
+
+		// Normalization
+		//--------------
+
+		{
+			std::vector<cVector> vectors_scalar( batchSize );
+			Measure( "vector_normalize", "scalar", batchSize, vectors_scalar.data(), [&]()
+			{
+				for ( size_t i = 0; i < batchSize; ++i )
+				{
+					vectors_scalar[i] = vectors_a[i].CreateNormalized();
+				}
+			} );
+			Measure( "vector_normalize", "batch", batchSize, vectors_result.data(), [&]()
+			{
+				std::copy( vectors_a.begin(), vectors_a.end(), vectors_result.begin() );
+				cVector::Normalize( vectors_result.data(), batchSize );
+			} );
+			RecordAccuracy( "vector_normalize", &vectors_result[0].x, &vectors_scalar[0].x, batchSize * 3, 1.0e-6 );
+		}
+
+		// Quaternions
+		//------------
+
+		Measure( "quaternion_concatenate", "scalar", batchSize, quaternions_result.data(), [&]()
+		{
+			for ( size_t i = 0; i < batchSize; ++i )
+			{
+				quaternions_result[i] = quaternions_a[i] * quaternions_b[i];
+			}
+		} );
+		Measure( "quaternion_invert", "scalar", batchSize, quaternions_result.data(), [&]()
+		{
+			for ( size_t i = 0; i < batchSize; ++i )
+			{
+				quaternions_result[i] = quaternions_a[i].CreateInverse();
+			}
+		} );
+		{
+			std::vector<cQuaternion> quaternions_scalar( batchSize );
+			Measure( "quaternion_from_angle_axis", "scalar", batchSize, quaternions_scalar.data(), [&]()
+			{
+				for ( size_t i = 0; i < batchSize; ++i )
+				{
+					quaternions_scalar[i] = cQuaternion( angles[i], axis );
+				}
+			} );
+			Measure( "quaternion_from_angle_axis", "batch", batchSize, quaternions_result.data(), [&]()
+			{
+				cQuaternion::CreateFromAnglesAndAxis( angles.data(), axis, batchSize, quaternions_result.data() );
+			} );
+			RecordAccuracy( "quaternion_from_angle_axis", reinterpret_cast<const float*>( quaternions_result.data() ),
+				reinterpret_cast<const float*>( quaternions_scalar.data() ), batchSize * 4, 1.0e-6 );
+
+			Measure( "quaternion_normalize", "scalar", batchSize, quaternions_scalar.data(), [&]()
+			{
+				for ( size_t i = 0; i < batchSize; ++i )
+				{
+					quaternions_scalar[i] = quaternions_a[i].CreateNormalized();
+				}
+			} );
+			Measure( "quaternion_normalize", "batch", batchSize, quaternions_result.data(), [&]()
+			{
+				std::copy( quaternions_a.begin(), quaternions_a.end(), quaternions_result.begin() );
+				cQuaternion::Normalize( quaternions_result.data(), batchSize );
+			} );
+			RecordAccuracy( "quaternion_normalize", reinterpret_cast<const float*>( quaternions_result.data() ),
+				reinterpret_cast<const float*>( quaternions_scalar.data() ), batchSize * 4, 1.0e-6 );
+		}
+
+		// Matrices
+		//---------
+
+		{
+			std::vector<cMatrix_transformation> matrices_scalar( batchSize );
+			Measure( "quaternion_to_matrix", "scalar", batchSize, matrices_scalar.data(), [&]()
+			{
+				for ( size_t i = 0; i < batchSize; ++i )
+				{
+					matrices_scalar[i] = cMatrix_transformation( quaternions_a[i], vectors_a[i] );
+				}
+			} );
+			Measure( "quaternion_to_matrix", "batch", batchSize, matrices_result.data(), [&]()
+			{
+				cMatrix_transformation::CreateFromRotationsAndTranslations( quaternions_a.data(), vectors_a.data(), batchSize, matrices_result.data() );
+			} );
+			RecordAccuracy( "quaternion_to_matrix", reinterpret_cast<const float*>( matrices_result.data() ),
+				reinterpret_cast<const float*>( matrices_scalar.data() ), batchSize * 16, 1.0e-6 );
+
+			Measure( "matrix_concatenate", "scalar", batchSize, matrices_scalar.data(), [&]()
+			{
+				for ( size_t i = 0; i < batchSize; ++i )
+				{
+					matrices_scalar[i] = matrices[i] * viewToScreen;
+				}
+			} );
+			Measure( "matrix_concatenate", "batch", batchSize, matrices_result.data(), [&]()
+			{
+				cMatrix_transformation::Concatenate( matrices.data(), viewToScreen, batchSize, matrices_result.data() );
+			} );
+			RecordAccuracy( "matrix_concatenate", reinterpret_cast<const float*>( matrices_result.data() ),
+				reinterpret_cast<const float*>( matrices_scalar.data() ), batchSize * 16, 1.0e-5 );
+		}
+		Measure( "create_world_to_view", "scalar", batchSize, matrices_result.data(), [&]()
+		{
+			for ( size_t i = 0; i < batchSize; ++i )
+			{
+				matrices_result[i] = cMatrix_transformation::CreateWorldToViewTransform( quaternions_a[i], vectors_a[i] );
+			}
+		} );
+		Measure( "create_view_to_screen", "scalar", batchSize, matrices_result.data(), [&]()
+		{
+			for ( size_t i = 0; i < batchSize; ++i )
+			{
+				matrices_result[i] = cMatrix_transformation::CreateViewToScreenTransform( 1.0f + ( angles[i] * 0.1f ), aspectRatio, 0.1f, 100.0f );
+			}
+		} );
+
+		// Transcendental Functions
+		//-------------------------
+
+		Measure( "sincos", "scalar", batchSize, floats_result_b.data(), [&]()
+		{
+			for ( size_t i = 0; i < batchSize; ++i )
+			{
+				floats_result_a[i] = std::sin( angles[i] );
+				floats_result_b[i] = std::cos( angles[i] );
+			}
+		} );
+		{
+			std::vector<float> sines( batchSize ), cosines( batchSize );
+			Measure( "sincos", "batch", batchSize, cosines.data(), [&]()
+			{
+				SinCos( angles.data(), batchSize, sines.data(), cosines.data() );
+			} );
+			RecordAccuracy( "sin", sines.data(), floats_result_a.data(), batchSize, 1.0e-7 );
+			RecordAccuracy( "cos", cosines.data(), floats_result_b.data(), batchSize, 1.0e-7 );
+		}
+		{
+			std::vector<float> lengthsSquared( batchSize );
+			for ( size_t i = 0; i < batchSize; ++i )
+			{
+				lengthsSquared[i] = Dot( vectors_a[i], vectors_a[i] );
+			}
+			Measure( "reciprocal_square_root", "scalar", batchSize, floats_result_a.data(), [&]()
+			{
+				for ( size_t i = 0; i < batchSize; ++i )
+				{
+					floats_result_a[i] = 1.0f / std::sqrt( lengthsSquared[i] );
+				}
+			} );
+			Measure( "reciprocal_square_root", "batch", batchSize, floats_result_b.data(), [&]()
+			{
+				ReciprocalSquareRoot( lengthsSquared.data(), batchSize, floats_result_b.data() );
+			} );
+			// The tolerance is relative, so the results are scaled back by the square root first
+			for ( size_t i = 0; i < batchSize; ++i )
+			{
+				const float length = std::sqrt( lengthsSquared[i] );
+				floats_result_a[i] *= length;
+				floats_result_b[i] *= length;
+			}
+			RecordAccuracy( "reciprocal_square_root", floats_result_b.data(), floats_result_a.data(), batchSize, 3.0e-7 );
+		}
+	}
+
+	bool wereThereErrors = false;
+	std::cout << "\n";
+	for ( const sAccuracy& accuracy : s_accuracies )
+	{
+		if ( accuracy.maxDifference > accuracy.tolerance )
+		{
+			std::cerr << "The batch " << accuracy.kernel << " differs from the scalar version by " << accuracy.maxDifference
+				<< ", which is more than the allowed " << accuracy.tolerance << "\n";
+			wereThereErrors = true;
+		}
+	}
+	if ( !WriteJson( outputPath ) )
+	{
+		wereThereErrors = true;
+	}
+	else
+	{
+		std::cout << "Results were written to " << outputPath << "\n";
+	}
+
+	return wereThereErrors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	template<class tKernel>
+		void Measure( const char* const i_kernel, const char* const i_variant, const size_t i_batchSize,
+			const void* const i_output, tKernel i_function )
+	{
+		typedef std::chrono::high_resolution_clock tClock;
+
+		const size_t callsPerRepetition = std::max<size_t>( 1, s_minimumOperationsPerRepetition / i_batchSize );
+		// Run once first so that the caches and branch predictors are warm
+		i_function();
+
+		double fastestRepetition_seconds = 0.0;
+		double totalTime_seconds = 0.0;
+		for ( size_t repetitionCount = 0;
+			( repetitionCount < s_minimumRepetitionCount ) || ( totalTime_seconds < s_minimumSecondsPerMeasurement );
+			++repetitionCount )
+		{
+			const tClock::time_point startTime = tClock::now();
+			for ( size_t i = 0; i < callsPerRepetition; ++i )
+			{
+				i_function();
+			}
+			const tClock::time_point endTime = tClock::now();
+			const double repetition_seconds = std::chrono::duration<double>( endTime - startTime ).count();
+			fastestRepetition_seconds = ( repetitionCount == 0 ) ? repetition_seconds : std::min( fastestRepetition_seconds, repetition_seconds );
+			totalTime_seconds += repetition_seconds;
+			s_sink = s_sink + *static_cast<const float*>( i_output );
+		}
+
+		sResult result;
+		result.kernel = i_kernel;
+		result.variant = i_variant;
+		result.batchSize = i_batchSize;
+		const double operationCount = static_cast<double>( callsPerRepetition * i_batchSize );
+		result.nanosecondsPerOperation = ( fastestRepetition_seconds * 1.0e9 ) / operationCount;
+		result.operationsPerSecond = ( fastestRepetition_seconds > 0.0 ) ? ( operationCount / fastestRepetition_seconds ) : 0.0;
+		s_results.push_back( result );
+
+		std::cout << std::left << std::setw( 28 ) << result.kernel << std::setw( 8 ) << result.variant << std::right
+			<< std::setw( 10 ) << result.batchSize
+			<< std::setw( 12 ) << std::fixed << std::setprecision( 3 ) << result.nanosecondsPerOperation
+			<< std::setw( 14 ) << std::setprecision( 2 ) << ( result.operationsPerSecond * 1.0e-6 ) << "\n";
+	}
+
+	void RecordAccuracy( const char* const i_kernel, const float* const i_batch, const float* const i_scalar,
+		const size_t i_floatCount, const double i_tolerance )
+	{
+		double maxDifference = 0.0;
+		for ( size_t i = 0; i < i_floatCount; ++i )
+		{
+			maxDifference = std::max( maxDifference, std::abs( static_cast<double>( i_batch[i] ) - static_cast<double>( i_scalar[i] ) ) );
+		}
+		// Each kernel is checked at every batch size, but only the worst difference is kept
+		for ( sAccuracy& accuracy : s_accuracies )
+		{
+			if ( accuracy.kernel == i_kernel )
+			{
+				accuracy.maxDifference = std::max( accuracy.maxDifference, maxDifference );
+				return;
+			}
+		}
+		sAccuracy accuracy;
+		accuracy.kernel = i_kernel;
+		accuracy.maxDifference = maxDifference;
+		accuracy.tolerance = i_tolerance;
+		s_accuracies.push_back( accuracy );
+	}
+
+	float GetRandomFloat( const float i_min, const float i_max )
+	{
+		return std::uniform_real_distribution<float>( i_min, i_max )( s_randomNumberGenerator );
+	}
+
+	eae6320::Math::cVector GetRandomVector()
+	{
+		eae6320::Math::cVector vector;
+		do
+		{
+			vector = eae6320::Math::cVector( GetRandomFloat( -10.0f, 10.0f ), GetRandomFloat( -10.0f, 10.0f ), GetRandomFloat( -10.0f, 10.0f ) );
+		} while ( vector.GetLength() < 0.01f );
+		return vector;
+	}
+
+	eae6320::Math::cQuaternion GetRandomRotation()
+	{
+		return eae6320::Math::cQuaternion( GetRandomFloat( -eae6320::Math::Pi, eae6320::Math::Pi ), GetRandomVector().CreateNormalized() );
+	}
+
+	const char* GetSimdName()
+	{
+#if defined( EAE6320_MATH_SIMD_AVX )
+		return "AVX";
+#elif defined( EAE6320_MATH_SIMD_SSE )
+		return "SSE";
+#else
+		return "none";
+#endif
+	}
+
+	bool WriteJson( const char* const i_path )
+	{
+		std::ofstream file( i_path );
+		if ( !file )
+		{
+			std::cerr << "The benchmark results couldn't be written to " << i_path << "\n";
+			return false;
+		}
+
+		file << "{\n"
+			<< "\t\"simd\": \"" << GetSimdName() << "\",\n"
+			<< "\t\"pointerSize\": " << sizeof( void* ) << ",\n"
+			<< "\t\"results\": [\n";
+		file << std::setprecision( 6 );
+		for ( size_t i = 0; i < s_results.size(); ++i )
+		{
+			const sResult& result = s_results[i];
+			file << "\t\t{ \"kernel\": \"" << result.kernel << "\", \"variant\": \"" << result.variant
+				<< "\", \"batchSize\": " << result.batchSize
+				<< ", \"nsPerOp\": " << result.nanosecondsPerOperation
+				<< ", \"opsPerSec\": " << result.operationsPerSecond << " }"
+				<< ( ( ( i + 1 ) < s_results.size() ) ? ",\n" : "\n" );
+		}
+		file << "\t],\n"
+			<< "\t\"accuracy\": [\n";
+		for ( size_t i = 0; i < s_accuracies.size(); ++i )
+		{
+			const sAccuracy& accuracy = s_accuracies[i];
+			file << "\t\t{ \"kernel\": \"" << accuracy.kernel
+				<< "\", \"maxDifference\": " << accuracy.maxDifference
+				<< ", \"tolerance\": " << accuracy.tolerance
+				<< ", \"passed\": " << ( ( accuracy.maxDifference <= accuracy.tolerance ) ? "true" : "false" ) << " }"
+				<< ( ( ( i + 1 ) < s_accuracies.size() ) ? ",\n" : "\n" );
+		}
+		file << "\t]\n"
+			<< "}\n";
+
+		return file.good();
+	}
+}
@@ -7,6 +7,9 @@
 
 #include <sstream>
 #include <cassert>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <stdio.h>
 #include <sys/stat.h>
 
@@ -38,17 +41,81 @@ namespace
 #endif
 	};
 
+	//The runtime reads this straight from the file, so it must match eae6320::Graphics::sMeshBounds
+	struct sMeshBounds
+	{
+		float sphereCenter[3];
+		float sphereRadius;
+		float aabbMin[3];
+		float aabbMax[3];
+	};
+
+	//These must match eae6320::Graphics::eVertexFormat and eae6320::Graphics::sVertex_quantized
+	enum eVertexFormat : uint32_t
+	{
+		floatVertices,
+		quantizedVertices,
+		quantizedVerticesNoColor,
+	};
+
+	struct sVertex_quantized
+	{
+		// POSITION
+		// 4 uint16_ts == 8 bytes
+		// Offset = 0
+		uint16_t x, y, z, w;
+		// TEXTURE COORDINATES
+		// 2 uint16_ts == 4 bytes
+		// Offset = 8
+		uint16_t u, v;
+		// COLOR0
+		// 4 uint8_ts == 4 bytes
+		// Offset = 12
+#if defined(EAE6320_PLATFORM_D3D)
+		uint8_t b, g, r, a;
+#elif defined(EAE6320_PLATFORM_GL)
+		uint8_t r, g, b, a;
+#endif
+	};
+
 	bool LoadVertices(lua_State& io_luaState, sVertex*& i_vertexData, uint32_t& o_noOfVertices);
+	void CalculateBounds(const sVertex* const i_vertexData, const uint32_t i_noOfVertices, sMeshBounds& o_bounds);
+	//Positions are stored as [0,1] across the AABB and texture coordinates must already be in [0,1].
+	bool QuantizeVertices(const sVertex* const i_vertexData, const uint32_t i_noOfVertices, const sMeshBounds& i_bounds,
+		eVertexFormat& o_vertexFormat, std::vector<uint8_t>& o_quantizedVertexData);
+	//Decodes every quantized vertex the same way the GPU will and compares it to the source
+	bool VerifyQuantizedVertices(const sVertex* const i_vertexData, const uint32_t i_noOfVertices, const sMeshBounds& i_bounds,
+		const eVertexFormat i_vertexFormat, const std::vector<uint8_t>& i_quantizedVertexData);
+	uint16_t QuantizeUnorm16(const float i_value);
 	bool LoadIndices(lua_State& io_luaState, uint32_t*& i_indexData, uint32_t& o_noOfIndices);
 }
 
 // Build
 //------
 
-bool eae6320::cMeshBuilder::Build( const std::vector<std::string>& )
+bool eae6320::cMeshBuilder::Build( const std::vector<std::string>& i_arguments )
 {
 	bool wereThereErrors = false;
 
+	//Meshes are built with full precision floats unless they are asked to be quantized
+	bool shouldQuantize = false;
+	for (size_t i = 0; i < i_arguments.size(); ++i)
+	{
+		if (i_arguments[i] == "quantized")
+		{
+			shouldQuantize = true;
+		}
+		else
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\"" << i_arguments[i] << "\" is not a valid mesh argument (the only one is \"quantized\")";
+			eae6320::OutputErrorMessage(errorMessage.str().c_str(), m_path_source);
+			return false;
+		}
+	}
+	eVertexFormat vertexFormat = floatVertices;
+	std::vector<uint8_t> quantizedVertexData;
+
 	//Read the Lua File.
 	// Create a new Lua state
 	lua_State* luaState = NULL;
@@ -145,6 +212,23 @@ bool eae6320::cMeshBuilder::Build( const std::vector<std::string>& )
 
 	lua_pop(luaState, 1);
 
+	sMeshBounds bounds;
+	CalculateBounds(o_vertexData, o_noOfVertices, bounds);
+
+	if (shouldQuantize)
+	{
+		if (!QuantizeVertices(o_vertexData, o_noOfVertices, bounds, vertexFormat, quantizedVertexData))
+		{
+			wereThereErrors = true;
+			goto OnExit;
+		}
+		if (!VerifyQuantizedVertices(o_vertexData, o_noOfVertices, bounds, vertexFormat, quantizedVertexData))
+		{
+			wereThereErrors = true;
+			goto OnExit;
+		}
+	}
+
 	if (!wereThereErrors)
 	{
 		FILE *o_file;
@@ -162,7 +246,12 @@ bool eae6320::cMeshBuilder::Build( const std::vector<std::string>& )
 
 		fwrite(&o_noOfVertices, sizeof(uint32_t), 1, o_file);
 		fwrite(&o_noOfIndices, sizeof(uint32_t), 1, o_file);
-		fwrite(o_vertexData, sizeof(sVertex), o_noOfVertices, o_file);
+		fwrite(&vertexFormat, sizeof(uint32_t), 1, o_file);
+		fwrite(&bounds, sizeof(sMeshBounds), 1, o_file);
+		if (vertexFormat == floatVertices)
+			fwrite(o_vertexData, sizeof(sVertex), o_noOfVertices, o_file);
+		else
+			fwrite(&quantizedVertexData[0], sizeof(uint8_t), quantizedVertexData.size(), o_file);
 		fwrite(o_indexData, sizeof(uint32_t), o_noOfIndices, o_file);
 		err = fclose(o_file);
 		if (err != 0)
@@ -203,6 +292,180 @@ OnExit:
 
 
 namespace {
+	uint16_t QuantizeUnorm16(const float i_value)
+	{
+		const float clamped = i_value < 0.0f ? 0.0f : (i_value > 1.0f ? 1.0f : i_value);
+		return static_cast<uint16_t>((clamped * 65535.0f) + 0.5f);
+	}
+
+	bool QuantizeVertices(const sVertex* const i_vertexData, const uint32_t i_noOfVertices, const sMeshBounds& i_bounds,
+		eVertexFormat& o_vertexFormat, std::vector<uint8_t>& o_quantizedVertexData)
+	{
+		//Texture coordinates are stored as unorm16 as well,
+		//so anything that relies on wrapping has to stay as floats.
+		//(A little slack is allowed for exporter round-off.)
+		const float uvSlack = 1.0e-4f;
+		for (uint32_t i = 0; i < i_noOfVertices; ++i)
+		{
+			const float u = i_vertexData[i].u, v = i_vertexData[i].v;
+			if (u < -uvSlack || u > (1.0f + uvSlack) || v < -uvSlack || v > (1.0f + uvSlack))
+			{
+				std::stringstream errorMessage;
+				errorMessage << "Vertex " << i << " has texture coordinates (" << u << ", " << v <<
+					") outside of [0,1], so this mesh can't be quantized";
+				eae6320::OutputErrorMessage(errorMessage.str().c_str());
+				return false;
+			}
+		}
+
+		//The color can be left out when every vertex is opaque white, which is what the shader gets by default.
+		//Direct3D 9 has no default for a missing input, though, so it always keeps the color.
+		bool shouldKeepColor = true;
+#if defined(EAE6320_PLATFORM_GL)
+		shouldKeepColor = false;
+		for (uint32_t i = 0; i < i_noOfVertices; ++i)
+		{
+			const sVertex& vertex = i_vertexData[i];
+			if (vertex.r != 255 || vertex.g != 255 || vertex.b != 255 || vertex.a != 255)
+			{
+				shouldKeepColor = true;
+				break;
+			}
+		}
+#endif
+		o_vertexFormat = shouldKeepColor ? quantizedVertices : quantizedVerticesNoColor;
+		//The color is the last member so it can simply be cut off
+		const size_t stride = shouldKeepColor ? sizeof(sVertex_quantized) : (sizeof(sVertex_quantized) - (4 * sizeof(uint8_t)));
+
+		float inverseExtents[3];
+		for (int k = 0; k < 3; ++k)
+		{
+			//A flat axis is stored as 0 and is scaled back by 0 at runtime
+			const float extent = i_bounds.aabbMax[k] - i_bounds.aabbMin[k];
+			inverseExtents[k] = extent > 0.0f ? (1.0f / extent) : 0.0f;
+		}
+
+		o_quantizedVertexData.resize(stride * i_noOfVertices);
+		for (uint32_t i = 0; i < i_noOfVertices; ++i)
+		{
+			const sVertex& vertex = i_vertexData[i];
+			sVertex_quantized quantizedVertex;
+			quantizedVertex.x = QuantizeUnorm16((vertex.x - i_bounds.aabbMin[0]) * inverseExtents[0]);
+			quantizedVertex.y = QuantizeUnorm16((vertex.y - i_bounds.aabbMin[1]) * inverseExtents[1]);
+			quantizedVertex.z = QuantizeUnorm16((vertex.z - i_bounds.aabbMin[2]) * inverseExtents[2]);
+			quantizedVertex.w = 65535;
+			quantizedVertex.u = QuantizeUnorm16(vertex.u);
+			quantizedVertex.v = QuantizeUnorm16(vertex.v);
+			quantizedVertex.r = vertex.r;
+			quantizedVertex.g = vertex.g;
+			quantizedVertex.b = vertex.b;
+			quantizedVertex.a = vertex.a;
+			memcpy(&o_quantizedVertexData[i * stride], &quantizedVertex, stride);
+		}
+
+		return true;
+	}
+
+	bool VerifyQuantizedVertices(const sVertex* const i_vertexData, const uint32_t i_noOfVertices, const sMeshBounds& i_bounds,
+		const eVertexFormat i_vertexFormat, const std::vector<uint8_t>& i_quantizedVertexData)
+	{
+		const size_t stride = (i_vertexFormat == quantizedVertices) ? sizeof(sVertex_quantized) : (sizeof(sVertex_quantized) - (4 * sizeof(uint8_t)));
+		if (i_quantizedVertexData.size() != (stride * i_noOfVertices))
+		{
+			eae6320::OutputErrorMessage("The quantized vertex data is the wrong size");
+			return false;
+		}
+
+		//Rounding to the nearest step is off by at most half a step;
+		//the rest of the tolerance covers float round-off in the decode.
+		float extents[3], positionTolerances[3];
+		for (int k = 0; k < 3; ++k)
+		{
+			extents[k] = i_bounds.aabbMax[k] - i_bounds.aabbMin[k];
+			const float largestMagnitude = std::max(std::abs(i_bounds.aabbMin[k]), std::abs(i_bounds.aabbMax[k]));
+			positionTolerances[k] = (0.5f * extents[k] / 65535.0f) + (largestMagnitude * 1.0e-6f);
+		}
+		const float uvTolerance = (0.5f / 65535.0f) + 1.0e-4f;
+
+		for (uint32_t i = 0; i < i_noOfVertices; ++i)
+		{
+			sVertex_quantized quantizedVertex;
+			memcpy(&quantizedVertex, &i_quantizedVertexData[i * stride], stride);
+			const sVertex& vertex = i_vertexData[i];
+			const float decodedPosition[3] =
+			{
+				i_bounds.aabbMin[0] + ((quantizedVertex.x / 65535.0f) * extents[0]),
+				i_bounds.aabbMin[1] + ((quantizedVertex.y / 65535.0f) * extents[1]),
+				i_bounds.aabbMin[2] + ((quantizedVertex.z / 65535.0f) * extents[2]),
+			};
+			for (int k = 0; k < 3; ++k)
+			{
+				const float error = std::abs(decodedPosition[k] - (&vertex.x)[k]);
+				if (error > positionTolerances[k])
+				{
+					std::stringstream errorMessage;
+					errorMessage << "Quantized vertex " << i << " decodes " << error << " away from the source position on axis " << k <<
+						" (the tolerance is " << positionTolerances[k] << ")";
+					eae6320::OutputErrorMessage(errorMessage.str().c_str());
+					return false;
+				}
+			}
+			const float uvError = std::max(std::abs((quantizedVertex.u / 65535.0f) - vertex.u), std::abs((quantizedVertex.v / 65535.0f) - vertex.v));
+			if (uvError > uvTolerance)
+			{
+				std::stringstream errorMessage;
+				errorMessage << "Quantized vertex " << i << " decodes " << uvError << " away from the source texture coordinates" <<
+					" (the tolerance is " << uvTolerance << ")";
+				eae6320::OutputErrorMessage(errorMessage.str().c_str());
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void CalculateBounds(const sVertex* const i_vertexData, const uint32_t i_noOfVertices, sMeshBounds& o_bounds)
+	{
+		o_bounds = sMeshBounds();
+		if (i_noOfVertices == 0)
+			return;
+
+		//The AABB is just the per-axis extremes.
+		for (int k = 0; k < 3; ++k)
+		{
+			o_bounds.aabbMin[k] = o_bounds.aabbMax[k] = (&i_vertexData[0].x)[k];
+		}
+		for (uint32_t i = 1; i < i_noOfVertices; ++i)
+		{
+			const float* const position = &i_vertexData[i].x;
+			for (int k = 0; k < 3; ++k)
+			{
+				o_bounds.aabbMin[k] = position[k] < o_bounds.aabbMin[k] ? position[k] : o_bounds.aabbMin[k];
+				o_bounds.aabbMax[k] = position[k] > o_bounds.aabbMax[k] ? position[k] : o_bounds.aabbMax[k];
+			}
+		}
+
+		//The sphere is centered on the AABB and reaches the farthest vertex from that center.
+		//This isn't the smallest possible sphere but it is never smaller than the mesh.
+		float radiusSquared = 0.0f;
+		for (int k = 0; k < 3; ++k)
+		{
+			o_bounds.sphereCenter[k] = (o_bounds.aabbMin[k] + o_bounds.aabbMax[k]) * 0.5f;
+		}
+		for (uint32_t i = 0; i < i_noOfVertices; ++i)
+		{
+			const float* const position = &i_vertexData[i].x;
+			float distanceSquared = 0.0f;
+			for (int k = 0; k < 3; ++k)
+			{
+				const float difference = position[k] - o_bounds.sphereCenter[k];
+				distanceSquared += difference * difference;
+			}
+			radiusSquared = distanceSquared > radiusSquared ? distanceSquared : radiusSquared;
+		}
+		o_bounds.sphereRadius = std::sqrt(radiusSquared);
+	}
+
 	bool LoadVertices(lua_State& io_luaState, sVertex*& i_vertexData, uint32_t& o_noOfVertices)
 	{
 		bool wereThereErrors = false;
@@ -0,0 +1,1584 @@
+/*
+	The main() function is where the program starts execution
+
+	This program measures how much CPU time Graphics::Render() takes
+	(transforms, culling, sorting, batching and the state filtering of every draw)
+	for scenes of 100 to 50,000 renderables, prints a table,
+	and writes the results as JSON so that they can be compared across commits.
+	It then runs a small game loop (a simulation followed by Render()) for every scene,
+	once with everything on one thread and once with the render thread,
+	and compares the frame times and how long it takes from Render() until the frame is presented.
+	The largest scene's renderables share a handful of assets, and how many of each were loaded is printed too.
+	Finally the largest scene is rendered with 1 to 8 threads building the draw list,
+	to see how that scales and to check that every thread count submits exactly the same frame,
+	and then with every way that the platform can check for graphics API errors, to see what each of them costs.
+	Before any of that it compares how long it takes to load a set of meshes and materials
+	and how many bytes are copied while doing so, when the asset files are read into memory and when they are mapped,
+	and then how long the frames take while the same set is added to the scene,
+	once by loading a renderable every frame and once by streaming them all in.
+	It also packs its own assets with AssetPacker and compares how long it takes to start up by loading them
+	from their own files and from the pack, both when the files are already in the OS's cache and when they aren't
+	(which can only be measured on platforms where the benchmark can drop files from the cache; Windows isn't one of them).
+	Then it compresses a sphere the size of a planet's mesh and a much bigger one the way that the builders do,
+	and compares their sizes on disk and how long they take to load when they are compressed and when they aren't,
+	and measures how fast they decompress on one thread and on every core.
+
+	Usage:
+		RenderBenchmark [outputPath.json] [-quick] [-simulate milliseconds] [-planets]
+
+	With -planets the loading and streaming are measured with the game's planets instead of the benchmark's own assets,
+	and so the benchmark must then be run from the game's directory (the one with the built data folder in it).
+
+	It is usually built with the null graphics platform, which does no GPU work and needs no window,
+	and it writes the small assets that it renders into the current directory.
+	On Linux it can be built from this directory with:
+		g++ -std=c++11 -O2 -DNDEBUG -pthread -DEAE6320_PLATFORM_NULL EntryPoint.cpp ../../Engine/Graphics/{AssetCompression,Graphics,Renderable,cAssetPack,cAssetStreamer,cCommandBuffer,cMappedFile,cRenderQueue,cWorkerPool}.cpp ../../Engine/Graphics/Null/Graphics.null.cpp ../../Engine/UserOutput/UserOutput.cpp ../../Engine/Core/Math/{cFrustum,cMatrix_transformation,cQuaternion,cVector,Functions}.cpp ../AssetPacker/cAssetPacker.cpp ../BuilderHelper/{cbBuilder,UtilityFunctions}.cpp -o RenderBenchmark
+
+	It can also be built with the OpenGL platform, which on Linux renders offscreen through EGL
+	(Mesa's llvmpipe is enough, so no GPU is needed).
+	The frame times then include the driver's work and the rasterization, because every frame is finished before the next one starts:
+		g++ -std=c++11 -O2 -DNDEBUG -pthread -DEAE6320_PLATFORM_GL EntryPoint.cpp ../../Engine/Graphics/{AssetCompression,Graphics,Renderable,cAssetPack,cAssetStreamer,cCommandBuffer,cMappedFile,cRenderQueue,cWorkerPool}.cpp ../../Engine/Graphics/OpenGL/{Graphics.gl,RenderingContext.egl}.cpp ../../External/OpenGlExtensions/OpenGlExtensions.cpp ../../Engine/UserOutput/UserOutput.cpp ../../Engine/Core/Math/{cFrustum,cMatrix_transformation,cQuaternion,cVector,Functions}.cpp ../AssetPacker/cAssetPacker.cpp ../BuilderHelper/{cbBuilder,UtilityFunctions}.cpp -lEGL -lGL -lGLU -o RenderBenchmark_gl
+*/
+
+// Header Files
+//=============
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "../../Engine/Graphics/AssetCompression.h"
+#include "../../Engine/Graphics/cCommandBuffer.h"
+#include "../../Engine/Graphics/cMappedFile.h"
+#include "../../Engine/Graphics/cWorkerPool.h"
+#include "../../Engine/Graphics/Graphics.h"
+#include "../../Engine/Graphics/Renderable.h"
+#include "../AssetPacker/cAssetPacker.h"
+
+#if !defined( _WIN32 )
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+#if !defined( EAE6320_PLATFORM_NULL ) && !defined( EAE6320_PLATFORM_GL )
+	#error "The render benchmark must be built with EAE6320_PLATFORM_NULL or EAE6320_PLATFORM_GL"
+#endif
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	struct sResult
+	{
+		size_t renderableCount;
+		double loadMilliseconds;
+		// The fastest frame and the average of every frame
+		double fastestFrameMilliseconds;
+		double averageFrameMilliseconds;
+		// These are the same in every frame because nothing moves
+		eae6320::Graphics::sFrameStatistics frameStatistics;
+		// What the last frame recorded
+		size_t commandCount;
+		size_t commandBytes;
+		// The game loop without the render thread and then with it
+		struct sGameLoop
+		{
+			double averageFrameMilliseconds;
+			double averageLatencyMilliseconds;
+		} gameLoops[2];
+	};
+
+	std::vector<sResult> s_results;
+
+	struct sScalingResult
+	{
+		size_t threadCount;
+		double averageFrameMilliseconds;
+		// Whether the frame's commands (and every matrix that they use) were identical to those with a single thread
+		bool isIdentical;
+	};
+	std::vector<sScalingResult> s_scalingResults;
+	const size_t s_threadCounts[] = { 1, 2, 4, 8 };
+
+	struct sErrorCheckResult
+	{
+		const char* modeName;
+		// Whether the platform (and this build of it) could check errors this way
+		bool isSupported;
+		double averageFrameMilliseconds;
+		uint32_t apiErrors;
+	};
+	std::vector<sErrorCheckResult> s_errorCheckResults;
+	const eae6320::Graphics::eErrorCheckMode s_errorCheckModes[] =
+	{
+		eae6320::Graphics::errorChecksOff, eae6320::Graphics::errorChecksPerFrame,
+		eae6320::Graphics::errorChecksPerCall, eae6320::Graphics::errorChecksDebugOutput,
+	};
+	const char* const s_errorCheckModeNames[] = { "off", "per frame", "per call", "debug output" };
+
+	struct sLoadResult
+	{
+		const char* methodName;
+		double averageMilliseconds;
+		// What one load of the whole set did
+		eae6320::Graphics::sLoadStatistics statistics;
+	};
+	// Read into memory and then mapped
+	sLoadResult s_loadResults[2] = { { "read" }, { "mapped" } };
+	// The meshes and materials whose loading is measured
+	std::vector<std::pair<std::string, std::string> > s_loadSet;
+	bool s_shouldLoadPlanets = false;
+	// These are the ones that the game loads when it starts
+	const char* const s_planetNames[] =
+	{
+		"Pointer", "Background", "Mercury", "Venus", "Earth", "Mars", "Jupiter", "Saturn", "Uranus", "Neptune", "Pluto",
+	};
+	size_t s_loadRoundCount = 20;
+
+	struct sStreamingResult
+	{
+		const char* methodName;
+		size_t frameCount;
+		double averageFrameMilliseconds;
+		double worstFrameMilliseconds;
+		// How long the worst frame was held up by loading
+		double worstStallMilliseconds;
+	};
+	// AddRenderable(), then AddRenderableAsync(), and then AddRenderableAsync() with the render thread creating the graphics objects
+	sStreamingResult s_streamingResults[3] = { { "blocking" }, { "streamed" }, { "threaded" } };
+
+	struct sStartupResult
+	{
+		const char* layoutName;
+		// Loading the benchmark's own meshes and materials when none of their files were in the OS's cache
+		// and when all of them were
+		double coldMilliseconds;
+		double warmMilliseconds;
+		// Files that had to be opened (the pack counts as one) and how much space the files take up on disk
+		uint32_t openedFileCount;
+		uint64_t diskBytes;
+	};
+	// The assets' own files and then the pack
+	sStartupResult s_startupResults[2] = { { "loose" }, { "packed" } };
+	bool s_canEvictFiles = false;
+	// Every asset that the benchmark writes is packed into this too
+	std::vector<std::string> s_assetPaths;
+	const char* const s_packPath = "RenderBenchmark.pack";
+	eae6320::cAssetPacker::sPackStatistics s_packStatistics;
+
+	struct sCompressionResult
+	{
+		const char* assetName;
+		uint32_t chunkCount;
+		uint64_t rawBytes;
+		uint64_t compressedBytes;
+		// Reading the uncompressed file and then the compressed one,
+		// when it wasn't in the OS's cache and when it was
+		double coldMilliseconds[2];
+		double warmMilliseconds[2];
+		// Decompressing it on one thread and then on every core
+		double decompressionMegabytesPerSecond[2];
+		// Whether it decompressed to exactly what was compressed
+		bool isIdentical;
+	};
+	std::vector<sCompressionResult> s_compressionResults;
+	// The game's planets are spheres with 40 rings (about 150 KB each),
+	// and the big one is there to have enough chunks to decompress on every core
+	const char* const s_compressedMeshNames[] = { "planet", "big" };
+	const uint32_t s_compressedMeshRingCounts[] = { 40, 256 };
+	const size_t s_compressedMeshCount = sizeof( s_compressedMeshNames ) / sizeof( s_compressedMeshNames[0] );
+	size_t s_decompressionThreadCount = 1;
+
+	// What the largest scene shared (the hits and misses are only those of adding it)
+	eae6320::Graphics::sAssetCacheStatistics s_assetCacheResults[eae6320::Graphics::assetTypeCount];
+	const char* const s_assetTypeNames[eae6320::Graphics::assetTypeCount] = { "mesh", "effect", "material", "texture" };
+
+#if defined( EAE6320_PLATFORM_NULL )
+	const size_t s_renderableCounts[] = { 100, 1000, 10000, 50000 };
+#else
+	// llvmpipe rasterizes every draw on the CPU, and so the largest scene would take too long
+	const size_t s_renderableCounts[] = { 100, 1000, 10000 };
+#endif
+	size_t s_frameCount = 100;
+	// How long the game loop's simulation takes every frame, in addition to rotating every renderable
+	// (this stands in for the gameplay code)
+	double s_simulationMilliseconds = 2.0;
+
+	// The scene is a mix of the kinds of draws that the game makes:
+	// instanced opaque ones, opaque ones that are drawn one at a time, and transparent ones
+	const char* const s_meshPaths[] = { "RenderBenchmark_cube.lmesh", "RenderBenchmark_panel.lmesh" };
+	const size_t s_meshCount = sizeof( s_meshPaths ) / sizeof( s_meshPaths[0] );
+	const size_t s_materialCount = 12;
+	const size_t s_transparentMaterialCount = 3;
+	const size_t s_uninstancedMaterialCount = 3;
+	std::vector<std::string> s_materialPaths;
+	const char* const s_texturePath = "RenderBenchmark_texture.dds";
+	const char* const s_instancedVertexShaderPath = "RenderBenchmark_instanced.vertex.shader";
+	const char* const s_vertexShaderPath = "RenderBenchmark.vertex.shader";
+	const char* const s_fragmentShaderPath = "RenderBenchmark.fragment.shader";
+
+	std::mt19937 s_randomNumberGenerator( 6320 );
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	bool WriteAssets();
+	// Every file that is written is packed too unless i_shouldPack is false
+	bool WriteFile( const char* const i_path, const void* const i_data, const size_t i_size, const bool i_shouldPack = true );
+	bool WriteMesh( const char* const i_path, const float i_halfExtent );
+	// A UV sphere with a radius of one and twice as many segments as rings
+	void CreateSphereMesh( const uint32_t i_ringCount, std::vector<uint8_t>& o_contents );
+	void CreateMeshContents( const std::vector<eae6320::Graphics::sVertex>& i_vertices, const std::vector<uint32_t>& i_indices,
+		const float i_halfExtent, const float i_radius, std::vector<uint8_t>& o_contents );
+	bool WriteEffect( const char* const i_path, const uint8_t i_renderStates, const char* const i_vertexShaderPath );
+	bool WriteMaterial( const char* const i_path, const char* const i_effectPath, const bool i_isTransparent, const float i_brightness );
+	float GetRandomFloat( const float i_min, const float i_max );
+	void MeasureGameLoop( const std::vector<eae6320::Graphics::Renderable*>& i_renderables, sResult::sGameLoop& o_result );
+	double MeasureAverageFrame();
+	bool MeasureLoading();
+	bool MeasureStreaming();
+	bool MeasureStartup();
+	bool MeasureCompression();
+	// Checks that a material constant is uploaded whichever of the renderables that share the material it is changed through
+	// (only the null platform counts uploaded bytes, and so this does nothing on the others)
+	bool CheckMaterialConstants();
+	// Drops the file from the OS's cache so that the next time it is read it has to come from the disk
+	// (this returns false if the platform can't do that)
+	bool EvictFromFileCache( const char* const i_path );
+	// An FNV-1a hash of the last frame's commands and the matrices that they use
+	uint64_t HashFrameCommands();
+	bool WriteJson( const char* const i_path );
+}
+
+// Entry Point
+//============
+
+int main( int i_argumentCount, char** i_arguments )
+{
+	typedef std::chrono::high_resolution_clock tClock;
+
+	const char* outputPath = "RenderBenchmark.json";
+	for ( int i = 1; i < i_argumentCount; ++i )
+	{
+		if ( std::strcmp( i_arguments[i], "-quick" ) == 0 )
+		{
+			s_frameCount = 10;
+			s_loadRoundCount = 3;
+		}
+		else if ( std::strcmp( i_arguments[i], "-planets" ) == 0 )
+		{
+			s_shouldLoadPlanets = true;
+		}
+		else if ( ( std::strcmp( i_arguments[i], "-simulate" ) == 0 ) && ( ( i + 1 ) < i_argumentCount ) )
+		{
+			s_simulationMilliseconds = std::atof( i_arguments[++i] );
+		}
+		else
+		{
+			outputPath = i_arguments[i];
+		}
+	}
+
+	if ( !WriteAssets() )
+	{
+		return EXIT_FAILURE;
+	}
+	if ( !eae6320::Graphics::Initialize( NULL ) )
+	{
+		std::cerr << "The graphics platform couldn't be initialized\n";
+		return EXIT_FAILURE;
+	}
+
+	bool wereThereErrors = false;
+	if ( !MeasureLoading() )
+	{
+		wereThereErrors = true;
+	}
+	std::cout << "Loading (" << s_loadSet.size() << ( s_shouldLoadPlanets ? " planets" : " meshes and materials" )
+		<< ", " << s_loadRoundCount << " rounds)\n\n"
+		<< std::right << std::setw( 12 ) << "method" << std::setw( 12 ) << "average ms" << std::setw( 12 ) << "files"
+		<< std::setw( 14 ) << "file bytes" << std::setw( 14 ) << "copied bytes" << "\n";
+	for ( const sLoadResult& loadResult : s_loadResults )
+	{
+		std::cout << std::setw( 12 ) << loadResult.methodName
+			<< std::fixed << std::setprecision( 3 ) << std::setw( 12 ) << loadResult.averageMilliseconds
+			<< std::setw( 12 ) << loadResult.statistics.fileCount << std::setw( 14 ) << loadResult.statistics.fileBytes
+			<< std::setw( 14 ) << loadResult.statistics.copiedBytes << "\n";
+	}
+	std::cout << "\n";
+
+	if ( !MeasureStreaming() )
+	{
+		wereThereErrors = true;
+	}
+	std::cout << "Adding the same set during frames\n\n"
+		<< std::setw( 12 ) << "method" << std::setw( 12 ) << "frames" << std::setw( 12 ) << "average ms"
+		<< std::setw( 12 ) << "worst ms" << std::setw( 12 ) << "stall ms" << "\n";
+	for ( const sStreamingResult& streamingResult : s_streamingResults )
+	{
+		std::cout << std::setw( 12 ) << streamingResult.methodName << std::setw( 12 ) << streamingResult.frameCount
+			<< std::setw( 12 ) << streamingResult.averageFrameMilliseconds << std::setw( 12 ) << streamingResult.worstFrameMilliseconds
+			<< std::setw( 12 ) << streamingResult.worstStallMilliseconds << "\n";
+	}
+	std::cout << "\n";
+
+	if ( !MeasureStartup() )
+	{
+		wereThereErrors = true;
+	}
+	std::cout << "Starting up (" << s_materialCount << " meshes and materials, " << s_packStatistics.assetCount << " assets in "
+		<< s_packStatistics.payloadCount << " payloads)\n\n"
+		<< std::setw( 12 ) << "layout" << std::setw( 12 ) << "cold ms" << std::setw( 12 ) << "warm ms"
+		<< std::setw( 12 ) << "files" << std::setw( 14 ) << "disk bytes" << "\n";
+	for ( const sStartupResult& startupResult : s_startupResults )
+	{
+		std::cout << std::setw( 12 ) << startupResult.layoutName;
+		if ( s_canEvictFiles )
+		{
+			std::cout << std::setw( 12 ) << startupResult.coldMilliseconds;
+		}
+		else
+		{
+			std::cout << std::setw( 12 ) << "unsupported";
+		}
+		std::cout << std::setw( 12 ) << startupResult.warmMilliseconds << std::setw( 12 ) << startupResult.openedFileCount
+			<< std::setw( 14 ) << startupResult.diskBytes << "\n";
+	}
+	std::cout << "\n";
+
+	if ( !MeasureCompression() )
+	{
+		wereThereErrors = true;
+	}
+	std::cout << "Compressed meshes (" << ( eae6320::Graphics::AssetCompression::s_maxChunkSize / 1024 ) << " KB chunks, "
+		<< s_loadRoundCount << " rounds)\n\n"
+		<< std::setw( 12 ) << "mesh" << std::setw( 12 ) << "chunks" << std::setw( 14 ) << "raw bytes" << std::setw( 14 ) << "disk bytes"
+		<< std::setw( 14 ) << "saved bytes" << std::setw( 12 ) << "saved %" << "\n";
+	for ( const sCompressionResult& compressionResult : s_compressionResults )
+	{
+		std::cout << std::setw( 12 ) << compressionResult.assetName << std::setw( 12 ) << compressionResult.chunkCount
+			<< std::setw( 14 ) << compressionResult.rawBytes << std::setw( 14 ) << compressionResult.compressedBytes
+			<< std::setw( 14 ) << ( compressionResult.rawBytes - compressionResult.compressedBytes )
+			<< std::setprecision( 1 ) << std::setw( 12 )
+			<< ( 100.0 * static_cast<double>( compressionResult.rawBytes - compressionResult.compressedBytes ) / compressionResult.rawBytes )
+			<< std::setprecision( 3 ) << "\n";
+	}
+	std::cout << "\nReading them (ms until the contents are in memory)\n\n"
+		<< std::setw( 12 ) << "mesh" << std::setw( 12 ) << "raw cold" << std::setw( 18 ) << "compressed cold"
+		<< std::setw( 12 ) << "raw warm" << std::setw( 18 ) << "compressed warm" << "\n";
+	for ( const sCompressionResult& compressionResult : s_compressionResults )
+	{
+		std::cout << std::setw( 12 ) << compressionResult.assetName;
+		if ( s_canEvictFiles )
+		{
+			std::cout << std::setw( 12 ) << compressionResult.coldMilliseconds[0] << std::setw( 18 ) << compressionResult.coldMilliseconds[1];
+		}
+		else
+		{
+			std::cout << std::setw( 30 ) << "unsupported";
+		}
+		std::cout << std::setw( 12 ) << compressionResult.warmMilliseconds[0] << std::setw( 18 ) << compressionResult.warmMilliseconds[1] << "\n";
+	}
+	std::cout << "\nDecompressing them\n\n"
+		<< std::setw( 12 ) << "mesh" << std::setw( 14 ) << "1 thread MB/s"
+		<< std::setw( 26 ) << ( "all " + std::to_string( s_decompressionThreadCount ) + " cores MB/s" ) << std::setw( 12 ) << "identical" << "\n";
+	for ( const sCompressionResult& compressionResult : s_compressionResults )
+	{
+		std::cout << std::setw( 12 ) << compressionResult.assetName << std::setprecision( 1 )
+			<< std::setw( 14 ) << compressionResult.decompressionMegabytesPerSecond[0]
+			<< std::setw( 26 ) << compressionResult.decompressionMegabytesPerSecond[1] << std::setprecision( 3 )
+			<< std::setw( 12 ) << ( compressionResult.isIdentical ? "yes" : "NO" ) << "\n";
+	}
+	std::cout << "\n";
+
+	if ( !CheckMaterialConstants() )
+	{
+		wereThereErrors = true;
+	}
+
+	std::cout << "Render benchmark (" << s_frameCount << " frames per scene)\n\n"
+		<< std::right << std::setw( 12 ) << "renderables" << std::setw( 12 ) << "load ms" << std::setw( 12 ) << "fastest ms"
+		<< std::setw( 12 ) << "average ms" << std::setw( 12 ) << "draw calls" << std::setw( 12 ) << "states" << std::setw( 12 ) << "redundant"
+		<< std::setw( 14 ) << "upload bytes" << "\n";
+
+	for ( const size_t renderableCount : s_renderableCounts )
+	{
+		sResult result;
+		result.renderableCount = renderableCount;
+		const bool isLargestScene = renderableCount == s_renderableCounts[( sizeof( s_renderableCounts ) / sizeof( s_renderableCounts[0] ) ) - 1];
+		eae6320::Graphics::sAssetCacheStatistics assetCacheStatistics_before[eae6320::Graphics::assetTypeCount];
+		for ( uint8_t i = 0; i < eae6320::Graphics::assetTypeCount; ++i )
+		{
+			assetCacheStatistics_before[i] = eae6320::Graphics::GetAssetCacheStatistics( static_cast<eae6320::Graphics::eAssetType>( i ) );
+		}
+
+		// The renderables are spread through a box in front of the camera
+		// that is wider than the view, so that some of them are culled
+		std::vector<eae6320::Graphics::Renderable*> renderables( renderableCount );
+		{
+			const tClock::time_point startTime = tClock::now();
+			for ( size_t i = 0; i < renderableCount; ++i )
+			{
+				const eae6320::Math::cVector offset( GetRandomFloat( -40.0f, 40.0f ), GetRandomFloat( -25.0f, 25.0f ), GetRandomFloat( -80.0f, 0.0f ) );
+				renderables[i] = new eae6320::Graphics::Renderable( offset );
+				eae6320::Graphics::AddRenderable( s_meshPaths[i % s_meshCount], s_materialPaths[i % s_materialCount].c_str(), renderables[i] );
+			}
+			const tClock::time_point endTime = tClock::now();
+			result.loadMilliseconds = std::chrono::duration<double, std::milli>( endTime - startTime ).count();
+		}
+		if ( isLargestScene )
+		{
+			for ( uint8_t i = 0; i < eae6320::Graphics::assetTypeCount; ++i )
+			{
+				s_assetCacheResults[i] = eae6320::Graphics::GetAssetCacheStatistics( static_cast<eae6320::Graphics::eAssetType>( i ) );
+				s_assetCacheResults[i].hits -= assetCacheStatistics_before[i].hits;
+				s_assetCacheResults[i].misses -= assetCacheStatistics_before[i].misses;
+			}
+		}
+
+		// The first frame is thrown away because it is the one that grows every scratch array
+		eae6320::Graphics::Render();
+		double totalTime_milliseconds = 0.0;
+		result.fastestFrameMilliseconds = 0.0;
+		for ( size_t i = 0; i < s_frameCount; ++i )
+		{
+			const tClock::time_point startTime = tClock::now();
+			eae6320::Graphics::Render();
+			const tClock::time_point endTime = tClock::now();
+			const double frame_milliseconds = std::chrono::duration<double, std::milli>( endTime - startTime ).count();
+			result.fastestFrameMilliseconds = ( i == 0 ) ? frame_milliseconds : std::min( result.fastestFrameMilliseconds, frame_milliseconds );
+			totalTime_milliseconds += frame_milliseconds;
+		}
+		result.averageFrameMilliseconds = totalTime_milliseconds / static_cast<double>( s_frameCount );
+		result.frameStatistics = eae6320::Graphics::GetFrameStatistics();
+		result.commandCount = eae6320::Graphics::GetFrameCommands().GetCommandCount();
+		result.commandBytes = eae6320::Graphics::GetFrameCommands().GetSize();
+		if ( result.frameStatistics.drawCalls == 0 )
+		{
+			std::cerr << "Nothing was drawn with " << renderableCount << " renderables\n";
+			wereThereErrors = true;
+		}
+		s_results.push_back( result );
+
+		std::cout << std::setw( 12 ) << result.renderableCount
+			<< std::fixed << std::setprecision( 3 ) << std::setw( 12 ) << result.loadMilliseconds
+			<< std::setw( 12 ) << result.fastestFrameMilliseconds << std::setw( 12 ) << result.averageFrameMilliseconds
+			<< std::setw( 12 ) << result.frameStatistics.drawCalls << std::setw( 12 ) << result.frameStatistics.stateChanges
+			<< std::setw( 12 ) << result.frameStatistics.redundantStateChanges << std::setw( 14 ) << result.frameStatistics.uploadedBytes << "\n";
+
+		// The largest scene is also rendered with different numbers of threads building the draw list
+		if ( isLargestScene )
+		{
+			uint64_t expectedHash = 0;
+			for ( const size_t threadCount : s_threadCounts )
+			{
+				eae6320::Graphics::SetDrawListThreadCount( threadCount );
+				sScalingResult scalingResult;
+				scalingResult.threadCount = threadCount;
+				scalingResult.averageFrameMilliseconds = MeasureAverageFrame();
+				const uint64_t hash = HashFrameCommands();
+				if ( threadCount == s_threadCounts[0] )
+				{
+					expectedHash = hash;
+				}
+				scalingResult.isIdentical = hash == expectedHash;
+				if ( !scalingResult.isIdentical )
+				{
+					std::cerr << "The frame was different when " << threadCount << " threads built the draw list\n";
+					wereThereErrors = true;
+				}
+				s_scalingResults.push_back( scalingResult );
+			}
+			// Everything else uses one thread per core
+			eae6320::Graphics::SetDrawListThreadCount( 0 );
+
+			const eae6320::Graphics::eErrorCheckMode defaultErrorCheckMode = eae6320::Graphics::GetErrorCheckMode();
+			for ( size_t i = 0; i < ( sizeof( s_errorCheckModes ) / sizeof( s_errorCheckModes[0] ) ); ++i )
+			{
+				sErrorCheckResult errorCheckResult;
+				errorCheckResult.modeName = s_errorCheckModeNames[i];
+				errorCheckResult.isSupported = eae6320::Graphics::SetErrorCheckMode( s_errorCheckModes[i] );
+				errorCheckResult.averageFrameMilliseconds = errorCheckResult.isSupported ? MeasureAverageFrame() : 0.0;
+				errorCheckResult.apiErrors = errorCheckResult.isSupported ? eae6320::Graphics::GetFrameStatistics().apiErrors : 0;
+				if ( errorCheckResult.apiErrors > 0 )
+				{
+					std::cerr << "The graphics API reported errors while errors were checked " << errorCheckResult.modeName << "\n";
+					wereThereErrors = true;
+				}
+				s_errorCheckResults.push_back( errorCheckResult );
+			}
+			eae6320::Graphics::SetErrorCheckMode( defaultErrorCheckMode );
+		}
+
+		MeasureGameLoop( renderables, s_results.back().gameLoops[0] );
+		if ( !eae6320::Graphics::StartRenderThread() )
+		{
+			std::cerr << "The render thread couldn't be started\n";
+			return EXIT_FAILURE;
+		}
+		MeasureGameLoop( renderables, s_results.back().gameLoops[1] );
+		eae6320::Graphics::StopRenderThread();
+
+		for ( size_t i = 0; i < renderableCount; ++i )
+		{
+			eae6320::Graphics::RemoveRenderable( renderables[i] );
+			delete renderables[i];
+		}
+		// The last renderable to be removed must have released every asset
+		for ( uint8_t i = 0; i < eae6320::Graphics::assetTypeCount; ++i )
+		{
+			if ( eae6320::Graphics::GetAssetCacheStatistics( static_cast<eae6320::Graphics::eAssetType>( i ) ).loadedCount != 0 )
+			{
+				std::cerr << "A " << s_assetTypeNames[i] << " was still loaded after every renderable was removed\n";
+				wereThereErrors = true;
+			}
+		}
+	}
+
+	std::cout << "\nShared assets (" << s_renderableCounts[( sizeof( s_renderableCounts ) / sizeof( s_renderableCounts[0] ) ) - 1] << " renderables)\n\n"
+		<< std::setw( 12 ) << "asset" << std::setw( 12 ) << "loaded" << std::setw( 12 ) << "bytes"
+		<< std::setw( 12 ) << "hits" << std::setw( 12 ) << "misses" << "\n";
+	for ( uint8_t i = 0; i < eae6320::Graphics::assetTypeCount; ++i )
+	{
+		const eae6320::Graphics::sAssetCacheStatistics& assetCacheResult = s_assetCacheResults[i];
+		std::cout << std::setw( 12 ) << s_assetTypeNames[i] << std::setw( 12 ) << assetCacheResult.loadedCount
+			<< std::setw( 12 ) << assetCacheResult.loadedBytes << std::setw( 12 ) << assetCacheResult.hits
+			<< std::setw( 12 ) << assetCacheResult.misses << "\n";
+	}
+
+#if defined( EAE6320_PLATFORM_NULL )
+	{
+		const eae6320::Graphics::sResourceStatistics& resources = eae6320::Graphics::GetResourceStatistics();
+		std::cout << "\n" << resources.meshCount << " meshes (" << ( resources.vertexBufferBytes + resources.indexBufferBytes ) << " bytes), "
+			<< resources.effectCount << " effects and " << resources.materialCount << " materials were loaded\n";
+	}
+#endif
+	std::cout << "\nGame loop (" << std::setprecision( 1 ) << s_simulationMilliseconds << " ms of simulation per frame)\n\n"
+		<< std::setw( 12 ) << "renderables" << std::setw( 16 ) << "serial frame" << std::setw( 16 ) << "threaded frame"
+		<< std::setw( 16 ) << "serial latency" << std::setw( 18 ) << "threaded latency" << "\n";
+	for ( const sResult& result : s_results )
+	{
+		std::cout << std::setw( 12 ) << result.renderableCount << std::setprecision( 3 )
+			<< std::setw( 16 ) << result.gameLoops[0].averageFrameMilliseconds << std::setw( 16 ) << result.gameLoops[1].averageFrameMilliseconds
+			<< std::setw( 16 ) << result.gameLoops[0].averageLatencyMilliseconds << std::setw( 18 ) << result.gameLoops[1].averageLatencyMilliseconds << "\n";
+	}
+	std::cout << "\nDraw list threads (" << s_renderableCounts[( sizeof( s_renderableCounts ) / sizeof( s_renderableCounts[0] ) ) - 1]
+		<< " renderables, " << std::thread::hardware_concurrency() << " cores)\n\n"
+		<< std::setw( 12 ) << "threads" << std::setw( 12 ) << "average ms" << std::setw( 12 ) << "speedup" << std::setw( 12 ) << "identical" << "\n";
+	for ( const sScalingResult& scalingResult : s_scalingResults )
+	{
+		std::cout << std::setw( 12 ) << scalingResult.threadCount << std::setw( 12 ) << scalingResult.averageFrameMilliseconds
+			<< std::setw( 12 ) << ( s_scalingResults[0].averageFrameMilliseconds / scalingResult.averageFrameMilliseconds )
+			<< std::setw( 12 ) << ( scalingResult.isIdentical ? "yes" : "NO" ) << "\n";
+	}
+	std::cout << "\nError checks\n\n"
+		<< std::setw( 14 ) << "mode" << std::setw( 12 ) << "average ms" << std::setw( 12 ) << "errors" << "\n";
+	for ( const sErrorCheckResult& errorCheckResult : s_errorCheckResults )
+	{
+		std::cout << std::setw( 14 ) << errorCheckResult.modeName;
+		if ( errorCheckResult.isSupported )
+		{
+			std::cout << std::setw( 12 ) << errorCheckResult.averageFrameMilliseconds << std::setw( 12 ) << errorCheckResult.apiErrors << "\n";
+		}
+		else
+		{
+			std::cout << std::setw( 24 ) << "unsupported" << "\n";
+		}
+	}
+	std::cout << "\n";
+	eae6320::Graphics::ShutDown();
+
+	if ( !WriteJson( outputPath ) )
+	{
+		wereThereErrors = true;
+	}
+	else
+	{
+		std::cout << "Results were written to " << outputPath << "\n";
+	}
+
+	return wereThereErrors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	bool WriteAssets()
+	{
+		// These are what ShaderBuilder would output for OpenGL
+		// (the null platform only reads the vertex shaders to find out whether they are instanced)
+		const std::string vertexShaderInputs =
+			"#version 330\n"
+			"#extension GL_ARB_separate_shader_objects : require\n"
+			"layout( location = 0 ) in vec3 i_position_local;\n"
+			"layout( location = 1 ) in vec4 i_color;\n"
+			"layout( location = 2 ) in vec2 i_texcoords;\n";
+		const std::string vertexShaderBody =
+			"layout( location = 0 ) out vec4 o_color;\n"
+			"layout( location = 1 ) out vec2 o_texcoords;\n"
+			"void main()\n"
+			"{\n"
+			"	gl_Position = vec4( i_position_local, 1.0 ) * g_transform_localToProjected;\n"
+			"	o_color = i_color;\n"
+			"	o_texcoords = i_texcoords;\n"
+			"}\n";
+		const std::string instancedVertexShader = vertexShaderInputs
+			+ "layout( location = 3 ) in mat4 i_transform_localToProjected;\n"
+			"#define g_transform_localToProjected i_transform_localToProjected\n" + vertexShaderBody;
+		const std::string vertexShader = vertexShaderInputs + "uniform mat4 g_transform_localToProjected;\n" + vertexShaderBody;
+		const std::string fragmentShader =
+			"#version 330\n"
+			"#extension GL_ARB_separate_shader_objects : require\n"
+			"layout( std140 ) uniform g_materialConstants\n"
+			"{\n"
+			"	vec3 g_RGB;\n"
+			"	float g_Alpha;\n"
+			"};\n"
+			"uniform sampler2D g_sampler;\n"
+			"layout( location = 0 ) in vec4 i_color;\n"
+			"layout( location = 1 ) in vec2 i_texcoords;\n"
+			"out vec4 o_color;\n"
+			"void main()\n"
+			"{\n"
+			"	o_color = vec4( i_color.rgb * g_RGB, g_Alpha ) * texture( g_sampler, i_texcoords );\n"
+			"}\n";
+		// A white 4x4 DXT1 DDS with a single MIP level
+		uint32_t texture[( 4 + 124 + 8 ) / sizeof( uint32_t )] = { 0 };
+		{
+			std::memcpy( &texture[0], "DDS ", 4 );
+			texture[1] = 124;	// Header size
+			texture[2] = 0x1 | 0x2 | 0x4 | 0x1000 | 0x80000;	// Caps, height, width, pixel format and linear size flags
+			texture[3] = texture[4] = 4;	// Height and width
+			texture[5] = 8;	// Linear size
+			texture[7] = 1;	// MIP level count
+			texture[19] = 32;	// Pixel format size
+			texture[20] = 0x4;	// Four CC flag
+			std::memcpy( &texture[21], "DXT1", 4 );
+			texture[27] = 0x1000;	// Texture caps
+			texture[32] = 0xffffffff;	// Both endpoint colors are white
+		}
+		if ( !WriteFile( s_instancedVertexShaderPath, instancedVertexShader.c_str(), instancedVertexShader.size() )
+			|| !WriteFile( s_vertexShaderPath, vertexShader.c_str(), vertexShader.size() )
+			|| !WriteFile( s_fragmentShaderPath, fragmentShader.c_str(), fragmentShader.size() )
+			|| !WriteFile( s_texturePath, texture, sizeof( texture ) ) )
+		{
+			return false;
+		}
+
+		if ( !WriteMesh( s_meshPaths[0], 0.5f ) || !WriteMesh( s_meshPaths[1], 1.0f ) )
+		{
+			return false;
+		}
+
+		using namespace eae6320::Graphics;
+		const char* const instancedEffectPath = "RenderBenchmark_instanced.effect";
+		const char* const opaqueEffectPath = "RenderBenchmark_opaque.effect";
+		const char* const transparentEffectPath = "RenderBenchmark_transparent.effect";
+		if ( !WriteEffect( instancedEffectPath, depthtest | depthwrite | faceculling, s_instancedVertexShaderPath )
+			|| !WriteEffect( opaqueEffectPath, depthtest | depthwrite | faceculling, s_vertexShaderPath )
+			|| !WriteEffect( transparentEffectPath, alpha | depthtest | faceculling, s_vertexShaderPath ) )
+		{
+			return false;
+		}
+
+		for ( size_t i = 0; i < s_materialCount; ++i )
+		{
+			const bool isTransparent = i < s_transparentMaterialCount;
+			const bool isInstanced = i >= ( s_transparentMaterialCount + s_uninstancedMaterialCount );
+			const char* const effectPath = isTransparent ? transparentEffectPath : ( isInstanced ? instancedEffectPath : opaqueEffectPath );
+			s_materialPaths.push_back( "RenderBenchmark_" + std::to_string( i ) + ".material" );
+			if ( !WriteMaterial( s_materialPaths.back().c_str(), effectPath, isTransparent, static_cast<float>( i + 1 ) / s_materialCount ) )
+			{
+				return false;
+			}
+		}
+
+		// The pack is written the same way that the build writes the game's
+		// (the benchmark's assets are in the current directory, and so their paths are already relative to it)
+		return eae6320::cAssetPacker::WritePack( "", s_assetPaths, s_packPath, s_packStatistics );
+	}
+
+	bool WriteFile( const char* const i_path, const void* const i_data, const size_t i_size, const bool i_shouldPack )
+	{
+		std::ofstream file( i_path, std::ios::binary );
+		if ( !file.write( static_cast<const char*>( i_data ), i_size ) )
+		{
+			std::cerr << "The benchmark couldn't write " << i_path << "\n";
+			return false;
+		}
+		if ( i_shouldPack )
+		{
+			s_assetPaths.push_back( i_path );
+		}
+		return true;
+	}
+
+	bool WriteMesh( const char* const i_path, const float i_halfExtent )
+	{
+		using namespace eae6320::Graphics;
+
+		// A cube with a separate set of vertices for each face
+		const float h = i_halfExtent;
+		const float corners[8][3] =
+		{
+			{ -h, -h, -h }, { h, -h, -h }, { h, h, -h }, { -h, h, -h },
+			{ -h, -h, h }, { h, -h, h }, { h, h, h }, { -h, h, h },
+		};
+		const uint32_t faces[6][4] =
+		{
+			{ 4, 5, 6, 7 }, { 1, 0, 3, 2 }, { 5, 1, 2, 6 }, { 0, 4, 7, 3 }, { 7, 6, 2, 3 }, { 0, 1, 5, 4 },
+		};
+		std::vector<sVertex> vertices;
+		std::vector<uint32_t> indices;
+		for ( size_t f = 0; f < 6; ++f )
+		{
+			const uint32_t firstVertex = static_cast<uint32_t>( vertices.size() );
+			for ( size_t c = 0; c < 4; ++c )
+			{
+				const float* const corner = corners[faces[f][c]];
+				sVertex vertex;
+				vertex.x = corner[0];
+				vertex.y = corner[1];
+				vertex.z = corner[2];
+				vertex.u = ( c == 1 || c == 2 ) ? 1.0f : 0.0f;
+				vertex.v = ( c >= 2 ) ? 1.0f : 0.0f;
+				vertex.r = vertex.g = vertex.b = vertex.a = 255;
+				vertices.push_back( vertex );
+			}
+			const uint32_t faceIndices[] = { 0, 1, 2, 0, 2, 3 };
+			for ( const uint32_t index : faceIndices )
+			{
+				indices.push_back( firstVertex + index );
+			}
+		}
+
+		std::vector<uint8_t> contents;
+		CreateMeshContents( vertices, indices, h, h * 1.7320508f, contents );
+		return WriteFile( i_path, contents.data(), contents.size() );
+	}
+
+	void CreateSphereMesh( const uint32_t i_ringCount, std::vector<uint8_t>& o_contents )
+	{
+		using namespace eae6320::Graphics;
+
+		const uint32_t segmentCount = i_ringCount * 2;
+		const float pi = 3.14159265f;
+		std::vector<sVertex> vertices;
+		std::vector<uint32_t> indices;
+		// The first and last column of vertices are in the same place but have different texture coordinates
+		for ( uint32_t ring = 0; ring <= i_ringCount; ++ring )
+		{
+			const float latitude = pi * static_cast<float>( ring ) / static_cast<float>( i_ringCount );
+			for ( uint32_t segment = 0; segment <= segmentCount; ++segment )
+			{
+				const float longitude = 2.0f * pi * static_cast<float>( segment ) / static_cast<float>( segmentCount );
+				sVertex vertex;
+				vertex.x = std::sin( latitude ) * std::cos( longitude );
+				vertex.y = std::cos( latitude );
+				vertex.z = std::sin( latitude ) * std::sin( longitude );
+				vertex.u = static_cast<float>( segment ) / static_cast<float>( segmentCount );
+				vertex.v = static_cast<float>( ring ) / static_cast<float>( i_ringCount );
+				vertex.r = vertex.g = vertex.b = vertex.a = 255;
+				vertices.push_back( vertex );
+			}
+		}
+		for ( uint32_t ring = 0; ring < i_ringCount; ++ring )
+		{
+			for ( uint32_t segment = 0; segment < segmentCount; ++segment )
+			{
+				const uint32_t topLeft = ( ring * ( segmentCount + 1 ) ) + segment;
+				const uint32_t bottomLeft = topLeft + segmentCount + 1;
+				const uint32_t quadIndices[] = { topLeft, bottomLeft, topLeft + 1, topLeft + 1, bottomLeft, bottomLeft + 1 };
+				indices.insert( indices.end(), quadIndices, quadIndices + 6 );
+			}
+		}
+		CreateMeshContents( vertices, indices, 1.0f, 1.0f, o_contents );
+	}
+
+	void CreateMeshContents( const std::vector<eae6320::Graphics::sVertex>& i_vertices, const std::vector<uint32_t>& i_indices,
+		const float i_halfExtent, const float i_radius, std::vector<uint8_t>& o_contents )
+	{
+		using namespace eae6320::Graphics;
+
+		//[vertex count][index count][vertex format][bounds][vertices][indices]
+		const uint32_t header[] = { static_cast<uint32_t>( i_vertices.size() ), static_cast<uint32_t>( i_indices.size() ), floatVertices };
+		sMeshBounds bounds;
+		for ( size_t i = 0; i < 3; ++i )
+		{
+			bounds.sphereCenter[i] = 0.0f;
+			bounds.aabbMin[i] = -i_halfExtent;
+			bounds.aabbMax[i] = i_halfExtent;
+		}
+		bounds.sphereRadius = i_radius;
+		const uint8_t* const headerBytes = reinterpret_cast<const uint8_t*>( header );
+		const uint8_t* const boundsBytes = reinterpret_cast<const uint8_t*>( &bounds );
+		const uint8_t* const vertexBytes = reinterpret_cast<const uint8_t*>( i_vertices.data() );
+		const uint8_t* const indexBytes = reinterpret_cast<const uint8_t*>( i_indices.data() );
+		o_contents.clear();
+		o_contents.insert( o_contents.end(), headerBytes, headerBytes + sizeof( header ) );
+		o_contents.insert( o_contents.end(), boundsBytes, boundsBytes + sizeof( bounds ) );
+		o_contents.insert( o_contents.end(), vertexBytes, vertexBytes + ( i_vertices.size() * sizeof( sVertex ) ) );
+		o_contents.insert( o_contents.end(), indexBytes, indexBytes + ( i_indices.size() * sizeof( uint32_t ) ) );
+	}
+
+	bool WriteEffect( const char* const i_path, const uint8_t i_renderStates, const char* const i_vertexShaderPath )
+	{
+		//[render states][vertex shader path][fragment shader path]
+		std::string contents( 1, static_cast<char>( i_renderStates ) );
+		contents.append( i_vertexShaderPath, std::strlen( i_vertexShaderPath ) + 1 );
+		contents.append( s_fragmentShaderPath, std::strlen( s_fragmentShaderPath ) + 1 );
+		return WriteFile( i_path, contents.data(), contents.size() );
+	}
+
+	bool WriteMaterial( const char* const i_path, const char* const i_effectPath, const bool i_isTransparent, const float i_brightness )
+	{
+		using namespace eae6320::Graphics;
+
+		// This is laid out the way that MaterialBuilder lays out g_RGB and g_Alpha
+		sUniformHelper uniforms[2];
+		const char* const uniformNames[] = { "g_RGB", "g_Alpha" };
+		const uint8_t uniformCount = i_isTransparent ? 2 : 1;
+		uniforms[0].values[0] = uniforms[0].values[1] = uniforms[0].values[2] = i_brightness;
+		uniforms[0].valueCountToSet = 3;
+		uniforms[0].shaderType = fragment;
+		uniforms[0].blockOffset = 0;
+		uniforms[1].values[0] = 0.5f;
+		uniforms[1].valueCountToSet = 1;
+		uniforms[1].shaderType = fragment;
+		uniforms[1].blockOffset = 12;
+		const uint16_t constantBlockSize = 16;
+		float constantBlock[4] = { i_brightness, i_brightness, i_brightness, uniforms[1].values[0] };
+
+		//[effect path][texture handle][texture path][uniform count][uniforms][uniform names][constant block size][constant block]
+		std::string contents;
+		contents.append( i_effectPath, std::strlen( i_effectPath ) + 1 );
+		contents.append( "g_sampler", std::strlen( "g_sampler" ) + 1 );
+		contents.append( s_texturePath, std::strlen( s_texturePath ) + 1 );
+		contents.append( 1, static_cast<char>( uniformCount ) );
+		contents.append( reinterpret_cast<const char*>( uniforms ), uniformCount * sizeof( sUniformHelper ) );
+		for ( uint8_t i = 0; i < uniformCount; ++i )
+		{
+			contents.append( uniformNames[i], std::strlen( uniformNames[i] ) + 1 );
+		}
+		contents.append( reinterpret_cast<const char*>( &constantBlockSize ), sizeof( constantBlockSize ) );
+		contents.append( reinterpret_cast<const char*>( constantBlock ), constantBlockSize );
+		return WriteFile( i_path, contents.data(), contents.size() );
+	}
+
+	float GetRandomFloat( const float i_min, const float i_max )
+	{
+		return std::uniform_real_distribution<float>( i_min, i_max )( s_randomNumberGenerator );
+	}
+
+	void MeasureGameLoop( const std::vector<eae6320::Graphics::Renderable*>& i_renderables, sResult::sGameLoop& o_result )
+	{
+		typedef std::chrono::high_resolution_clock tClock;
+
+		// The first frame isn't measured
+		float angle = 0.0f;
+		double totalLatency_milliseconds = 0.0;
+		tClock::time_point startTime;
+		for ( size_t i = 0; i <= s_frameCount; ++i )
+		{
+			const tClock::time_point simulationStartTime = tClock::now();
+			if ( i == 1 )
+			{
+				startTime = simulationStartTime;
+			}
+			{
+				angle += 0.01f;
+				const eae6320::Math::cVector axis( 0.0f, 1.0f, 0.0f );
+				for ( eae6320::Graphics::Renderable* const renderable : i_renderables )
+				{
+					renderable->m_orientation = eae6320::Math::cQuaternion( angle, axis );
+				}
+				while ( std::chrono::duration<double, std::milli>( tClock::now() - simulationStartTime ).count() < s_simulationMilliseconds )
+				{
+				}
+			}
+			eae6320::Graphics::Render();
+			// This is the latency of the last frame that was presented
+			// (with the render thread that is usually the one before this one)
+			if ( i > 0 )
+			{
+				totalLatency_milliseconds += 1000.0 * eae6320::Graphics::GetFrameLatency();
+			}
+		}
+		const tClock::time_point endTime = tClock::now();
+		o_result.averageFrameMilliseconds = std::chrono::duration<double, std::milli>( endTime - startTime ).count() / static_cast<double>( s_frameCount );
+		o_result.averageLatencyMilliseconds = totalLatency_milliseconds / static_cast<double>( s_frameCount );
+	}
+
+	double MeasureAverageFrame()
+	{
+		typedef std::chrono::high_resolution_clock tClock;
+
+		// The first frame is thrown away because it is the one that grows every scratch array
+		eae6320::Graphics::Render();
+		const tClock::time_point startTime = tClock::now();
+		for ( size_t i = 0; i < s_frameCount; ++i )
+		{
+			eae6320::Graphics::Render();
+		}
+		const tClock::time_point endTime = tClock::now();
+		return std::chrono::duration<double, std::milli>( endTime - startTime ).count() / static_cast<double>( s_frameCount );
+	}
+
+	bool MeasureLoading()
+	{
+		typedef std::chrono::high_resolution_clock tClock;
+
+		if ( s_shouldLoadPlanets )
+		{
+			for ( const char* const planetName : s_planetNames )
+			{
+				s_loadSet.push_back( std::make_pair( std::string( "data/Mesh/" ) + planetName + ".lmesh", std::string( "data/Material/" ) + planetName + ".mat" ) );
+				if ( !std::ifstream( s_loadSet.back().first.c_str() ) || !std::ifstream( s_loadSet.back().second.c_str() ) )
+				{
+					std::cerr << "The planet " << planetName << " wasn't found (-planets must be run from the game's directory)\n";
+					s_loadSet.clear();
+					return false;
+				}
+			}
+		}
+		else
+		{
+			for ( size_t i = 0; i < s_materialCount; ++i )
+			{
+				s_loadSet.push_back( std::make_pair( std::string( s_meshPaths[i % s_meshCount] ), s_materialPaths[i] ) );
+			}
+		}
+
+		// The first round isn't measured so that every file is already in the OS's cache for both ways of loading,
+		// and then the two ways take turns so that neither of them benefits from running later
+		double totalTimes_milliseconds[2] = { 0.0, 0.0 };
+		std::vector<eae6320::Graphics::Renderable*> renderables( s_loadSet.size() );
+		for ( size_t round = 0; round <= s_loadRoundCount; ++round )
+		{
+			for ( size_t method = 0; method < 2; ++method )
+			{
+				const bool shouldReadIntoMemory = method == 0;
+				eae6320::Graphics::SetShouldReadAssetFilesIntoMemory( shouldReadIntoMemory );
+				const eae6320::Graphics::sLoadStatistics statistics_before = eae6320::Graphics::GetLoadStatistics();
+				const tClock::time_point startTime = tClock::now();
+				for ( size_t i = 0; i < s_loadSet.size(); ++i )
+				{
+					renderables[i] = new eae6320::Graphics::Renderable();
+					eae6320::Graphics::AddRenderable( s_loadSet[i].first.c_str(), s_loadSet[i].second.c_str(), renderables[i] );
+				}
+				const tClock::time_point endTime = tClock::now();
+				const eae6320::Graphics::sLoadStatistics& statistics_after = eae6320::Graphics::GetLoadStatistics();
+				for ( size_t i = 0; i < s_loadSet.size(); ++i )
+				{
+					eae6320::Graphics::RemoveRenderable( renderables[i] );
+					delete renderables[i];
+				}
+
+				sLoadResult& loadResult = s_loadResults[method];
+				loadResult.statistics.fileCount = statistics_after.fileCount - statistics_before.fileCount;
+				loadResult.statistics.fileBytes = statistics_after.fileBytes - statistics_before.fileBytes;
+				loadResult.statistics.copiedBytes = statistics_after.copiedBytes - statistics_before.copiedBytes;
+				if ( round > 0 )
+				{
+					totalTimes_milliseconds[method] += std::chrono::duration<double, std::milli>( endTime - startTime ).count();
+				}
+			}
+		}
+		eae6320::Graphics::SetShouldReadAssetFilesIntoMemory( false );
+		for ( size_t method = 0; method < 2; ++method )
+		{
+			s_loadResults[method].averageMilliseconds = totalTimes_milliseconds[method] / static_cast<double>( s_loadRoundCount );
+		}
+
+		// Both ways must open exactly the same files
+		const eae6320::Graphics::sLoadStatistics& read = s_loadResults[0].statistics;
+		const eae6320::Graphics::sLoadStatistics& mapped = s_loadResults[1].statistics;
+		if ( ( mapped.fileCount == 0 ) || ( mapped.fileCount != read.fileCount ) || ( mapped.fileBytes != read.fileBytes ) )
+		{
+			std::cerr << "The assets weren't loaded the same way when they were read and when they were mapped\n";
+			return false;
+		}
+		return true;
+	}
+
+	bool MeasureStreaming()
+	{
+		typedef std::chrono::high_resolution_clock tClock;
+
+		bool wereThereErrors = false;
+		std::vector<eae6320::Graphics::Renderable*> renderables( s_loadSet.size() );
+		for ( size_t method = 0; method < 3; ++method )
+		{
+			sStreamingResult& streamingResult = s_streamingResults[method];
+			streamingResult.frameCount = 0;
+			streamingResult.worstFrameMilliseconds = 0.0;
+			streamingResult.worstStallMilliseconds = 0.0;
+			double totalTime_milliseconds = 0.0;
+			if ( method == 0 )
+			{
+				// Every frame loads one renderable before it renders, which is what the game used to do
+				for ( size_t i = 0; i < s_loadSet.size(); ++i )
+				{
+					renderables[i] = new eae6320::Graphics::Renderable();
+					const tClock::time_point startTime = tClock::now();
+					eae6320::Graphics::AddRenderable( s_loadSet[i].first.c_str(), s_loadSet[i].second.c_str(), renderables[i] );
+					const tClock::time_point loadedTime = tClock::now();
+					eae6320::Graphics::Render();
+					const tClock::time_point endTime = tClock::now();
+					const double frame_milliseconds = std::chrono::duration<double, std::milli>( endTime - startTime ).count();
+					const double stall_milliseconds = std::chrono::duration<double, std::milli>( loadedTime - startTime ).count();
+					streamingResult.worstFrameMilliseconds = std::max( streamingResult.worstFrameMilliseconds, frame_milliseconds );
+					streamingResult.worstStallMilliseconds = std::max( streamingResult.worstStallMilliseconds, stall_milliseconds );
+					totalTime_milliseconds += frame_milliseconds;
+					++streamingResult.frameCount;
+				}
+			}
+			else
+			{
+				// Everything is asked for at once and frames are rendered until it has all been uploaded
+				if ( ( method == 2 ) && !eae6320::Graphics::StartRenderThread() )
+				{
+					std::cerr << "The render thread couldn't be started\n";
+					return false;
+				}
+				std::vector<eae6320::Graphics::tLoadHandle> handles( s_loadSet.size() );
+				for ( size_t i = 0; i < s_loadSet.size(); ++i )
+				{
+					renderables[i] = new eae6320::Graphics::Renderable();
+					handles[i] = eae6320::Graphics::AddRenderableAsync( s_loadSet[i].first.c_str(), s_loadSet[i].second.c_str(), renderables[i] );
+				}
+				// Empty frames are so quick that a frame count could run out before the streaming thread has even been scheduled
+				const std::chrono::seconds maxLoadingTime( 60 );
+				const tClock::time_point loadingStartTime = tClock::now();
+				bool isLoading = true;
+				while ( isLoading && ( ( tClock::now() - loadingStartTime ) < maxLoadingTime ) )
+				{
+					const tClock::time_point startTime = tClock::now();
+					eae6320::Graphics::Render();
+					const tClock::time_point endTime = tClock::now();
+					const double frame_milliseconds = std::chrono::duration<double, std::milli>( endTime - startTime ).count();
+					streamingResult.worstFrameMilliseconds = std::max( streamingResult.worstFrameMilliseconds, frame_milliseconds );
+					streamingResult.worstStallMilliseconds = std::max( streamingResult.worstStallMilliseconds,
+						static_cast<double>( eae6320::Graphics::GetStreamingStatistics().stallMilliseconds ) );
+					totalTime_milliseconds += frame_milliseconds;
+					++streamingResult.frameCount;
+					isLoading = false;
+					for ( const eae6320::Graphics::tLoadHandle handle : handles )
+					{
+						isLoading = isLoading || ( eae6320::Graphics::GetLoadState( handle ) == eae6320::Graphics::loadPending );
+					}
+				}
+				for ( const eae6320::Graphics::tLoadHandle handle : handles )
+				{
+					if ( eae6320::Graphics::GetLoadState( handle ) != eae6320::Graphics::loadSucceeded )
+					{
+						wereThereErrors = true;
+					}
+					eae6320::Graphics::ReleaseLoadHandle( handle );
+				}
+				if ( wereThereErrors )
+				{
+					std::cerr << "Not every renderable was streamed in\n";
+				}
+			}
+			streamingResult.averageFrameMilliseconds = ( streamingResult.frameCount > 0 ) ?
+				( totalTime_milliseconds / static_cast<double>( streamingResult.frameCount ) ) : 0.0;
+
+			for ( size_t i = 0; i < s_loadSet.size(); ++i )
+			{
+				eae6320::Graphics::RemoveRenderable( renderables[i] );
+				delete renderables[i];
+			}
+			eae6320::Graphics::StopRenderThread();
+		}
+		return !wereThereErrors;
+	}
+
+	bool MeasureStartup()
+	{
+		typedef std::chrono::high_resolution_clock tClock;
+
+		// This is the benchmark's own set even with -planets, because it needs to know every file that the set uses
+		std::vector<std::pair<std::string, std::string> > startupSet;
+		for ( size_t i = 0; i < s_materialCount; ++i )
+		{
+			startupSet.push_back( std::make_pair( std::string( s_meshPaths[i % s_meshCount] ), s_materialPaths[i] ) );
+		}
+
+		// The first round isn't measured so that the warm starts really are warm,
+		// and then the two layouts take turns so that neither of them benefits from running later
+		double coldTimes_milliseconds[2] = { 0.0, 0.0 };
+		double warmTimes_milliseconds[2] = { 0.0, 0.0 };
+		std::vector<eae6320::Graphics::Renderable*> renderables( startupSet.size() );
+		s_canEvictFiles = true;
+		for ( size_t round = 0; round <= s_loadRoundCount; ++round )
+		{
+			for ( size_t cacheState = 0; cacheState < 2; ++cacheState )
+			{
+				const bool isCold = cacheState == 1;
+				for ( size_t layout = 0; layout < 2; ++layout )
+				{
+					const bool isPacked = layout == 1;
+					if ( isCold )
+					{
+						if ( !s_canEvictFiles )
+						{
+							continue;
+						}
+						s_canEvictFiles = EvictFromFileCache( s_packPath );
+						for ( const std::string& assetPath : s_assetPaths )
+						{
+							s_canEvictFiles = s_canEvictFiles && EvictFromFileCache( assetPath.c_str() );
+						}
+					}
+					const eae6320::Graphics::sLoadStatistics statistics_before = eae6320::Graphics::GetLoadStatistics();
+					const tClock::time_point startTime = tClock::now();
+					if ( isPacked && !eae6320::Graphics::OpenAssetPack( s_packPath ) )
+					{
+						return false;
+					}
+					for ( size_t i = 0; i < startupSet.size(); ++i )
+					{
+						renderables[i] = new eae6320::Graphics::Renderable();
+						eae6320::Graphics::AddRenderable( startupSet[i].first.c_str(), startupSet[i].second.c_str(), renderables[i] );
+					}
+					const tClock::time_point endTime = tClock::now();
+					const eae6320::Graphics::sLoadStatistics& statistics_after = eae6320::Graphics::GetLoadStatistics();
+					for ( size_t i = 0; i < startupSet.size(); ++i )
+					{
+						eae6320::Graphics::RemoveRenderable( renderables[i] );
+						delete renderables[i];
+					}
+					if ( isPacked )
+					{
+						eae6320::Graphics::CloseAssetPack();
+					}
+
+					const uint32_t fileCount = statistics_after.fileCount - statistics_before.fileCount;
+					const uint32_t packedFileCount = statistics_after.packedFileCount - statistics_before.packedFileCount;
+					if ( ( fileCount == 0 ) || ( packedFileCount != ( isPacked ? fileCount : 0 ) ) )
+					{
+						std::cerr << "The pack didn't have every asset that the benchmark loads\n";
+						return false;
+					}
+					sStartupResult& startupResult = s_startupResults[layout];
+					startupResult.openedFileCount = ( fileCount - packedFileCount ) + ( isPacked ? 1 : 0 );
+					startupResult.diskBytes = isPacked ? s_packStatistics.packBytes : s_packStatistics.assetBytes;
+					if ( round > 0 )
+					{
+						double* const totalTimes_milliseconds = isCold ? coldTimes_milliseconds : warmTimes_milliseconds;
+						totalTimes_milliseconds[layout] += std::chrono::duration<double, std::milli>( endTime - startTime ).count();
+					}
+				}
+			}
+		}
+		for ( size_t layout = 0; layout < 2; ++layout )
+		{
+			s_startupResults[layout].coldMilliseconds = coldTimes_milliseconds[layout] / static_cast<double>( s_loadRoundCount );
+			s_startupResults[layout].warmMilliseconds = warmTimes_milliseconds[layout] / static_cast<double>( s_loadRoundCount );
+		}
+		return true;
+	}
+
+	bool MeasureCompression()
+	{
+		typedef std::chrono::high_resolution_clock tClock;
+		using namespace eae6320::Graphics;
+
+		// The spheres use a material that another renderable keeps loaded the whole time,
+		// so that only the sphere's mesh is loaded each time
+		const char* const materialPath = s_materialPaths.back().c_str();
+		Renderable* const materialHolder = new Renderable();
+		AddRenderable( s_meshPaths[0], materialPath, materialHolder );
+
+		bool wereThereErrors = false;
+		cWorkerPool decompressionPool;
+		s_decompressionThreadCount = std::max( std::thread::hardware_concurrency(), 1u );
+		for ( size_t i = 0; ( i < s_compressedMeshCount ) && !wereThereErrors; ++i )
+		{
+			sCompressionResult result = {};
+			result.assetName = s_compressedMeshNames[i];
+			std::vector<uint8_t> contents;
+			CreateSphereMesh( s_compressedMeshRingCounts[i], contents );
+			std::vector<uint8_t> compressedContents;
+			AssetCompression::Compress( contents.data(), contents.size(), compressedContents );
+			result.chunkCount = static_cast<uint32_t>( ( contents.size() + AssetCompression::s_maxChunkSize - 1 ) / AssetCompression::s_maxChunkSize );
+			result.rawBytes = contents.size();
+			result.compressedBytes = compressedContents.size();
+			// The spheres aren't packed because they are only used here
+			const std::string paths[2] =
+			{
+				std::string( "RenderBenchmark_" ) + result.assetName + ".lmesh",
+				std::string( "RenderBenchmark_" ) + result.assetName + "_compressed.lmesh",
+			};
+			if ( !WriteFile( paths[0].c_str(), contents.data(), contents.size(), false )
+				|| !WriteFile( paths[1].c_str(), compressedContents.data(), compressedContents.size(), false ) )
+			{
+				wereThereErrors = true;
+				break;
+			}
+
+			// Both files are loaded by the engine once to check that the compressed one is decompressed for the loaders
+			for ( size_t layout = 0; layout < 2; ++layout )
+			{
+				const sLoadStatistics statistics_before = GetLoadStatistics();
+				Renderable* const renderable = new Renderable();
+				AddRenderable( paths[layout].c_str(), materialPath, renderable );
+				const sLoadStatistics& statistics_after = GetLoadStatistics();
+				RemoveRenderable( renderable );
+				delete renderable;
+				const bool isCompressed = layout == 1;
+				if ( ( ( statistics_after.fileCount - statistics_before.fileCount ) != 1 )
+					|| ( ( statistics_after.compressedFileCount - statistics_before.compressedFileCount ) != ( isCompressed ? 1u : 0u ) )
+					|| ( ( statistics_after.fileBytes - statistics_before.fileBytes ) != ( isCompressed ? result.compressedBytes : result.rawBytes ) )
+					|| ( ( statistics_after.decompressedBytes - statistics_before.decompressedBytes ) != ( isCompressed ? result.rawBytes : 0u ) ) )
+				{
+					std::cerr << "The " << result.assetName << " sphere's mesh wasn't loaded from " << paths[layout] << " the way that it should have been\n";
+					wereThereErrors = true;
+				}
+			}
+
+			// Only reading the files is timed, because the null platform doesn't read a mesh's vertices and indices:
+			// the uncompressed file is mapped and has every page touched, and the compressed one is mapped and decompressed on every core.
+			// The first round isn't measured, and in every round each file is read cold and then warm
+			decompressionPool.Initialize( s_decompressionThreadCount );
+			for ( size_t round = 0; ( round <= s_loadRoundCount ) && !wereThereErrors; ++round )
+			{
+				for ( size_t layout = 0; layout < 2; ++layout )
+				{
+					const bool isCompressed = layout == 1;
+					for ( size_t cacheState = 0; cacheState < 2; ++cacheState )
+					{
+						const bool isCold = cacheState == 0;
+						if ( isCold && !( s_canEvictFiles && EvictFromFileCache( paths[layout].c_str() ) ) )
+						{
+							continue;
+						}
+						cMappedFile file;
+						std::string errorMessage;
+						const tClock::time_point startTime = tClock::now();
+						bool wasRead = file.Open( paths[layout].c_str(), false, &errorMessage );
+						if ( wasRead && isCompressed )
+						{
+							wasRead = file.Decompress( paths[layout].c_str(), &decompressionPool, &errorMessage );
+						}
+						else if ( wasRead )
+						{
+							file.Prefetch();
+						}
+						const tClock::time_point endTime = tClock::now();
+						if ( !wasRead )
+						{
+							std::cerr << errorMessage << "\n";
+							wereThereErrors = true;
+							break;
+						}
+						if ( round > 0 )
+						{
+							double* const times_milliseconds = isCold ? result.coldMilliseconds : result.warmMilliseconds;
+							times_milliseconds[layout] += std::chrono::duration<double, std::milli>( endTime - startTime ).count();
+						}
+					}
+				}
+			}
+			for ( size_t layout = 0; layout < 2; ++layout )
+			{
+				result.coldMilliseconds[layout] /= static_cast<double>( s_loadRoundCount );
+				result.warmMilliseconds[layout] /= static_cast<double>( s_loadRoundCount );
+			}
+
+			// The compressed contents are decompressed from memory so that only the decompression is measured
+			// (about 16 MB of decompressed data per round)
+			const size_t repeatCount = std::max<size_t>( ( s_loadRoundCount * 16 * 1024 * 1024 ) / contents.size(), 1 );
+			result.isIdentical = true;
+			for ( size_t threads = 0; threads < 2; ++threads )
+			{
+				decompressionPool.Initialize( ( threads == 0 ) ? 1 : s_decompressionThreadCount );
+				const tClock::time_point startTime = tClock::now();
+				for ( size_t j = 0; j < repeatCount; ++j )
+				{
+					cMappedFile file;
+					file.Borrow( compressedContents.data(), compressedContents.size() );
+					std::string errorMessage;
+					if ( !file.Decompress( paths[1].c_str(), &decompressionPool, &errorMessage ) )
+					{
+						std::cerr << errorMessage << "\n";
+						wereThereErrors = true;
+						break;
+					}
+					if ( j == 0 )
+					{
+						result.isIdentical = result.isIdentical && ( file.GetSize() == contents.size() )
+							&& ( std::memcmp( file.GetContents(), contents.data(), contents.size() ) == 0 );
+					}
+				}
+				const tClock::time_point endTime = tClock::now();
+				const double seconds = std::chrono::duration<double>( endTime - startTime ).count();
+				result.decompressionMegabytesPerSecond[threads] = static_cast<double>( repeatCount * contents.size() ) / ( seconds * 1000000.0 );
+			}
+			if ( !result.isIdentical )
+			{
+				std::cerr << "The " << result.assetName << " sphere's mesh didn't decompress to what was compressed\n";
+				wereThereErrors = true;
+			}
+			s_compressionResults.push_back( result );
+		}
+
+		RemoveRenderable( materialHolder );
+		delete materialHolder;
+		return !wereThereErrors;
+	}
+
+	bool CheckMaterialConstants()
+	{
+		bool wereThereErrors = false;
+#if defined( EAE6320_PLATFORM_NULL )
+		using namespace eae6320::Graphics;
+
+		// An opaque material that is drawn one renderable at a time and then an instanced one.
+		// Every renderable that shares a mesh and a material is drawn in the same run, which only binds the material once
+		// (through whichever renderable comes first), and so the constant is changed through each of them in turn
+		const size_t materialIndices[] = { s_transparentMaterialCount, s_transparentMaterialCount + s_uninstancedMaterialCount };
+		const size_t renderableCount = 4;
+		for ( const size_t materialIndex : materialIndices )
+		{
+			Renderable* renderables[renderableCount];
+			for ( size_t i = 0; i < renderableCount; ++i )
+			{
+				renderables[i] = new Renderable( eae6320::Math::cVector( ( 2.0f * i ) - 3.0f, 0.0f, -20.0f ) );
+				AddRenderable( s_meshPaths[0], s_materialPaths[materialIndex].c_str(), renderables[i] );
+			}
+			Render();
+			for ( size_t i = 0; i < renderableCount; ++i )
+			{
+				const float brightness[3] = { 0.25f * i, 0.25f * i, 0.25f * i };
+				SetMaterialConstant( renderables[i]->m_material, 0, brightness );
+				Render();
+				const uint32_t uploadedBytes_changed = GetFrameStatistics().uploadedBytes;
+				Render();
+				const uint32_t uploadedBytes_unchanged = GetFrameStatistics().uploadedBytes;
+				if ( uploadedBytes_changed != ( uploadedBytes_unchanged + renderables[i]->m_material.m_constantsSize ) )
+				{
+					std::cerr << "A material constant that was changed through renderable #" << i << " of "
+						<< s_materialPaths[materialIndex] << " wasn't uploaded exactly once\n";
+					wereThereErrors = true;
+				}
+			}
+			for ( size_t i = 0; i < renderableCount; ++i )
+			{
+				RemoveRenderable( renderables[i] );
+				delete renderables[i];
+			}
+		}
+#endif
+		return !wereThereErrors;
+	}
+
+	bool EvictFromFileCache( const char* const i_path )
+	{
+#if defined( _WIN32 )
+		// Windows can only drop a file from its cache when the whole standby list is flushed
+		// (with RAMMap or by restarting), which the benchmark can't do
+		( void ) i_path;
+		return false;
+#else
+		const int file = open( i_path, O_RDONLY );
+		if ( file == -1 )
+		{
+			return false;
+		}
+		// Pages that haven't been written to the disk yet can't be dropped
+		const bool wasEvicted = ( fdatasync( file ) == 0 ) && ( posix_fadvise( file, 0, 0, POSIX_FADV_DONTNEED ) == 0 );
+		close( file );
+		return wasEvicted;
+#endif
+	}
+
+	uint64_t HashFrameCommands()
+	{
+		uint64_t hash = 14695981039346656037ull;
+		const auto HashBytes = [&hash]( const void* const i_data, const size_t i_size )
+		{
+			const uint8_t* const bytes = static_cast<const uint8_t*>( i_data );
+			for ( size_t i = 0; i < i_size; ++i )
+			{
+				hash = ( hash ^ bytes[i] ) * 1099511628211ull;
+			}
+		};
+		using namespace eae6320::Graphics;
+		const cCommandBuffer& commandBuffer = GetFrameCommands();
+		for ( size_t i = 0; i < commandBuffer.GetCommandCount(); ++i )
+		{
+			const cCommandBuffer::sCommand& command = commandBuffer.GetCommand( i );
+			HashBytes( &command.type, sizeof( command.type ) );
+			HashBytes( &command.first, sizeof( command.first ) );
+			HashBytes( &command.count, sizeof( command.count ) );
+			HashBytes( &command.mesh, sizeof( command.mesh ) );
+			if ( command.type == cCommandBuffer::setViewConstants )
+			{
+				HashBytes( &commandBuffer.GetViewConstants( command.first ), sizeof( sViewConstants ) );
+			}
+			else if ( ( command.type == cCommandBuffer::setInstanceTransforms ) || ( command.type == cCommandBuffer::setDrawCallTransform ) )
+			{
+				for ( uint32_t j = 0; j < command.count; ++j )
+				{
+					HashBytes( &commandBuffer.GetTransform( command.first + j ), sizeof( eae6320::Math::cMatrix_transformation ) );
+				}
+			}
+		}
+		return hash;
+	}
+
+	bool WriteJson( const char* const i_path )
+	{
+		std::ofstream file( i_path );
+		if ( !file )
+		{
+			std::cerr << "The benchmark results couldn't be written to " << i_path << "\n";
+			return false;
+		}
+
+		file << "{\n"
+			<< "\t\"frameCount\": " << s_frameCount << ",\n"
+		<< "\t\"simulationMilliseconds\": " << s_simulationMilliseconds << ",\n";
+		file << std::setprecision( 6 );
+		file << "\t\"loading\": { \"set\": \"" << ( s_shouldLoadPlanets ? "planets" : "benchmark" ) << "\""
+			<< ", \"rounds\": " << s_loadRoundCount << ", \"methods\": [\n";
+		for ( size_t i = 0; i < 2; ++i )
+		{
+			const sLoadResult& loadResult = s_loadResults[i];
+			file << "\t\t{ \"method\": \"" << loadResult.methodName << "\""
+				<< ", \"averageMilliseconds\": " << loadResult.averageMilliseconds
+				<< ", \"files\": " << loadResult.statistics.fileCount
+				<< ", \"fileBytes\": " << loadResult.statistics.fileBytes
+				<< ", \"copiedBytes\": " << loadResult.statistics.copiedBytes << " }"
+				<< ( ( i == 0 ) ? "," : "" ) << "\n";
+		}
+		file << "\t] },\n"
+			<< "\t\"streaming\": [\n";
+		for ( size_t i = 0; i < 3; ++i )
+		{
+			const sStreamingResult& streamingResult = s_streamingResults[i];
+			file << "\t\t{ \"method\": \"" << streamingResult.methodName << "\""
+				<< ", \"frames\": " << streamingResult.frameCount
+				<< ", \"averageFrameMilliseconds\": " << streamingResult.averageFrameMilliseconds
+				<< ", \"worstFrameMilliseconds\": " << streamingResult.worstFrameMilliseconds
+				<< ", \"worstStallMilliseconds\": " << streamingResult.worstStallMilliseconds << " }"
+				<< ( ( i < 2 ) ? "," : "" ) << "\n";
+		}
+		file << "\t],\n"
+			<< "\t\"startup\": { \"assets\": " << s_packStatistics.assetCount << ", \"payloads\": " << s_packStatistics.payloadCount
+			<< ", \"layouts\": [\n";
+		for ( size_t i = 0; i < 2; ++i )
+		{
+			const sStartupResult& startupResult = s_startupResults[i];
+			file << "\t\t{ \"layout\": \"" << startupResult.layoutName << "\"";
+			if ( s_canEvictFiles )
+			{
+				file << ", \"coldMilliseconds\": " << startupResult.coldMilliseconds;
+			}
+			file << ", \"warmMilliseconds\": " << startupResult.warmMilliseconds
+				<< ", \"files\": " << startupResult.openedFileCount
+				<< ", \"diskBytes\": " << startupResult.diskBytes << " }"
+				<< ( ( i == 0 ) ? "," : "" ) << "\n";
+		}
+		file << "\t] },\n"
+			<< "\t\"compression\": { \"chunkSize\": " << eae6320::Graphics::AssetCompression::s_maxChunkSize
+			<< ", \"rounds\": " << s_loadRoundCount << ", \"decompressionThreads\": " << s_decompressionThreadCount << ", \"meshes\": [\n";
+		for ( size_t i = 0; i < s_compressionResults.size(); ++i )
+		{
+			const sCompressionResult& compressionResult = s_compressionResults[i];
+			file << "\t\t{ \"mesh\": \"" << compressionResult.assetName << "\""
+				<< ", \"chunks\": " << compressionResult.chunkCount
+				<< ", \"rawBytes\": " << compressionResult.rawBytes
+				<< ", \"diskBytes\": " << compressionResult.compressedBytes;
+			if ( s_canEvictFiles )
+			{
+				file << ", \"rawColdMilliseconds\": " << compressionResult.coldMilliseconds[0]
+					<< ", \"compressedColdMilliseconds\": " << compressionResult.coldMilliseconds[1];
+			}
+			file << ", \"rawWarmMilliseconds\": " << compressionResult.warmMilliseconds[0]
+				<< ", \"compressedWarmMilliseconds\": " << compressionResult.warmMilliseconds[1]
+				<< ", \"singleThreadMegabytesPerSecond\": " << compressionResult.decompressionMegabytesPerSecond[0]
+				<< ", \"allThreadsMegabytesPerSecond\": " << compressionResult.decompressionMegabytesPerSecond[1]
+				<< ", \"identical\": " << ( compressionResult.isIdentical ? "true" : "false" ) << " }"
+				<< ( ( ( i + 1 ) < s_compressionResults.size() ) ? "," : "" ) << "\n";
+		}
+		file << "\t] },\n"
+			<< "\t\"sharedAssets\": [\n";
+		for ( uint8_t i = 0; i < eae6320::Graphics::assetTypeCount; ++i )
+		{
+			const eae6320::Graphics::sAssetCacheStatistics& assetCacheResult = s_assetCacheResults[i];
+			file << "\t\t{ \"asset\": \"" << s_assetTypeNames[i] << "\""
+				<< ", \"loaded\": " << assetCacheResult.loadedCount
+				<< ", \"loadedBytes\": " << assetCacheResult.loadedBytes
+				<< ", \"hits\": " << assetCacheResult.hits
+				<< ", \"misses\": " << assetCacheResult.misses << " }"
+				<< ( ( ( i + 1 ) < eae6320::Graphics::assetTypeCount ) ? "," : "" ) << "\n";
+		}
+		file << "\t],\n"
+			<< "\t\"results\": [\n";
+		for ( size_t i = 0; i < s_results.size(); ++i )
+		{
+			const sResult& result = s_results[i];
+			file << "\t\t{ \"renderables\": " << result.renderableCount
+				<< ", \"loadMilliseconds\": " << result.loadMilliseconds
+				<< ", \"fastestFrameMilliseconds\": " << result.fastestFrameMilliseconds
+				<< ", \"averageFrameMilliseconds\": " << result.averageFrameMilliseconds
+				<< ", \"drawCalls\": " << result.frameStatistics.drawCalls
+				<< ", \"stateChanges\": " << result.frameStatistics.stateChanges
+				<< ", \"redundantStateChanges\": " << result.frameStatistics.redundantStateChanges
+				<< ", \"textureBinds\": " << result.frameStatistics.textureBinds
+				<< ", \"uploadedBytes\": " << result.frameStatistics.uploadedBytes
+				<< ", \"commands\": " << result.commandCount
+				<< ", \"commandBytes\": " << result.commandBytes
+				<< ", \"serialFrameMilliseconds\": " << result.gameLoops[0].averageFrameMilliseconds
+				<< ", \"threadedFrameMilliseconds\": " << result.gameLoops[1].averageFrameMilliseconds
+				<< ", \"serialLatencyMilliseconds\": " << result.gameLoops[0].averageLatencyMilliseconds
+				<< ", \"threadedLatencyMilliseconds\": " << result.gameLoops[1].averageLatencyMilliseconds << " }"
+				<< ( ( ( i + 1 ) < s_results.size() ) ? "," : "" ) << "\n";
+		}
+		file << "\t],\n"
+			<< "\t\"drawListThreads\": [\n";
+		for ( size_t i = 0; i < s_scalingResults.size(); ++i )
+		{
+			const sScalingResult& scalingResult = s_scalingResults[i];
+			file << "\t\t{ \"threads\": " << scalingResult.threadCount
+				<< ", \"averageFrameMilliseconds\": " << scalingResult.averageFrameMilliseconds
+				<< ", \"identical\": " << ( scalingResult.isIdentical ? "true" : "false" ) << " }"
+				<< ( ( ( i + 1 ) < s_scalingResults.size() ) ? "," : "" ) << "\n";
+		}
+		file << "\t],\n"
+			<< "\t\"errorChecks\": [\n";
+		for ( size_t i = 0; i < s_errorCheckResults.size(); ++i )
+		{
+			const sErrorCheckResult& errorCheckResult = s_errorCheckResults[i];
+			file << "\t\t{ \"mode\": \"" << errorCheckResult.modeName << "\""
+				<< ", \"supported\": " << ( errorCheckResult.isSupported ? "true" : "false" );
+			if ( errorCheckResult.isSupported )
+			{
+				file << ", \"averageFrameMilliseconds\": " << errorCheckResult.averageFrameMilliseconds
+					<< ", \"apiErrors\": " << errorCheckResult.apiErrors;
+			}
+			file << " }" << ( ( ( i + 1 ) < s_errorCheckResults.size() ) ? "," : "" ) << "\n";
+		}
+		file << "\t]\n}\n";
+		return true;
+	}
+}
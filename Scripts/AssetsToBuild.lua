@@ -53,6 +53,11 @@ return
 			"Pointer.lmesh",
 			"Panel.lmesh"
 		},
+		Optional =
+		{
+			"quantized",
+			"compressed",
+		},
 	},
 
 	{
@@ -179,6 +179,49 @@ local function BuildAsset( i_assetDirectory, i_relativePath, i_builderFileName,
 	end
 end
 
+local function PackAssets( i_assetsToBuild )
+	local path_pack = s_BuiltAssetDir .. "Assets.pack"
+	local path_packer = s_BinDir .. "AssetPacker.exe"
+	if not DoesFileExist( path_packer ) then
+		error( "The asset packer (\"" .. path_packer .. "\") doesn't exist" )
+	end
+
+	-- The pack only needs to be written again if one of its assets (or the packer) has changed since it was
+	local relativePaths = {}
+	local shouldPackBeWritten = not DoesFileExist( path_pack )
+	local lastWriteTime_pack = shouldPackBeWritten and 0 or GetLastWriteTime( path_pack )
+	if not shouldPackBeWritten then
+		shouldPackBeWritten = GetLastWriteTime( path_packer ) > lastWriteTime_pack
+	end
+	for i, assetInfo_singleType in ipairs( i_assetsToBuild ) do
+		for j, assetInfo in ipairs( assetInfo_singleType.Assets ) do
+			local relativePath = assetInfo_singleType.Directory .. "\\" .. assetInfo
+			table.insert( relativePaths, "\"" .. relativePath .. "\"" )
+			if not shouldPackBeWritten then
+				shouldPackBeWritten = GetLastWriteTime( s_BuiltAssetDir .. relativePath ) > lastWriteTime_pack
+			end
+		end
+	end
+	if not shouldPackBeWritten then
+		return true
+	end
+
+	-- The source is the directory that the assets were built into
+	-- (without its trailing slash, which would escape the quote after it)
+	-- and the target is the pack
+	local path_source = string.sub( s_BuiltAssetDir, 1, -2 )
+	local arguments = "\"" .. path_source .. "\" \"" .. path_pack .. "\" " .. table.concat( relativePaths, " " )
+	local commandLine = "\"\"" .. path_packer .. "\" " .. arguments .. "\""
+	local result, terminationType, exitCode = os.execute( commandLine )
+	if result then
+		print( "Packed " .. path_pack )
+		return true
+	else
+		OutputErrorMessage( "The command " .. tostring( commandLine ) .. " exited with code " .. tostring( exitCode ), path_pack )
+		return false
+	end
+end
+
 local function BuildAssets( i_assetsToBuild )
 	local wereThereErrors = false
 	for i, assetInfo_singleType in ipairs( i_assetsToBuild ) do
@@ -197,6 +240,11 @@ local function BuildAssets( i_assetsToBuild )
 		end
 	end
 
+	-- Every asset is then packed into a single file for the game to load
+	if not wereThereErrors and not PackAssets( i_assetsToBuild ) then
+		wereThereErrors = true
+	end
+
 	-- End of TODO. The following should be the final line of the function:
 	return not wereThereErrors
 end